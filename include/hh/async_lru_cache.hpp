@@ -0,0 +1,206 @@
+#ifndef INCLUDED_HH_ASYNC_LRU_CACHE_HPP
+#define INCLUDED_HH_ASYNC_LRU_CACHE_HPP
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <hh/executor.hpp>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/typetraits.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace hh {
+  namespace functools {
+
+    template <typename SIGNATURE, typename EXECUTOR = thread_pool_executor,
+              typename FUNCTION = std::function<SIGNATURE>>
+    class async_lru_cache;
+
+    /**
+     * Thread-safe lru-cache of results which are still being computed, for slow functions such as
+     * I/O-bound loaders.
+     *
+     * A call never waits for the underlying function. It returns a std::shared_future for the
+     * result at once: a hit returns the future stored for the arguments, whether or not its value
+     * is ready yet, and a miss stores a new future and hands the computation to the executor. So
+     * every caller for a key awaits the same in-flight computation, and the function is called
+     * once per key however many callers ask for it while it runs.
+     *
+     * A call which throws fails its future with the exception, which every caller waiting on it
+     * sees, and the failed entry is then dropped so that the next call for the key tries again.
+     * Entries are otherwise evicted least recently used first, pending ones included; callers
+     * already holding an evicted entry's future still receive its result. As with lru_cache a
+     * maximum size of zero makes the cache unbounded.
+     *
+     * The function is called from the executor's threads, concurrently for different keys, so it
+     * must be safe to call concurrently. Computations hold shared ownership of the function and
+     * entries, so the cache can be destroyed while they are still running.
+     *
+     * @see lru_cache
+     * @see executor.hpp
+     * @see make_async_lrucache
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam EXECUTOR The executor the underlying function is called on.
+     * @tparam FUNCTION The type of the stored underlying function.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename EXECUTOR, typename FUNCTION>
+    class async_lru_cache<RETURN_TYPE(ARGUMENTS...), EXECUTOR, FUNCTION> {
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using future_type = std::shared_future<decayed_return_type>;
+      using executor_type = EXECUTOR;
+      using function_type = FUNCTION;
+
+    private:
+      struct cache_entry {
+        cache_key d_key;
+        future_type d_value;
+        std::uint64_t d_ticket; /** Tells a failed computation whether its entry is still cached. */
+      };
+
+      using entry_list = std::list<cache_entry>;
+
+      /** The state computations share with the cache, kept alive by whichever finishes last. */
+      struct shared_state {
+        shared_state(FUNCTION func, unsigned int cache_size)
+            : d_func{std::move(func)}, d_max_size{cache_size} {}
+
+        FUNCTION d_func;
+        unsigned int d_max_size;
+        std::mutex d_mutex;
+        entry_list d_entries;
+        std::unordered_map<cache_key, typename entry_list::iterator, wy_key_hash<cache_key>>
+            d_entry_map;
+        std::uint64_t d_next_ticket = 0;
+      };
+
+      std::shared_ptr<shared_state> d_state;
+      EXECUTOR d_executor;
+
+    public:
+      async_lru_cache() = delete;
+      /**
+       * Constructs a cache with a given function, size and executor.
+       *
+       * @see make_async_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       * @param executor The executor misses call the underlying function on.
+       */
+      async_lru_cache(FUNCTION func, unsigned int cache_size, EXECUTOR executor = EXECUTOR{})
+          : d_state{std::make_shared<shared_state>(std::move(func), cache_size)},
+            d_executor{std::move(executor)} {}
+
+      /**
+       * Returns the future result of calling the underlying function with the arguments.
+       *
+       * On a miss the computation is handed to the executor after the cache's lock is released,
+       * so an inline_executor computes the value before this returns.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS> future_type operator()(INPUT_ARGUMENTS&&... args) {
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        shared_state& state = *d_state;
+        std::shared_ptr<std::promise<decayed_return_type>> promise;
+        std::uint64_t ticket;
+        future_type result;
+        {
+          std::lock_guard<std::mutex> lock{state.d_mutex};
+          const auto found = state.d_entry_map.find(key);
+          if (found != state.d_entry_map.end()) {
+            state.d_entries.splice(state.d_entries.end(), state.d_entries, found->second);
+            return found->second->d_value;
+          }
+          promise = std::make_shared<std::promise<decayed_return_type>>();
+          ticket = state.d_next_ticket++;
+          result = promise->get_future().share();
+          state.d_entries.push_back(cache_entry{key, result, ticket});
+          state.d_entry_map.emplace(key, std::prev(state.d_entries.end()));
+          if (state.d_max_size != 0 && state.d_entry_map.size() > state.d_max_size) {
+            state.d_entry_map.erase(state.d_entries.front().d_key);
+            state.d_entries.pop_front();
+          }
+        }
+        try {
+          d_executor.execute([state = d_state, promise, key, ticket]() noexcept {
+            try {
+              promise->set_value(std::apply(state->d_func, key));
+            } catch (...) {
+              forget(*state, key, ticket);
+              promise->set_exception(std::current_exception());
+            }
+          });
+        } catch (...) {
+          // A refused computation never runs, so drop its entry and fail anyone already waiting.
+          forget(state, key, ticket);
+          try {
+            promise->set_exception(std::current_exception());
+          } catch (const std::future_error&) {
+            // The executor ran the computation before failing, so its waiters have a result.
+          }
+          throw;
+        }
+        return result;
+      }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      auto max_size() const { return d_state->d_max_size; }
+
+      /** The current number of retained results, pending ones included. */
+      std::size_t size() const {
+        std::lock_guard<std::mutex> lock{d_state->d_mutex};
+        return d_state->d_entry_map.size();
+      }
+
+      /** The executor misses call the underlying function on. */
+      const EXECUTOR& executor() const { return d_executor; }
+
+    private:
+      /** Drops a failed entry before its waiters are woken, unless it was already replaced. */
+      static void forget(shared_state& state, const cache_key& key, std::uint64_t ticket) {
+        std::lock_guard<std::mutex> lock{state.d_mutex};
+        const auto found = state.d_entry_map.find(key);
+        if (found != state.d_entry_map.end() && found->second->d_ticket == ticket) {
+          state.d_entries.erase(found->second);
+          state.d_entry_map.erase(found);
+        }
+      }
+    };
+
+    template <typename FUNCTION> async_lru_cache(FUNCTION, unsigned int)
+        -> async_lru_cache<callable_signature_t<FUNCTION>, thread_pool_executor, FUNCTION>;
+    template <typename FUNCTION, typename EXECUTOR>
+    async_lru_cache(FUNCTION, unsigned int, EXECUTOR)
+        -> async_lru_cache<callable_signature_t<FUNCTION>, EXECUTOR, FUNCTION>;
+
+    /**
+     * Makes an asynchronous cache of the function, stored as its own type.
+     *
+     * @param func A function pointer, lambda, functor or member function pointer, or a
+     * std::function to opt in to type erasure.
+     * @param size The maximum size of the cache.
+     * @param executor The executor misses call the function on.
+     */
+    template <typename FUNCTION, typename EXECUTOR = thread_pool_executor>
+    auto make_async_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE,
+                             EXECUTOR executor = EXECUTOR{}) {
+      return async_lru_cache<callable_signature_t<FUNCTION>, EXECUTOR, FUNCTION>(
+          std::move(func), size, std::move(executor));
+    }
+  }  // namespace functools
+}  // namespace hh
+#endif
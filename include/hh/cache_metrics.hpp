@@ -0,0 +1,114 @@
+#ifndef INCLUDED_HH_CACHE_METRICS_HPP
+#define INCLUDED_HH_CACHE_METRICS_HPP
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <hh/histogram.hpp>
+#include <utility>
+
+/**
+ * Metrics policies for basic_lru_cache.
+ *
+ * A metrics policy is notified of every hit, miss, insertion and eviction, and times every call of
+ * the underlying function through `load(F&&)`. `stats()` returns a cache_stats snapshot. The
+ * default no_metrics policy does nothing, so the calls compile away and uninstrumented caches pay
+ * nothing for the hooks.
+ */
+namespace hh {
+  namespace functools {
+
+    /** Histogram of the latency of calls to the underlying function, in nanoseconds. */
+    using load_latency_histogram = hh::collection::log_linear_histogram<>;
+
+    /** A point-in-time snapshot of a cache's metrics. */
+    struct cache_stats {
+      std::uint64_t d_hits = 0;
+      std::uint64_t d_misses = 0;
+      std::uint64_t d_insertions = 0;
+      std::uint64_t d_evictions = 0;
+      std::chrono::nanoseconds d_load_time{0};
+      load_latency_histogram::snapshot d_load_latency{{}};
+
+      /** The share of lookups served from the cache, zero before any lookup. */
+      double hit_ratio() const {
+        const auto lookups = d_hits + d_misses;
+        return lookups == 0 ? 0.0 : static_cast<double>(d_hits) / static_cast<double>(lookups);
+      }
+    };
+
+    /** Metrics policy recording nothing; its stats() are always empty. */
+    struct no_metrics {
+      void hit() {}
+      void miss() {}
+      void inserted() {}
+      void evicted() {}
+      template <typename LOAD> decltype(auto) load(LOAD&& load) {
+        return std::forward<LOAD>(load)();
+      }
+      cache_stats stats() const { return cache_stats{}; }
+    };
+
+    /**
+     * Metrics policy counting events in relaxed atomics and timing every call of the underlying
+     * function into a latency histogram.
+     *
+     * basic_lru_cache is not thread-safe, so each counter only ever has one writer and is bumped
+     * with a relaxed load and store rather than a locked read-modify-write; stats() can still be
+     * called from any thread. Only the histogram, which is touched on misses alone, uses atomic
+     * increments.
+     */
+    class atomic_metrics {
+      std::atomic<std::uint64_t> d_hits{0};
+      std::atomic<std::uint64_t> d_misses{0};
+      std::atomic<std::uint64_t> d_insertions{0};
+      std::atomic<std::uint64_t> d_evictions{0};
+      std::atomic<std::uint64_t> d_load_nanoseconds{0};
+      load_latency_histogram d_load_latency;
+
+      static void bump(std::atomic<std::uint64_t>& counter, std::uint64_t amount = 1) {
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+      }
+
+    public:
+      atomic_metrics() = default;
+      atomic_metrics(const atomic_metrics&) = delete;
+      atomic_metrics& operator=(const atomic_metrics&) = delete;
+
+      void hit() { bump(d_hits); }
+      void miss() { bump(d_misses); }
+      void inserted() { bump(d_insertions); }
+      void evicted() { bump(d_evictions); }
+
+      /** Calls load(), recording how long it took whether or not it throws. */
+      template <typename LOAD> decltype(auto) load(LOAD&& load) {
+        struct timer {
+          atomic_metrics& d_metrics;
+          std::chrono::steady_clock::time_point d_start = std::chrono::steady_clock::now();
+          ~timer() {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - d_start)
+                                     .count();
+            const auto nanoseconds = static_cast<std::uint64_t>(elapsed < 0 ? 0 : elapsed);
+            bump(d_metrics.d_load_nanoseconds, nanoseconds);
+            d_metrics.d_load_latency.record(nanoseconds);
+          }
+        } timer{*this};
+        return std::forward<LOAD>(load)();
+      }
+
+      cache_stats stats() const {
+        cache_stats stats;
+        stats.d_hits = d_hits.load(std::memory_order_relaxed);
+        stats.d_misses = d_misses.load(std::memory_order_relaxed);
+        stats.d_insertions = d_insertions.load(std::memory_order_relaxed);
+        stats.d_evictions = d_evictions.load(std::memory_order_relaxed);
+        stats.d_load_time
+            = std::chrono::nanoseconds{d_load_nanoseconds.load(std::memory_order_relaxed)};
+        stats.d_load_latency = d_load_latency.take_snapshot();
+        return stats;
+      }
+    };
+  }  // namespace functools
+}  // namespace hh
+
+#endif
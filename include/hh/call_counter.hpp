@@ -1,43 +1,401 @@
 #ifndef INCLUDED_HH_CALL_COUNTER_H
 #define INCLUDED_HH_CALL_COUNTER_H
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <hh/count_min_sketch.hpp>
+#include <hh/eviction_policy.hpp>
 #include <hh/hash.hpp>
+#include <hh/space_saving.hpp>
+#include <hh/typetraits.hpp>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 namespace hh {
   namespace functools {
-    template <typename RETURN_TYPE, typename... ARGUMENTS> class call_counter {
+    namespace detail {
+      /** A small number unique to the calling thread, handed out in the order threads first ask. */
+      inline std::size_t thread_ordinal() {
+        static std::atomic<std::size_t> next{0};
+        thread_local const std::size_t ordinal = next.fetch_add(1, std::memory_order_relaxed);
+        return ordinal;
+      }
+
+      inline std::size_t round_up_to_power_of_two(std::size_t value) {
+        std::size_t rounded = 1;
+        while (rounded < value) {
+          rounded <<= 1;
+        }
+        return rounded;
+      }
+
+      /** One stripe per hardware thread, rounded up to a power of two. */
+      inline std::size_t default_stripe_count() {
+        return round_up_to_power_of_two(std::max(1u, std::thread::hardware_concurrency()));
+      }
+    }  // namespace detail
+
+    template <typename SIGNATURE, typename HASHER = wy_hasher,
+              typename FUNCTION = std::function<SIGNATURE>,
+              typename ALLOCATOR = std::allocator<std::byte>>
+    class basic_call_counter;
+    template <typename SIGNATURE, typename HASHER = wy_hasher,
+              typename FUNCTION = std::function<SIGNATURE>>
+    class basic_approximate_call_counter;
+
+    /**
+     * Wraps a function and counts how often it is called with each set of arguments.
+     *
+     * The counter can be shared between threads. Counts are kept in a number of stripes, each
+     * padded to its own cache line and guarded by its own mutex, and every thread increments the
+     * stripe its ordinal selects. Threads therefore rarely touch the same lock or counts, and the
+     * hot path never bounces a shared cache line between cores. call_count(), total_calls() and
+     * unique_entries() aggregate over the stripes when they are asked, so they cost more than a
+     * call and see calls made concurrently with them only in part.
+     *
+     * Argument tuples are hashed by the hasher, wyhash by default. The function is stored as the
+     * callable type given, std::function unless another is named. Class template argument
+     * deduction picks that type from the function pointer, lambda, functor or member function
+     * pointer the counter is constructed with; call_counter names the signature alone and erases
+     * the type instead.
+     * The counts are allocated with the allocator, rebound to the nodes of each stripe's table.
+     *
+     * @see call_counter
+     * @see hash.hpp
+     * @see pool_allocator.hpp
+     * @tparam RETURN_TYPE The return type of the counted function.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam HASHER The hasher of argument tuples.
+     * @tparam FUNCTION The type of the stored counted function.
+     * @tparam ALLOCATOR The allocator of the counts.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename HASHER, typename FUNCTION,
+              typename ALLOCATOR>
+    class basic_call_counter<RETURN_TYPE(ARGUMENTS...), HASHER, FUNCTION, ALLOCATOR> {
+    public:
+      using key_type = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using key_hash_type = typename HASHER::template hash<key_type>;
+      using function_signture = std::function<RETURN_TYPE(ARGUMENTS...)>;
+      using function_type = FUNCTION;
+      using allocator_type = ALLOCATOR;
+
+    private:
+      /** Stripes are padded to a cache line so neighbouring threads do not share one. */
+      static constexpr std::size_t cache_line_size = 64;
+
+      using count_map = std::unordered_map<
+          key_type, unsigned long long, key_hash_type, std::equal_to<key_type>,
+          detail::rebind_alloc<ALLOCATOR, std::pair<const key_type, unsigned long long>>>;
+
+      struct alignas(cache_line_size) stripe {
+        std::mutex d_mutex;
+        count_map d_counts;
+        std::atomic<unsigned long long> d_total_calls{0};
+
+        explicit stripe(const ALLOCATOR& allocator)
+            : d_counts{typename count_map::allocator_type{allocator}} {}
+      };
+
+      mutable FUNCTION d_func;
+      std::size_t d_stripe_mask;
+      std::vector<std::unique_ptr<stripe>> d_stripes;
+
+      std::size_t stripe_count() const { return d_stripe_mask + 1; }
+
+    public:
+      basic_call_counter() = delete;
+
+      /**
+       * @param func The function to count calls of.
+       * @param stripes The number of stripes to count in, rounded up to a power of two. Defaults
+       * to one per hardware thread.
+       * @param allocator The allocator of the counts.
+       */
+      basic_call_counter(FUNCTION func, std::size_t stripes = detail::default_stripe_count(),
+                         const ALLOCATOR& allocator = ALLOCATOR{})
+          : d_func{std::move(func)},
+            d_stripe_mask{detail::round_up_to_power_of_two(stripes) - 1},
+            d_stripes{} {
+        d_stripes.reserve(stripe_count());
+        for (std::size_t index = 0; index < stripe_count(); ++index) {
+          d_stripes.push_back(std::make_unique<stripe>(allocator));
+        }
+      };
+
+      /** The number of calls made with arguments equal to the given ones. */
+      template <typename... INPUT_ARGUMENTS>
+      unsigned long long call_count(INPUT_ARGUMENTS&&... args) const {
+        const key_type key{std::forward<INPUT_ARGUMENTS>(args)...};
+        unsigned long long count = 0;
+        for (std::size_t index = 0; index < stripe_count(); ++index) {
+          auto& counts = *d_stripes[index];
+          std::lock_guard<std::mutex> lock{counts.d_mutex};
+          const auto found = counts.d_counts.find(key);
+          if (found != counts.d_counts.end()) {
+            count += found->second;
+          }
+        }
+        return count;
+      }
+
+      template <typename... INPUT_ARGUMENTS>
+      RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) const {
+        key_type key{args...};
+        auto& counts = *d_stripes[detail::thread_ordinal() & d_stripe_mask];
+        {
+          std::lock_guard<std::mutex> lock{counts.d_mutex};
+          ++counts.d_counts[std::move(key)];
+          // Only written under the stripe's lock, so a plain load and store suffices.
+          counts.d_total_calls.store(counts.d_total_calls.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+        }
+        return std::invoke(d_func, std::forward<INPUT_ARGUMENTS>(args)...);
+      }
+
+      /** The number of distinct sets of arguments the function has been called with. */
+      unsigned int unique_entries() const {
+        if (stripe_count() == 1) {
+          std::lock_guard<std::mutex> lock{d_stripes[0]->d_mutex};
+          return d_stripes[0]->d_counts.size();
+        }
+        std::unordered_set<key_type, key_hash_type> keys;
+        for (std::size_t index = 0; index < stripe_count(); ++index) {
+          auto& counts = *d_stripes[index];
+          std::lock_guard<std::mutex> lock{counts.d_mutex};
+          for (const auto& entry : counts.d_counts) {
+            keys.insert(entry.first);
+          }
+        }
+        return keys.size();
+      }
+
+      /** The number of calls made with any arguments. */
+      unsigned long long total_calls() const {
+        unsigned long long total = 0;
+        for (std::size_t index = 0; index < stripe_count(); ++index) {
+          total += d_stripes[index]->d_total_calls.load(std::memory_order_relaxed);
+        }
+        return total;
+      }
+    };
+
+    /**
+     * Wraps a function and estimates how often it is called with each set of arguments, in memory
+     * fixed however many distinct arguments it sees.
+     *
+     * Calls are counted in a count-min sketch of depth rows of width counters, and the hottest
+     * argument tuples are tracked by a Space-Saving summary of a fixed number of keys. After N
+     * calls call_count() never undercounts, and overcounts by more than error_bound(), that is
+     * e * N / width, with a probability of at most stripes * exp(-depth). Every argument tuple
+     * called more than N / heavy_hitters times is reported by top_k().
+     *
+     * As with call_counter the counter can be shared between threads, each thread counting into
+     * the stripe its ordinal selects; every stripe holds its own sketch and summary, and queries
+     * sum over them.
+     *
+     * @see basic_call_counter
+     * @see approximate_call_counter
+     * @tparam RETURN_TYPE The return type of the counted function.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam HASHER The hasher of argument tuples.
+     * @tparam FUNCTION The type of the stored counted function.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename HASHER, typename FUNCTION>
+    class basic_approximate_call_counter<RETURN_TYPE(ARGUMENTS...), HASHER, FUNCTION> {
     public:
-      using key_type = std::tuple<ARGUMENTS...>;
+      using key_type = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using key_hash_type = typename HASHER::template hash<key_type>;
       using function_signture = std::function<RETURN_TYPE(ARGUMENTS...)>;
+      using function_type = FUNCTION;
 
     private:
-      mutable std::unordered_map<key_type, unsigned long long> d_counts;
-      mutable unsigned long long d_total_calls = 0ul;
-      function_signture d_func;
+      static constexpr std::size_t cache_line_size = 64;
+
+      struct alignas(cache_line_size) stripe {
+        std::mutex d_mutex;
+        hh::collection::count_min_sketch<std::uint64_t> d_sketch;
+        hh::collection::space_saving<key_type, key_hash_type> d_heavy_hitters;
+        std::atomic<unsigned long long> d_total_calls{0};
+
+        stripe(std::size_t width, std::size_t depth, std::size_t heavy_hitters)
+            : d_sketch{width, depth}, d_heavy_hitters{heavy_hitters} {}
+
+        /** Both structures overcount, so the smaller of their counts is the tighter estimate. */
+        unsigned long long estimate(const key_type& key, std::size_t hash) const {
+          const auto* tracked = d_heavy_hitters.find(key);
+          const auto estimate = d_sketch.estimate(hash);
+          return tracked == nullptr ? estimate : std::min(estimate, tracked->d_count);
+        }
+      };
+
+      mutable FUNCTION d_func;
+      std::size_t d_stripe_mask;
+      std::vector<std::unique_ptr<stripe>> d_stripes;
+
+      std::size_t stripe_count() const { return d_stripe_mask + 1; }
 
     public:
-      call_counter() = delete;
-      constexpr call_counter(RETURN_TYPE (*func)(ARGUMENTS...)) : d_func{func} {};
-      constexpr call_counter(function_signture func) : d_func{func} {};
+      basic_approximate_call_counter() = delete;
 
+      /**
+       * @param func The function to count calls of.
+       * @param width The number of counters per sketch row, rounded up to a power of two.
+       * @param depth The number of sketch rows.
+       * @param heavy_hitters The number of argument tuples tracked for top_k().
+       * @param stripes The number of stripes to count in, rounded up to a power of two. Defaults
+       * to one per hardware thread.
+       */
+      basic_approximate_call_counter(FUNCTION func, std::size_t width, std::size_t depth,
+                                     std::size_t heavy_hitters,
+                                     std::size_t stripes = detail::default_stripe_count())
+          : d_func{std::move(func)},
+            d_stripe_mask{detail::round_up_to_power_of_two(stripes) - 1},
+            d_stripes{} {
+        d_stripes.reserve(stripe_count());
+        for (std::size_t index = 0; index < stripe_count(); ++index) {
+          d_stripes.push_back(std::make_unique<stripe>(width, depth, heavy_hitters));
+        }
+      };
+
+      /** The estimated number of calls made with arguments equal to the given ones. */
       template <typename... INPUT_ARGUMENTS>
-      unsigned long long call_count(INPUT_ARGUMENTS&&... args) {
-        key_type key{std::forward<INPUT_ARGUMENTS>(args)...};
-        return d_counts[std::move(key)];
+      unsigned long long call_count(INPUT_ARGUMENTS&&... args) const {
+        const key_type key{std::forward<INPUT_ARGUMENTS>(args)...};
+        return estimate(key, key_hash_type{}(key));
       }
 
       template <typename... INPUT_ARGUMENTS>
       RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) const {
-        key_type key = std::make_tuple(std::forward<INPUT_ARGUMENTS>(args)...);
-        ++d_counts[std::move(key)];
-        ++d_total_calls;
-        return d_func(std::forward<INPUT_ARGUMENTS>(args)...);
+        const key_type key{args...};
+        const auto hash = key_hash_type{}(key);
+        auto& counts = *d_stripes[detail::thread_ordinal() & d_stripe_mask];
+        {
+          std::lock_guard<std::mutex> lock{counts.d_mutex};
+          counts.d_sketch.increment(hash);
+          counts.d_heavy_hitters.increment(key);
+          counts.d_total_calls.store(counts.d_total_calls.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+        }
+        return std::invoke(d_func, std::forward<INPUT_ARGUMENTS>(args)...);
+      }
+
+      /**
+       * Up to n of the most frequently called argument tuples with their estimated call counts,
+       * the highest first.
+       */
+      std::vector<std::pair<key_type, unsigned long long>> top_k(std::size_t n) const {
+        std::unordered_set<key_type, key_hash_type> candidates;
+        for (const auto& counts : d_stripes) {
+          std::lock_guard<std::mutex> lock{counts->d_mutex};
+          for (const auto& entry : counts->d_heavy_hitters.top(counts->d_heavy_hitters.size())) {
+            candidates.insert(entry.d_key);
+          }
+        }
+        std::vector<std::pair<key_type, unsigned long long>> hottest;
+        hottest.reserve(candidates.size());
+        for (const auto& key : candidates) {
+          hottest.emplace_back(key, estimate(key, key_hash_type{}(key)));
+        }
+        n = std::min(n, hottest.size());
+        std::partial_sort(hottest.begin(), hottest.begin() + n, hottest.end(),
+                          [](const auto& left, const auto& right) {
+                            return left.second > right.second;
+                          });
+        hottest.resize(n);
+        return hottest;
+      }
+
+      /** The number of calls made with any arguments. */
+      unsigned long long total_calls() const {
+        unsigned long long total = 0;
+        for (const auto& counts : d_stripes) {
+          total += counts->d_total_calls.load(std::memory_order_relaxed);
+        }
+        return total;
+      }
+
+      /** The amount call_count() overcounts by at most, with high probability. */
+      unsigned long long error_bound() const {
+        const double width = static_cast<double>(d_stripes.front()->d_sketch.width());
+        return static_cast<unsigned long long>(
+            std::ceil(std::exp(1.0) * static_cast<double>(total_calls()) / width));
       }
 
-      unsigned int unique_entries() const { return d_counts.size(); }
-      unsigned long long total_calls() const { return d_total_calls; }
+    private:
+      unsigned long long estimate(const key_type& key, std::size_t hash) const {
+        unsigned long long count = 0;
+        for (const auto& counts : d_stripes) {
+          std::lock_guard<std::mutex> lock{counts->d_mutex};
+          count += counts->estimate(key, hash);
+        }
+        return count;
+      }
+    };
+
+    template <typename FUNCTION> basic_call_counter(FUNCTION)
+        -> basic_call_counter<callable_signature_t<FUNCTION>, wy_hasher, FUNCTION>;
+    template <typename FUNCTION> basic_call_counter(FUNCTION, std::size_t)
+        -> basic_call_counter<callable_signature_t<FUNCTION>, wy_hasher, FUNCTION>;
+    template <typename FUNCTION, typename ALLOCATOR>
+    basic_call_counter(FUNCTION, std::size_t, ALLOCATOR)
+        -> basic_call_counter<callable_signature_t<FUNCTION>, wy_hasher, FUNCTION, ALLOCATOR>;
+
+    template <typename FUNCTION>
+    basic_approximate_call_counter(FUNCTION, std::size_t, std::size_t, std::size_t)
+        -> basic_approximate_call_counter<callable_signature_t<FUNCTION>, wy_hasher, FUNCTION>;
+    template <typename FUNCTION>
+    basic_approximate_call_counter(FUNCTION, std::size_t, std::size_t, std::size_t, std::size_t)
+        -> basic_approximate_call_counter<callable_signature_t<FUNCTION>, wy_hasher, FUNCTION>;
+
+    /**
+     * The call counter hashing with the default hasher, keyed on a parameter pack.
+     *
+     * @see basic_call_counter
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> class call_counter
+        : public basic_call_counter<RETURN_TYPE(ARGUMENTS...)> {
+      using base = basic_call_counter<RETURN_TYPE(ARGUMENTS...)>;
+
+    public:
+      call_counter(RETURN_TYPE (*func)(ARGUMENTS...),
+                   std::size_t stripes = detail::default_stripe_count())
+          : base{func, stripes} {}
+
+      call_counter(typename base::function_signture func,
+                   std::size_t stripes = detail::default_stripe_count())
+          : base{std::move(func), stripes} {}
+    };
+
+    /**
+     * The approximate call counter hashing with the default hasher, keyed on a parameter pack.
+     *
+     * @see basic_approximate_call_counter
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> class approximate_call_counter
+        : public basic_approximate_call_counter<RETURN_TYPE(ARGUMENTS...)> {
+      using base = basic_approximate_call_counter<RETURN_TYPE(ARGUMENTS...)>;
+
+    public:
+      approximate_call_counter(RETURN_TYPE (*func)(ARGUMENTS...), std::size_t width,
+                               std::size_t depth, std::size_t heavy_hitters,
+                               std::size_t stripes = detail::default_stripe_count())
+          : base{func, width, depth, heavy_hitters, stripes} {}
+
+      approximate_call_counter(typename base::function_signture func, std::size_t width,
+                               std::size_t depth, std::size_t heavy_hitters,
+                               std::size_t stripes = detail::default_stripe_count())
+          : base{std::move(func), width, depth, heavy_hitters, stripes} {}
     };
   }  // namespace functools
 }  // namespace hh
@@ -0,0 +1,104 @@
+#ifndef INCLUDED_HH_COUNT_MIN_SKETCH_HPP
+#define INCLUDED_HH_COUNT_MIN_SKETCH_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace hh {
+  namespace collection {
+
+    /**
+     * Fixed-size approximate frequency table over hashed keys.
+     *
+     * The sketch keeps depth rows of width counters. Each increment bumps one counter per row, the
+     * column being derived from the key's hash, and an estimate is the smallest counter seen for
+     * that key across the rows. Estimates never undercount, and after N increments an estimate
+     * overcounts by more than e * N / width with a probability of at most exp(-depth).
+     *
+     * Counters saturate at the maximum value of COUNTER rather than wrapping, so narrow counters
+     * can be used when only relative frequencies matter, together with halve() to age the table.
+     *
+     * @tparam COUNTER The unsigned integral type used for each counter.
+     */
+    template <typename COUNTER = std::uint32_t> class count_min_sketch {
+      static_assert(std::numeric_limits<COUNTER>::is_integer
+                        && !std::numeric_limits<COUNTER>::is_signed,
+                    "count_min_sketch counters must be unsigned integers.");
+
+    public:
+      using counter_type = COUNTER;
+
+    private:
+      std::size_t d_width_mask;
+      std::size_t d_depth;
+      std::vector<COUNTER> d_counters;
+
+    public:
+      count_min_sketch() = delete;
+      /**
+       * Constructs an empty sketch.
+       *
+       * @param width The number of counters per row, rounded up to a power of two.
+       * @param depth The number of rows, each using an independent hash of the key.
+       */
+      count_min_sketch(std::size_t width, std::size_t depth)
+          : d_width_mask{0}, d_depth{std::max<std::size_t>(depth, 1)}, d_counters{} {
+        std::size_t rounded = 1;
+        while (rounded < width) {
+          rounded <<= 1;
+        }
+        d_width_mask = rounded - 1;
+        d_counters.assign(rounded * d_depth, 0);
+      }
+
+      /** Adds count occurrences of the key with the given hash, saturating each counter. */
+      void increment(std::size_t hash, COUNTER count = 1) {
+        constexpr COUNTER saturated = std::numeric_limits<COUNTER>::max();
+        for (std::size_t row = 0; row < d_depth; ++row) {
+          COUNTER& counter = d_counters[index(hash, row)];
+          counter = saturated - counter < count ? saturated : static_cast<COUNTER>(counter + count);
+        }
+      }
+
+      /** The estimated number of occurrences of the key with the given hash. */
+      COUNTER estimate(std::size_t hash) const {
+        COUNTER smallest = std::numeric_limits<COUNTER>::max();
+        for (std::size_t row = 0; row < d_depth; ++row) {
+          smallest = std::min(smallest, d_counters[index(hash, row)]);
+        }
+        return smallest;
+      }
+
+      /** Halves every counter, used to age old occurrences out of the sketch. */
+      void halve() {
+        for (auto& counter : d_counters) {
+          counter = static_cast<COUNTER>(counter >> 1);
+        }
+      }
+
+      /** Resets every counter to zero. */
+      void clear() { std::fill(d_counters.begin(), d_counters.end(), COUNTER{0}); }
+
+      /** The number of counters in each row. */
+      std::size_t width() const { return d_width_mask + 1; }
+
+      /** The number of rows. */
+      std::size_t depth() const { return d_depth; }
+
+    private:
+      std::size_t index(std::size_t hash, std::size_t row) const {
+        // A splitmix64 finalizer over the hash and row number gives each row its own hash function.
+        std::uint64_t mixed = static_cast<std::uint64_t>(hash)
+                              + (static_cast<std::uint64_t>(row) + 1) * 0x9E3779B97F4A7C15ull;
+        mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ull;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBull;
+        mixed ^= mixed >> 31;
+        return row * width() + (static_cast<std::size_t>(mixed) & d_width_mask);
+      }
+    };
+  }  // namespace collection
+}  // namespace hh
+
+#endif
@@ -18,14 +18,451 @@
 
 #ifndef INCLUDED_HH_COUNTER_HPP
 #define INCLUDED_HH_COUNTER_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace hh {
   namespace collection {
-    template <typename T> class counter {
-      counter(T&& begin, T&& end) {
-        std::copy(begin, end, )
+
+    /**
+     * The number of distinct values of a key type small enough to count in a dense array, or zero
+     * to count the type in a hash table.
+     *
+     * One and two byte integral types, and enumerations one byte wide, are dense. Specialize this
+     * for other enumerations whose values run from zero to size - 1 to count them densely too.
+     *
+     * @tparam KEY The type of key counted.
+     */
+    template <typename KEY, typename = void> struct counter_domain {
+      static constexpr std::size_t size = 0;
+    };
+
+    template <typename KEY>
+    struct counter_domain<KEY, std::enable_if_t<std::is_integral_v<KEY> && sizeof(KEY) <= 2>> {
+      static constexpr std::size_t size = std::size_t{1} << (8 * sizeof(KEY));
+    };
+
+    template <typename KEY>
+    struct counter_domain<KEY, std::enable_if_t<std::is_enum_v<KEY> && sizeof(KEY) == 1>> {
+      static constexpr std::size_t size = 256;
+    };
+
+    /** Requests a counter to be built from a range by several threads. */
+    struct parallel_count {
+      /** The number of threads to count with, including the calling thread. */
+      unsigned int d_threads = std::max(1u, std::thread::hardware_concurrency());
+    };
+
+    namespace detail {
+      using count_type = std::int64_t;
+
+      /** Counts keys in an array indexed by the key's value. */
+      template <typename KEY> class dense_table {
+        static constexpr std::size_t domain = counter_domain<KEY>::size;
+
+        std::vector<count_type> d_counts = std::vector<count_type>(domain);
+        std::size_t d_size = 0;
+
+        static std::size_t index(KEY key) {
+          std::size_t index;
+          if constexpr (std::is_same_v<KEY, bool>) {
+            index = key ? 1 : 0;
+          } else if constexpr (std::is_enum_v<KEY>) {
+            index = static_cast<std::size_t>(
+                static_cast<std::make_unsigned_t<std::underlying_type_t<KEY>>>(key));
+          } else {
+            index = static_cast<std::size_t>(static_cast<std::make_unsigned_t<KEY>>(key));
+          }
+          if constexpr (sizeof(KEY) >= sizeof(std::size_t)
+                        || domain < (std::size_t{1} << (8 * sizeof(KEY) % 64))) {
+            if (index >= domain) {
+              throw std::out_of_range("Key lies outside the counter's dense domain.");
+            }
+          }
+          return index;
+        }
+
+      public:
+        void add(KEY key, count_type count) {
+          count_type& slot = d_counts[index(key)];
+          d_size -= slot != 0 ? 1 : 0;
+          slot += count;
+          d_size += slot != 0 ? 1 : 0;
+        }
+
+        template <typename ITERATOR> void count(ITERATOR first, ITERATOR last) {
+          using category = typename std::iterator_traits<ITERATOR>::iterator_category;
+          if constexpr (domain == 256
+                        && std::is_base_of_v<std::random_access_iterator_tag, category>) {
+            count_bytes(first, last);
+          } else {
+            for (; first != last; ++first) {
+              add(*first, 1);
+            }
+          }
+        }
+
+        count_type get(KEY key) const { return d_counts[index(key)]; }
+
+        template <typename PREDICATE> void erase_if(PREDICATE&& predicate) {
+          for (std::size_t slot = 0; slot < domain; ++slot) {
+            if (d_counts[slot] != 0 && predicate(d_counts[slot])) {
+              d_counts[slot] = 0;
+              --d_size;
+            }
+          }
+        }
+
+        template <typename VISIT> void for_each(VISIT&& visit) const {
+          for (std::size_t slot = 0; slot < domain; ++slot) {
+            if (d_counts[slot] != 0) {
+              visit(static_cast<KEY>(slot), d_counts[slot]);
+            }
+          }
+        }
+
+        std::size_t size() const { return d_size; }
+
+        void clear() {
+          std::fill(d_counts.begin(), d_counts.end(), count_type{0});
+          d_size = 0;
+        }
+
+      private:
+        /**
+         * Counts bytes into four interleaved 32-bit histograms, so consecutive equal bytes do not
+         * wait on one another's increments and the loop unrolls cleanly, folding them into the
+         * counts every 2^31 bytes before they can overflow.
+         */
+        template <typename ITERATOR> void count_bytes(ITERATOR first, ITERATOR last) {
+          constexpr std::ptrdiff_t block = std::ptrdiff_t{1} << 31;
+          std::array<std::array<std::uint32_t, 256>, 4> partial;
+          while (first != last) {
+            for (auto& histogram : partial) {
+              histogram.fill(0);
+            }
+            const ITERATOR end = first + std::min<std::ptrdiff_t>(last - first, block);
+            for (; end - first >= 4; first += 4) {
+              ++partial[0][index(first[0])];
+              ++partial[1][index(first[1])];
+              ++partial[2][index(first[2])];
+              ++partial[3][index(first[3])];
+            }
+            for (; first != end; ++first) {
+              ++partial[0][index(*first)];
+            }
+            for (std::size_t slot = 0; slot < domain; ++slot) {
+              d_counts[slot] += count_type{partial[0][slot]} + partial[1][slot] + partial[2][slot]
+                                + partial[3][slot];
+            }
+          }
+          d_size = static_cast<std::size_t>(
+              std::count_if(d_counts.begin(), d_counts.end(),
+                            [](count_type count) { return count != 0; }));
+        }
+      };
+
+      /**
+       * Counts keys in an open-addressing table with linear probing. A slot is empty when its
+       * count is zero, and erasing shifts the following slots back rather than leaving tombstones.
+       */
+      template <typename KEY, typename HASH> class open_addressing_table {
+        struct slot {
+          KEY d_key{};
+          count_type d_count = 0;
+        };
+
+        static constexpr std::size_t initial_capacity = 16;
+
+        std::vector<slot> d_slots = std::vector<slot>(initial_capacity);
+        std::size_t d_size = 0;
+        unsigned int d_shift = 64 - 4;
+        HASH d_hash{};
+
+        std::size_t mask() const { return d_slots.size() - 1; }
+
+        /** Fibonacci hashing spreads hashes such as the identity hash of integers over the table. */
+        std::size_t home(const KEY& key) const {
+          return static_cast<std::size_t>(
+              (static_cast<std::uint64_t>(d_hash(key)) * 0x9E3779B97F4A7C15ull) >> d_shift);
+        }
+
+        std::size_t find(const KEY& key) const {
+          for (std::size_t index = home(key);; index = (index + 1) & mask()) {
+            if (d_slots[index].d_count == 0 || d_slots[index].d_key == key) {
+              return index;
+            }
+          }
+        }
+
+        void grow() {
+          std::vector<slot> slots(d_slots.size() * 2);
+          slots.swap(d_slots);
+          --d_shift;
+          for (auto& old : slots) {
+            if (old.d_count != 0) {
+              d_slots[find(old.d_key)] = std::move(old);
+            }
+          }
+        }
+
+        void erase_slot(std::size_t hole) {
+          for (std::size_t index = (hole + 1) & mask(); d_slots[index].d_count != 0;
+               index = (index + 1) & mask()) {
+            // An entry can fill the hole unless its home lies cyclically after the hole.
+            const std::size_t wanted = home(d_slots[index].d_key);
+            const bool after_hole = hole < index ? hole < wanted && wanted <= index
+                                                 : hole < wanted || wanted <= index;
+            if (!after_hole) {
+              d_slots[hole] = std::move(d_slots[index]);
+              hole = index;
+            }
+          }
+          d_slots[hole] = slot{};
+          --d_size;
+        }
+
+      public:
+        void add(const KEY& key, count_type count) {
+          if (count == 0) {
+            return;
+          }
+          std::size_t index = find(key);
+          if (d_slots[index].d_count == 0) {
+            if ((d_size + 1) * 4 > d_slots.size() * 3) {
+              grow();
+              index = find(key);
+            }
+            d_slots[index].d_key = key;
+            ++d_size;
+          }
+          d_slots[index].d_count += count;
+          if (d_slots[index].d_count == 0) {
+            erase_slot(index);
+          }
+        }
+
+        template <typename ITERATOR> void count(ITERATOR first, ITERATOR last) {
+          for (; first != last; ++first) {
+            add(*first, 1);
+          }
+        }
+
+        count_type get(const KEY& key) const { return d_slots[find(key)].d_count; }
+
+        template <typename PREDICATE> void erase_if(PREDICATE&& predicate) {
+          // Erasing shifts later entries into the current slot, so it is examined again.
+          for (std::size_t index = 0; index < d_slots.size();) {
+            if (d_slots[index].d_count != 0 && predicate(d_slots[index].d_count)) {
+              erase_slot(index);
+            } else {
+              ++index;
+            }
+          }
+        }
+
+        template <typename VISIT> void for_each(VISIT&& visit) const {
+          for (const auto& entry : d_slots) {
+            if (entry.d_count != 0) {
+              visit(entry.d_key, entry.d_count);
+            }
+          }
+        }
+
+        std::size_t size() const { return d_size; }
+
+        void clear() {
+          std::fill(d_slots.begin(), d_slots.end(), slot{});
+          d_size = 0;
+        }
+      };
+    }  // namespace detail
+
+    /**
+     * Counts occurrences of keys, in the style of Python's collections.Counter.
+     *
+     * Keys whose counter_domain is dense are counted in an array indexed by their value; bytes are
+     * additionally counted through several interleaved histograms when a whole random access range
+     * is counted. Any other key is counted in an open-addressing hash table, which requires it to
+     * be default constructible and equality comparable. A range can also be counted by several
+     * threads into partial counters which are then merged.
+     *
+     * Counts may be negative after subtract(), but a key whose count reaches zero is removed, so a
+     * counter never holds zero counts.
+     *
+     * @tparam KEY The type of key counted.
+     * @tparam HASH The hash functor for keys counted in a hash table.
+     */
+    template <typename KEY, typename HASH = std::hash<KEY>> class counter {
+    public:
+      using key_type = KEY;
+      using count_type = detail::count_type;
+      static constexpr bool is_dense = counter_domain<KEY>::size != 0;
+
+    private:
+      /** Ranges shorter than this per thread are not worth starting a thread for. */
+      static constexpr std::ptrdiff_t minimum_parallel_chunk = std::ptrdiff_t{1} << 16;
+
+      std::conditional_t<is_dense, detail::dense_table<KEY>,
+                         detail::open_addressing_table<KEY, HASH>>
+          d_table;
+
+      void drop_non_positive() {
+        d_table.erase_if([](count_type count) { return count <= 0; });
+      }
+
+    public:
+      counter() = default;
+
+      /** Counts every key in the range. */
+      template <typename ITERATOR> counter(ITERATOR first, ITERATOR last) { update(first, last); }
+
+      /** Counts every key in the range using several threads. */
+      template <typename ITERATOR>
+      counter(ITERATOR first, ITERATOR last, parallel_count parallel) {
+        update(first, last, parallel);
+      }
+
+      counter(std::initializer_list<KEY> keys) { update(keys.begin(), keys.end()); }
+
+      /** Adds one to the count of every key in the range. */
+      template <typename ITERATOR> void update(ITERATOR first, ITERATOR last) {
+        d_table.count(first, last);
+      }
+
+      /**
+       * Adds one to the count of every key in the range, splitting a random access range between
+       * several threads which each count into their own counter before the counters are merged.
+       * Other ranges, and ranges too short to be worth splitting, are counted on the calling
+       * thread.
+       */
+      template <typename ITERATOR>
+      void update(ITERATOR first, ITERATOR last, parallel_count parallel) {
+        using category = typename std::iterator_traits<ITERATOR>::iterator_category;
+        if constexpr (!std::is_base_of_v<std::random_access_iterator_tag, category>) {
+          update(first, last);
+        } else {
+          const std::ptrdiff_t length = last - first;
+          const std::ptrdiff_t threads = std::max<std::ptrdiff_t>(
+              1, std::min<std::ptrdiff_t>(parallel.d_threads, length / minimum_parallel_chunk));
+          if (threads == 1) {
+            update(first, last);
+            return;
+          }
+          std::vector<std::future<counter>> partials;
+          for (std::ptrdiff_t thread = 1; thread < threads; ++thread) {
+            partials.push_back(std::async(std::launch::async, [=] {
+              return counter(first + length * thread / threads,
+                             first + length * (thread + 1) / threads);
+            }));
+          }
+          update(first, first + length / threads);
+          for (auto& partial : partials) {
+            update(partial.get());
+          }
+        }
+      }
+
+      /** Adds every count of the other counter to this one. */
+      void update(const counter& other) {
+        other.for_each([this](const KEY& key, count_type count) { d_table.add(key, count); });
+      }
+
+      /** Subtracts every count of the other counter from this one, keeping negative counts. */
+      void subtract(const counter& other) {
+        other.for_each([this](const KEY& key, count_type count) { d_table.add(key, -count); });
+      }
+
+      /** Adds count, which may be negative, to the count of the key. */
+      void add(const KEY& key, count_type count = 1) { d_table.add(key, count); }
+
+      /** The count of the key, zero if it has not been counted. */
+      count_type operator[](const KEY& key) const { return d_table.get(key); }
+
+      /** Removes the key's count. */
+      void erase(const KEY& key) { d_table.add(key, -d_table.get(key)); }
+
+      /** Up to n keys with the highest counts, the highest first. */
+      std::vector<std::pair<KEY, count_type>> most_common(std::size_t n) const {
+        std::vector<std::pair<KEY, count_type>> entries;
+        entries.reserve(size());
+        for_each([&entries](const KEY& key, count_type count) { entries.emplace_back(key, count); });
+        n = std::min(n, entries.size());
+        std::partial_sort(
+            entries.begin(), entries.begin() + n, entries.end(),
+            [](const auto& left, const auto& right) { return left.second > right.second; });
+        entries.resize(n);
+        return entries;
       }
+
+      /** Every key with its count, the highest counts first. */
+      std::vector<std::pair<KEY, count_type>> most_common() const { return most_common(size()); }
+
+      /** Calls visit(key, count) for every counted key, in no particular order. */
+      template <typename VISIT> void for_each(VISIT&& visit) const {
+        d_table.for_each(std::forward<VISIT>(visit));
+      }
+
+      /** The sum of every count. */
+      count_type total() const {
+        count_type total = 0;
+        for_each([&total](const KEY&, count_type count) { total += count; });
+        return total;
+      }
+
+      /** The number of keys with a non-zero count. */
+      std::size_t size() const { return d_table.size(); }
+
+      bool empty() const { return size() == 0; }
+
+      void clear() { d_table.clear(); }
+
+      /** Adds the other counter's counts, keeping only positive counts. */
+      counter& operator+=(const counter& other) {
+        update(other);
+        drop_non_positive();
+        return *this;
+      }
+
+      /** Subtracts the other counter's counts, keeping only positive counts. */
+      counter& operator-=(const counter& other) {
+        subtract(other);
+        drop_non_positive();
+        return *this;
+      }
+
+      friend counter operator+(counter left, const counter& right) { return left += right; }
+
+      friend counter operator-(counter left, const counter& right) { return left -= right; }
+
+      friend bool operator==(const counter& left, const counter& right) {
+        if (left.size() != right.size()) {
+          return false;
+        }
+        bool equal = true;
+        left.for_each([&](const KEY& key, count_type count) { equal = equal && right[key] == count; });
+        return equal;
+      }
+
+      friend bool operator!=(const counter& left, const counter& right) { return !(left == right); }
     };
+
+    template <typename ITERATOR> counter(ITERATOR, ITERATOR)
+        -> counter<typename std::iterator_traits<ITERATOR>::value_type>;
+
+    template <typename ITERATOR> counter(ITERATOR, ITERATOR, parallel_count)
+        -> counter<typename std::iterator_traits<ITERATOR>::value_type>;
   }  // namespace collection
 }  // namespace hh
 
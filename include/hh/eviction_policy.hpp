@@ -0,0 +1,501 @@
+#ifndef INCLUDED_HH_EVICTION_POLICY_HPP
+#define INCLUDED_HH_EVICTION_POLICY_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <hh/count_min_sketch.hpp>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Eviction policies for basic_lru_cache.
+ *
+ * A policy is a tag type with a nested `policy<ENTRY, ALLOCATOR>` class template which owns the
+ * cache entries and decides which of them to drop, allocating its nodes with ALLOCATOR rebound to
+ * each node type. The nested class provides:
+ *
+ *  - `handle`, a stable reference to a stored entry, and `static ENTRY& entry(handle)`.
+ *  - A constructor taking the maximum number of entries, zero meaning unbounded, and optionally
+ *    the allocator.
+ *  - `void touch(handle)`, called on every cache hit.
+ *  - `handle insert(ENTRY&&, std::size_t hash, EVICT&&)`, which stores a new entry and calls
+ *    `EVICT(const ENTRY&)` for every other entry it drops before destroying it. The new entry
+ *    itself is never dropped. hash is the hash the cache keys the entry by, which policies
+ *    tracking key frequencies or evicted keys keep instead of hashing the key again.
+ *  - `void evict_one(handle keep, EVICT&&)`, which drops the entry the policy would drop next
+ *    other than keep, calling `EVICT(const ENTRY&)` first. Only called while another entry than
+ *    keep is stored, and used by caches which bound something other than the entry count, which
+ *    pass the entry they just inserted as keep.
+ *  - `void for_each(F&&) const`, visiting the stored entries.
+ */
+namespace hh {
+  namespace functools {
+    namespace detail {
+      enum class segment : unsigned char { window, probation, protect, recent, frequent };
+
+      template <typename ALLOCATOR, typename VALUE> using rebind_alloc =
+          typename std::allocator_traits<ALLOCATOR>::template rebind_alloc<VALUE>;
+
+      template <typename ENTRY> struct segmented_node {
+        ENTRY d_entry;
+        std::size_t d_hash; /** The hash the cache keys the entry by. */
+        segment d_segment;
+      };
+
+      /**
+       * Probation and protected segments shared by the segmented policies. Entries enter on
+       * probation and are promoted to the protected segment when hit again; the protected segment
+       * demotes its least recently used entry back to probation when it overflows.
+       */
+      template <typename ENTRY, typename ALLOCATOR> class segmented_lru {
+      public:
+        using node = segmented_node<ENTRY>;
+        using node_list = std::list<node, rebind_alloc<ALLOCATOR, node>>;
+        using handle = typename node_list::iterator;
+
+      private:
+        node_list d_probation;
+        node_list d_protected;
+        std::size_t d_protected_capacity;
+
+      public:
+        segmented_lru(std::size_t protected_capacity, const ALLOCATOR& allocator)
+            : d_probation{typename node_list::allocator_type{allocator}},
+              d_protected{typename node_list::allocator_type{allocator}},
+              d_protected_capacity{protected_capacity} {}
+
+        std::size_t size() const { return d_probation.size() + d_protected.size(); }
+
+        handle admit(ENTRY&& entry, std::size_t hash) {
+          d_probation.push_back(node{std::move(entry), hash, segment::probation});
+          return std::prev(d_probation.end());
+        }
+
+        void adopt(node_list& from, handle entry) {
+          entry->d_segment = segment::probation;
+          d_probation.splice(d_probation.end(), from, entry);
+        }
+
+        void promote(handle entry) {
+          if (entry->d_segment == segment::protect) {
+            d_protected.splice(d_protected.end(), d_protected, entry);
+            return;
+          }
+          entry->d_segment = segment::protect;
+          d_protected.splice(d_protected.end(), d_probation, entry);
+          if (d_protected.size() > d_protected_capacity) {
+            auto demoted = d_protected.begin();
+            demoted->d_segment = segment::probation;
+            d_probation.splice(d_probation.end(), d_protected, demoted);
+          }
+        }
+
+        /** The next entry to drop; only valid while the segments are not empty. */
+        handle victim() { return d_probation.empty() ? d_protected.begin() : d_probation.begin(); }
+
+        /** The next entry to drop other than keep; only valid while another entry is stored. */
+        handle victim(handle keep) {
+          for (node_list* segment : {&d_probation, &d_protected}) {
+            for (auto candidate = segment->begin(); candidate != segment->end(); ++candidate) {
+              if (candidate != keep) {
+                return candidate;
+              }
+            }
+          }
+          return keep;
+        }
+
+        void erase(handle entry) {
+          (entry->d_segment == segment::protect ? d_protected : d_probation).erase(entry);
+        }
+
+        template <typename F> void for_each(F&& func) const {
+          for (const auto& entry : d_probation) {
+            func(entry.d_entry);
+          }
+          for (const auto& entry : d_protected) {
+            func(entry.d_entry);
+          }
+        }
+      };
+
+      /** The protected share of a segmented region, always leaving room for one probation entry. */
+      inline std::size_t protected_capacity(std::size_t capacity, unsigned int percent) {
+        return capacity == 0 ? 0 : std::min(capacity * percent / 100, capacity - 1);
+      }
+    }  // namespace detail
+
+    /**
+     * Strict least-recently-used eviction, the default policy of basic_lru_cache.
+     */
+    struct lru_eviction {
+      template <typename ENTRY, typename ALLOCATOR = std::allocator<ENTRY>> class policy {
+        using entry_list = std::list<ENTRY, detail::rebind_alloc<ALLOCATOR, ENTRY>>;
+
+      public:
+        using handle = typename entry_list::iterator;
+
+      private:
+        std::size_t d_max_size;
+        entry_list d_entries;
+
+      public:
+        explicit policy(std::size_t max_size, const ALLOCATOR& allocator = ALLOCATOR{})
+            : d_max_size{max_size}, d_entries{typename entry_list::allocator_type{allocator}} {}
+
+        static ENTRY& entry(handle entry) { return *entry; }
+
+        void touch(handle entry) { d_entries.splice(d_entries.end(), d_entries, entry); }
+
+        template <typename EVICT> handle insert(ENTRY&& entry, std::size_t, EVICT&& evict) {
+          d_entries.push_back(std::move(entry));
+          if (d_max_size != 0 && d_entries.size() > d_max_size) {
+            evict(d_entries.front());
+            d_entries.pop_front();
+          }
+          return std::prev(d_entries.end());
+        }
+
+        template <typename EVICT> void evict_one(handle keep, EVICT&& evict) {
+          const handle victim = d_entries.begin() == keep ? std::next(keep) : d_entries.begin();
+          evict(*victim);
+          d_entries.erase(victim);
+        }
+
+        template <typename F> void for_each(F&& func) const {
+          for (const auto& entry : d_entries) {
+            func(entry);
+          }
+        }
+      };
+    };
+
+    /**
+     * Segmented LRU eviction.
+     *
+     * New entries are placed on probation and only move to the protected segment when they are hit
+     * again, so a scan of one-off keys can only flush the probation segment.
+     *
+     * @tparam PROTECTED_PERCENT The share of the capacity reserved for the protected segment.
+     */
+    template <unsigned int PROTECTED_PERCENT = 80> struct segmented_lru_eviction {
+      static_assert(PROTECTED_PERCENT <= 100, "The protected segment cannot exceed the cache.");
+
+      template <typename ENTRY, typename ALLOCATOR = std::allocator<ENTRY>> class policy {
+        using segments = detail::segmented_lru<ENTRY, ALLOCATOR>;
+
+      public:
+        using handle = typename segments::handle;
+
+      private:
+        std::size_t d_max_size;
+        segments d_segments;
+
+      public:
+        explicit policy(std::size_t max_size, const ALLOCATOR& allocator = ALLOCATOR{})
+            : d_max_size{max_size},
+              d_segments{detail::protected_capacity(max_size, PROTECTED_PERCENT), allocator} {}
+
+        static ENTRY& entry(handle entry) { return entry->d_entry; }
+
+        void touch(handle entry) { d_segments.promote(entry); }
+
+        template <typename EVICT> handle insert(ENTRY&& entry, std::size_t hash, EVICT&& evict) {
+          handle inserted = d_segments.admit(std::move(entry), hash);
+          if (d_max_size != 0 && d_segments.size() > d_max_size) {
+            handle victim = d_segments.victim();
+            evict(victim->d_entry);
+            d_segments.erase(victim);
+          }
+          return inserted;
+        }
+
+        template <typename EVICT> void evict_one(handle keep, EVICT&& evict) {
+          handle victim = d_segments.victim(keep);
+          evict(victim->d_entry);
+          d_segments.erase(victim);
+        }
+
+        template <typename F> void for_each(F&& func) const { d_segments.for_each(func); }
+      };
+    };
+
+    /**
+     * Adaptive Replacement Cache eviction.
+     *
+     * Balances a recency list of keys seen once against a frequency list of keys seen at least
+     * twice. Hashes of recently evicted keys are remembered in two ghost lists, and a miss on a
+     * ghost shifts capacity towards the list which would have kept that key.
+     */
+    struct arc_eviction {
+      template <typename ENTRY, typename ALLOCATOR = std::allocator<ENTRY>> class policy {
+        using node = detail::segmented_node<ENTRY>;
+        using node_list = std::list<node, detail::rebind_alloc<ALLOCATOR, node>>;
+        using ghost_list = std::list<std::size_t, detail::rebind_alloc<ALLOCATOR, std::size_t>>;
+
+      public:
+        using handle = typename node_list::iterator;
+
+      private:
+        struct ghost {
+          bool d_frequent;
+          typename ghost_list::iterator d_position;
+        };
+
+        using ghost_map = std::unordered_map<
+            std::size_t, ghost, std::hash<std::size_t>, std::equal_to<std::size_t>,
+            detail::rebind_alloc<ALLOCATOR, std::pair<const std::size_t, ghost>>>;
+
+        std::size_t d_max_size;
+        std::size_t d_target_recent;
+        node_list d_recent;
+        node_list d_frequent;
+        ghost_list d_recent_ghosts;
+        ghost_list d_frequent_ghosts;
+        ghost_map d_ghosts;
+
+      public:
+        explicit policy(std::size_t max_size, const ALLOCATOR& allocator = ALLOCATOR{})
+            : d_max_size{max_size},
+              d_target_recent{0},
+              d_recent{typename node_list::allocator_type{allocator}},
+              d_frequent{typename node_list::allocator_type{allocator}},
+              d_recent_ghosts{typename ghost_list::allocator_type{allocator}},
+              d_frequent_ghosts{typename ghost_list::allocator_type{allocator}},
+              d_ghosts{typename ghost_map::allocator_type{allocator}} {}
+
+        static ENTRY& entry(handle entry) { return entry->d_entry; }
+
+        void touch(handle entry) {
+          node_list& owner
+              = entry->d_segment == detail::segment::recent ? d_recent : d_frequent;
+          entry->d_segment = detail::segment::frequent;
+          d_frequent.splice(d_frequent.end(), owner, entry);
+        }
+
+        template <typename EVICT> handle insert(ENTRY&& entry, std::size_t hash, EVICT&& evict) {
+          if (d_max_size == 0) {
+            return push(d_recent, std::move(entry), hash, detail::segment::recent);
+          }
+          auto found = d_ghosts.find(hash);
+          if (found != d_ghosts.end()) {
+            const bool frequent = found->second.d_frequent;
+            if (frequent) {
+              const std::size_t step
+                  = std::max<std::size_t>(d_recent_ghosts.size() / d_frequent_ghosts.size(), 1);
+              d_target_recent -= std::min(d_target_recent, step);
+              d_frequent_ghosts.erase(found->second.d_position);
+            } else {
+              const std::size_t step
+                  = std::max<std::size_t>(d_frequent_ghosts.size() / d_recent_ghosts.size(), 1);
+              d_target_recent = std::min(d_max_size, d_target_recent + step);
+              d_recent_ghosts.erase(found->second.d_position);
+            }
+            d_ghosts.erase(found);
+            replace(frequent, evict);
+            return push(d_frequent, std::move(entry), hash, detail::segment::frequent);
+          }
+          if (d_recent.size() + d_recent_ghosts.size() >= d_max_size) {
+            if (d_recent.size() < d_max_size) {
+              drop_oldest_ghost(d_recent_ghosts);
+              replace(false, evict);
+            } else {
+              evict(d_recent.front().d_entry);
+              d_recent.pop_front();
+            }
+          } else if (d_recent.size() + d_frequent.size() + d_recent_ghosts.size()
+                         + d_frequent_ghosts.size()
+                     >= d_max_size) {
+            if (d_recent.size() + d_frequent.size() + d_recent_ghosts.size()
+                    + d_frequent_ghosts.size()
+                >= 2 * d_max_size) {
+              drop_oldest_ghost(d_frequent_ghosts);
+            }
+            replace(false, evict);
+          }
+          return push(d_recent, std::move(entry), hash, detail::segment::recent);
+        }
+
+        template <typename EVICT> void evict_one(handle keep, EVICT&& evict) {
+          const auto holds_other = [keep](const node_list& list) {
+            return list.size() > 1 || (!list.empty() && list.begin() != keep);
+          };
+          node_list& owner = holds_other(d_recent)
+                                     && (d_recent.size() > d_target_recent
+                                         || !holds_other(d_frequent))
+                                 ? d_recent
+                                 : d_frequent;
+          const handle victim = owner.begin() == keep ? std::next(keep) : owner.begin();
+          evict(victim->d_entry);
+          owner.erase(victim);
+        }
+
+        template <typename F> void for_each(F&& func) const {
+          for (const auto& entry : d_recent) {
+            func(entry.d_entry);
+          }
+          for (const auto& entry : d_frequent) {
+            func(entry.d_entry);
+          }
+        }
+
+      private:
+        handle push(node_list& owner, ENTRY&& entry, std::size_t hash, detail::segment segment) {
+          owner.push_back(node{std::move(entry), hash, segment});
+          return std::prev(owner.end());
+        }
+
+        void drop_oldest_ghost(ghost_list& ghosts) {
+          if (!ghosts.empty()) {
+            d_ghosts.erase(ghosts.front());
+            ghosts.pop_front();
+          }
+        }
+
+        template <typename EVICT> void replace(bool frequent_ghost_hit, EVICT& evict) {
+          if (d_recent.size() + d_frequent.size() < d_max_size) {
+            return;
+          }
+          const bool from_recent
+              = !d_recent.empty()
+                && (d_recent.size() > d_target_recent
+                    || (frequent_ghost_hit && d_recent.size() == d_target_recent)
+                    || d_frequent.empty());
+          node_list& owner = from_recent ? d_recent : d_frequent;
+          ghost_list& ghosts = from_recent ? d_recent_ghosts : d_frequent_ghosts;
+          const std::size_t hash = owner.front().d_hash;
+          evict(owner.front().d_entry);
+          owner.pop_front();
+          auto previous = d_ghosts.find(hash);
+          if (previous != d_ghosts.end()) {
+            (previous->second.d_frequent ? d_frequent_ghosts : d_recent_ghosts)
+                .erase(previous->second.d_position);
+            d_ghosts.erase(previous);
+          }
+          ghosts.push_back(hash);
+          d_ghosts.emplace(hash, ghost{!from_recent, std::prev(ghosts.end())});
+        }
+      };
+    };
+
+    /**
+     * Window TinyLFU eviction.
+     *
+     * New entries go through a small LRU window. An entry leaving the window is only admitted to
+     * the main segmented-LRU region if a count-min sketch of recent access frequencies estimates it
+     * to be more popular than the entry it would displace; otherwise it is dropped. The sketch is
+     * halved periodically so stale popularity decays.
+     *
+     * @tparam WINDOW_PERCENT The share of the capacity given to the admission window.
+     */
+    template <unsigned int WINDOW_PERCENT = 1> struct wtinylfu_eviction {
+      static_assert(WINDOW_PERCENT > 0 && WINDOW_PERCENT <= 100,
+                    "The admission window must be a share of the cache.");
+
+      template <typename ENTRY, typename ALLOCATOR = std::allocator<ENTRY>> class policy {
+        using segments = detail::segmented_lru<ENTRY, ALLOCATOR>;
+        using node = typename segments::node;
+        using node_list = typename segments::node_list;
+        using sketch = hh::collection::count_min_sketch<std::uint8_t>;
+        static constexpr unsigned int main_protected_percent = 80;
+        static constexpr std::size_t sketch_depth = 4;
+        static constexpr std::size_t counters_per_entry = 4;
+        static constexpr std::size_t samples_per_entry = 10;
+
+      public:
+        using handle = typename segments::handle;
+
+      private:
+        std::size_t d_max_size;
+        std::size_t d_window_capacity;
+        std::size_t d_main_capacity;
+        node_list d_window;
+        segments d_main;
+        sketch d_sketch;
+        std::size_t d_samples;
+
+      public:
+        explicit policy(std::size_t max_size, const ALLOCATOR& allocator = ALLOCATOR{})
+            : d_max_size{max_size},
+              d_window_capacity{std::max<std::size_t>(max_size * WINDOW_PERCENT / 100, 1)},
+              d_main_capacity{max_size > d_window_capacity ? max_size - d_window_capacity : 0},
+              d_window{typename node_list::allocator_type{allocator}},
+              d_main{detail::protected_capacity(d_main_capacity, main_protected_percent),
+                     allocator},
+              d_sketch{counters_per_entry * std::max<std::size_t>(max_size, 16), sketch_depth},
+              d_samples{0} {}
+
+        static ENTRY& entry(handle entry) { return entry->d_entry; }
+
+        void touch(handle entry) {
+          record(entry->d_hash);
+          if (entry->d_segment == detail::segment::window) {
+            d_window.splice(d_window.end(), d_window, entry);
+          } else {
+            d_main.promote(entry);
+          }
+        }
+
+        template <typename EVICT> handle insert(ENTRY&& entry, std::size_t hash, EVICT&& evict) {
+          record(hash);
+          d_window.push_back(node{std::move(entry), hash, detail::segment::window});
+          handle inserted = std::prev(d_window.end());
+          if (d_max_size == 0 || d_window.size() <= d_window_capacity) {
+            return inserted;
+          }
+          handle candidate = d_window.begin();
+          if (d_main.size() < d_main_capacity) {
+            d_main.adopt(d_window, candidate);
+            return inserted;
+          }
+          if (d_main_capacity != 0) {
+            handle victim = d_main.victim();
+            if (d_sketch.estimate(candidate->d_hash) > d_sketch.estimate(victim->d_hash)) {
+              evict(victim->d_entry);
+              d_main.erase(victim);
+              d_main.adopt(d_window, candidate);
+              return inserted;
+            }
+          }
+          evict(candidate->d_entry);
+          d_window.erase(candidate);
+          return inserted;
+        }
+
+        template <typename EVICT> void evict_one(handle keep, EVICT&& evict) {
+          if (d_main.size() == 0 || (d_main.size() == 1 && d_main.victim() == keep)) {
+            const handle victim = d_window.begin() == keep ? std::next(keep) : d_window.begin();
+            evict(victim->d_entry);
+            d_window.erase(victim);
+            return;
+          }
+          handle victim = d_main.victim(keep);
+          evict(victim->d_entry);
+          d_main.erase(victim);
+        }
+
+        template <typename F> void for_each(F&& func) const {
+          for (const auto& entry : d_window) {
+            func(entry.d_entry);
+          }
+          d_main.for_each(func);
+        }
+
+      private:
+        void record(std::size_t hash) {
+          d_sketch.increment(hash);
+          if (++d_samples >= samples_per_entry * std::max<std::size_t>(d_max_size, 16)) {
+            d_sketch.halve();
+            d_samples /= 2;
+          }
+        }
+      };
+    };
+  }  // namespace functools
+}  // namespace hh
+
+#endif
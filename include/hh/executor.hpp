@@ -0,0 +1,113 @@
+#ifndef INCLUDED_HH_EXECUTOR_HPP
+#define INCLUDED_HH_EXECUTOR_HPP
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Executors for the asynchronous caches.
+ *
+ * An executor is a copyable type with an `execute(TASK&&) const` member which runs the task, a
+ * callable taking no arguments which does not throw, at some later point. Copies of an executor
+ * run tasks in the same place, so one executor can be shared between several caches.
+ */
+namespace hh {
+  namespace functools {
+
+    /** Runs every task on the calling thread before execute() returns. */
+    struct inline_executor {
+      template <typename TASK> void execute(TASK&& task) const { std::forward<TASK>(task)(); }
+    };
+
+    /**
+     * Runs tasks in the order they are submitted on a fixed number of worker threads.
+     *
+     * Copies share the same workers, which finish every queued task and are joined once the last
+     * copy is destroyed. That copy must therefore not be destroyed by one of the pool's own tasks.
+     */
+    class thread_pool_executor {
+      class pool {
+        std::mutex d_mutex;
+        std::condition_variable d_ready;
+        std::deque<std::function<void()>> d_tasks;
+        bool d_stopping = false;
+        std::vector<std::thread> d_workers;
+
+      public:
+        explicit pool(std::size_t threads) {
+          d_workers.reserve(threads);
+          for (std::size_t index = 0; index < threads; ++index) {
+            d_workers.emplace_back([this] { work(); });
+          }
+        }
+
+        pool(const pool&) = delete;
+        pool& operator=(const pool&) = delete;
+
+        ~pool() {
+          {
+            std::lock_guard<std::mutex> lock{d_mutex};
+            d_stopping = true;
+          }
+          d_ready.notify_all();
+          for (auto& worker : d_workers) {
+            worker.join();
+          }
+        }
+
+        void submit(std::function<void()> task) {
+          {
+            std::lock_guard<std::mutex> lock{d_mutex};
+            d_tasks.push_back(std::move(task));
+          }
+          d_ready.notify_one();
+        }
+
+        std::size_t thread_count() const { return d_workers.size(); }
+
+      private:
+        void work() {
+          while (true) {
+            std::function<void()> task;
+            {
+              std::unique_lock<std::mutex> lock{d_mutex};
+              d_ready.wait(lock, [this] { return d_stopping || !d_tasks.empty(); });
+              if (d_tasks.empty()) {
+                return;
+              }
+              task = std::move(d_tasks.front());
+              d_tasks.pop_front();
+            }
+            task();
+          }
+        }
+      };
+
+      std::shared_ptr<pool> d_pool;
+
+    public:
+      /** @param threads The number of worker threads, at least one. Defaults to one per hardware
+       * thread. */
+      explicit thread_pool_executor(
+          std::size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+          : d_pool{std::make_shared<pool>(std::max<std::size_t>(threads, 1))} {}
+
+      /** Queues the task, which must be copyable, to run on the next free worker. */
+      template <typename TASK> void execute(TASK&& task) const {
+        d_pool->submit(std::function<void()>{std::forward<TASK>(task)});
+      }
+
+      /** The number of worker threads. */
+      std::size_t thread_count() const { return d_pool->thread_count(); }
+    };
+  }  // namespace functools
+}  // namespace hh
+
+#endif
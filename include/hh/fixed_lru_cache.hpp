@@ -0,0 +1,287 @@
+#ifndef INCLUDED_HH_FIXED_LRU_CACHE_HPP
+#define INCLUDED_HH_FIXED_LRU_CACHE_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <hh/hash.hpp>
+#include <hh/key_view.hpp>
+#include <limits>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace hh {
+  namespace functools {
+
+    /**
+     * Functional-style lru-cache whose capacity is fixed at compile time and whose entries live
+     * inside the cache object itself.
+     *
+     * Behaves like lru_cache bounded to CAPACITY entries, but never allocates: entries are
+     * constructed in place in an inline array as they are first cached, the recency order is kept
+     * as intrusive previous/next indices and constructing the cache initialises little more than
+     * its bookkeeping. It suits small per-request or per-thread memoization, and can live on the
+     * stack.
+     *
+     * Caches of up to linear_scan_capacity entries find a key by comparing it with every entry in
+     * turn, which for so few entries is cheaper than hashing it. Larger caches hash the arguments
+     * with wyhash into an inline open-addressing index at most half full.
+     *
+     * @see lru_cache
+     * @see make_fixed_lrucache
+     * @tparam CAPACITY The maximum number of entries the cache holds.
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparams ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     */
+    template <std::size_t CAPACITY, typename RETURN_TYPE, typename... ARGUMENTS>
+    class fixed_lru_cache {
+      static_assert(CAPACITY > 0, "A fixed_lru_cache must hold at least one entry.");
+
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      static constexpr std::size_t linear_scan_capacity = 8;
+      static constexpr bool is_linear_scan = CAPACITY <= linear_scan_capacity;
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using cache_entry = std::pair<cache_key, decayed_return_type>;
+      using function_signature = std::function<RETURN_TYPE(ARGUMENTS...)>;
+
+    private:
+      using index_type = std::conditional_t<
+          (CAPACITY < std::numeric_limits<std::uint8_t>::max()), std::uint8_t,
+          std::conditional_t<(CAPACITY < std::numeric_limits<std::uint16_t>::max()),
+                             std::uint16_t, std::uint32_t>>;
+      using key_hash_type = wy_key_hash<cache_key>;
+      static constexpr index_type npos = std::numeric_limits<index_type>::max();
+
+      static constexpr std::size_t index_capacity() {
+        std::size_t capacity = 1;
+        while (capacity < 2 * CAPACITY) {
+          capacity <<= 1;
+        }
+        return is_linear_scan ? 0 : capacity;
+      }
+
+      struct link {
+        index_type d_prev;
+        index_type d_next;
+      };
+
+      function_signature d_func;
+      index_type d_size = 0;
+      index_type d_constructed_slots = 0;
+      index_type d_free = npos;
+      index_type d_oldest = npos;
+      index_type d_newest = npos;
+      std::array<link, CAPACITY> d_links;
+      std::array<std::size_t, is_linear_scan ? 0 : CAPACITY> d_hashes;
+      std::array<index_type, index_capacity()> d_index;
+      std::aligned_storage_t<sizeof(cache_entry), alignof(cache_entry)> d_entries[CAPACITY];
+
+    public:
+      fixed_lru_cache() = delete;
+      /**
+       * Constructs an empty cache with a given function.
+       *
+       * @see make_fixed_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       */
+      explicit fixed_lru_cache(RETURN_TYPE (*func)(ARGUMENTS...))
+          : fixed_lru_cache(function_signature{func}) {}
+      /**
+       * Constructs an empty cache with a given function.
+       *
+       * @see make_fixed_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       */
+      explicit fixed_lru_cache(function_signature func) : d_func{std::move(func)} {
+        d_index.fill(npos);
+      }
+
+      fixed_lru_cache(const fixed_lru_cache&) = delete;
+      fixed_lru_cache& operator=(const fixed_lru_cache&) = delete;
+
+      ~fixed_lru_cache() {
+        for (index_type slot = d_oldest; slot != npos; slot = d_links[slot].d_next) {
+          entry(slot).~cache_entry();
+        }
+      }
+
+      /**
+       * Calls the underlying function or returns historic value.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS> RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) {
+        const auto probe = std::forward_as_tuple(args...);
+        std::size_t hash = 0;
+        std::size_t position = 0;
+        if constexpr (is_linear_scan) {
+          for (index_type slot = d_newest; slot != npos; slot = d_links[slot].d_prev) {
+            if (matches(slot, probe)) {
+              touch(slot);
+              return entry(slot).second;
+            }
+          }
+        } else {
+          hash = key_hash_type{}(probe);
+          position = home_position(hash);
+          for (index_type found = d_index[position]; found != npos; found = d_index[position]) {
+            if (d_hashes[found] == hash && matches(found, probe)) {
+              touch(found);
+              return entry(found).second;
+            }
+            position = next_position(position);
+          }
+        }
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        decayed_return_type value = std::apply(d_func, key);
+        // Built before anything is evicted, so a throwing key or value construction leaves the
+        // cache unchanged. Moving it into its slot may still throw for copy-only types, which
+        // leaves the cache consistent but without the entry it evicted.
+        cache_entry created{std::move(key), std::move(value)};
+        return entry(insert(std::move(created), hash, position)).second;
+      }
+
+      /** The maximum number of entries this cache can store. */
+      static constexpr auto max_size() { return CAPACITY; }
+
+      /** The current number of retained historic values */
+      auto size() const { return static_cast<std::size_t>(d_size); }
+
+    private:
+      cache_entry& entry(index_type slot) {
+        return *std::launder(reinterpret_cast<cache_entry*>(&d_entries[slot]));
+      }
+
+      template <typename PROBE> bool matches(index_type slot, const PROBE& probe) {
+        return detail::key_equal(entry(slot).first, probe,
+                                 std::make_index_sequence<key_size>{});
+      }
+
+      static std::size_t home_position(std::size_t hash) { return hash & (index_capacity() - 1); }
+
+      static std::size_t next_position(std::size_t position) {
+        return (position + 1) & (index_capacity() - 1);
+      }
+
+      /**
+       * Stores the entry, evicting the least recently used one when the cache is full.
+       *
+       * The slot is only linked and indexed once the entry is constructed in it. A slot whose
+       * construction threw is kept on a free list, so every linked slot holds an entry.
+       */
+      index_type insert(cache_entry&& created, std::size_t hash, std::size_t position) {
+        index_type target;
+        if (d_free != npos) {
+          target = d_free;
+          d_free = d_links[target].d_next;
+        } else if (d_constructed_slots < CAPACITY) {
+          target = d_constructed_slots;
+        } else {
+          target = d_oldest;
+          unlink(target);
+          if constexpr (!is_linear_scan) {
+            erase_from_index(target);
+            position = free_position(hash);
+          }
+          entry(target).~cache_entry();
+          --d_size;
+        }
+        try {
+          ::new (static_cast<void*>(&d_entries[target])) cache_entry(std::move(created));
+        } catch (...) {
+          if (target != d_constructed_slots) {
+            d_links[target].d_next = d_free;
+            d_free = target;
+          }
+          throw;
+        }
+        if (target == d_constructed_slots) {
+          ++d_constructed_slots;
+        }
+        ++d_size;
+        if constexpr (!is_linear_scan) {
+          d_hashes[target] = hash;
+          d_index[position] = target;
+        }
+        link_newest(target);
+        return target;
+      }
+
+      std::size_t free_position(std::size_t hash) const {
+        std::size_t position = home_position(hash);
+        while (d_index[position] != npos) {
+          position = next_position(position);
+        }
+        return position;
+      }
+
+      void erase_from_index(index_type target) {
+        std::size_t position = home_position(d_hashes[target]);
+        while (d_index[position] != target) {
+          position = next_position(position);
+        }
+        // Backward-shift deletion keeps every remaining entry reachable from its home position.
+        constexpr std::size_t mask = index_capacity() - 1;
+        std::size_t hole = position;
+        for (position = next_position(position); d_index[position] != npos;
+             position = next_position(position)) {
+          const std::size_t home = home_position(d_hashes[d_index[position]]);
+          if (((position - home) & mask) >= ((position - hole) & mask)) {
+            d_index[hole] = d_index[position];
+            hole = position;
+          }
+        }
+        d_index[hole] = npos;
+      }
+
+      void unlink(index_type target) {
+        const link& node = d_links[target];
+        if (node.d_prev != npos) {
+          d_links[node.d_prev].d_next = node.d_next;
+        } else {
+          d_oldest = node.d_next;
+        }
+        if (node.d_next != npos) {
+          d_links[node.d_next].d_prev = node.d_prev;
+        } else {
+          d_newest = node.d_prev;
+        }
+      }
+
+      void link_newest(index_type target) {
+        link& node = d_links[target];
+        node.d_prev = d_newest;
+        node.d_next = npos;
+        if (d_newest != npos) {
+          d_links[d_newest].d_next = target;
+        } else {
+          d_oldest = target;
+        }
+        d_newest = target;
+      }
+
+      void touch(index_type target) {
+        if (target != d_newest) {
+          unlink(target);
+          link_newest(target);
+        }
+      }
+    };
+
+    template <std::size_t CAPACITY, typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_fixed_lrucache(std::function<RETURN_TYPE(ARGUMENTS...)> func) {
+      return fixed_lru_cache<CAPACITY, RETURN_TYPE, ARGUMENTS...>(func);
+    }
+    template <std::size_t CAPACITY, typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_fixed_lrucache(RETURN_TYPE (*func)(ARGUMENTS...)) {
+      return fixed_lru_cache<CAPACITY, RETURN_TYPE, ARGUMENTS...>(func);
+    }
+  }  // namespace functools
+}  // namespace hh
+#endif
@@ -0,0 +1,259 @@
+#ifndef INCLUDED_HH_FLAT_LRU_CACHE_HPP
+#define INCLUDED_HH_FLAT_LRU_CACHE_HPP
+#include <cstdint>
+#include <functional>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <limits>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace hh {
+  namespace functools {
+
+    /**
+     * Functional-style lru-cache backed by a single contiguous array of entries.
+     *
+     * Behaves like lru_cache but stores its entries differently: max_size() slots are allocated up
+     * front, the recency order is kept as intrusive previous/next indices inside the slots and an
+     * open-addressing table of slot indices is used to find a key. Every key is stored exactly once,
+     * in its slot, and once the cache is full a miss reuses the slot of the evicted entry, so the
+     * steady state performs no heap allocation of its own.
+     *
+     * A maximum size of zero still makes the cache unbounded, in which case the slot array and index
+     * double in size whenever they fill up.
+     *
+     * @see lru_cache
+     * @see make_flat_lrucache
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparams ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> class flat_lru_cache {
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using cache_entry = std::pair<cache_key, decayed_return_type>;
+      using function_signature = std::function<RETURN_TYPE(ARGUMENTS...)>;
+
+    private:
+      using index_type = std::uint32_t;
+      static constexpr index_type npos = std::numeric_limits<index_type>::max();
+      static constexpr index_type initial_unbounded_slots = 16;
+
+      struct slot {
+        std::optional<cache_entry> d_entry;
+        std::size_t d_hash = 0;
+        index_type d_prev = npos;
+        index_type d_next = npos;
+      };
+
+      function_signature d_func;
+      unsigned int d_max_size;
+      std::vector<slot> d_slots;
+      std::vector<index_type> d_index;
+      unsigned int d_index_bits = 0;
+      index_type d_size = 0;
+      index_type d_used = 0;
+      index_type d_free = npos;
+      index_type d_oldest = npos;
+      index_type d_newest = npos;
+
+    public:
+      flat_lru_cache() = delete;
+      /**
+       * Constructs a cache with a given function and size, allocating every slot up front.
+       *
+       * @see make_flat_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       */
+      flat_lru_cache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int cache_size)
+          : flat_lru_cache(function_signature{func}, cache_size) {}
+      /**
+       * Constructs a cache with a given function and size, allocating every slot up front.
+       *
+       * @see make_flat_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       */
+      flat_lru_cache(function_signature func, unsigned int cache_size)
+          : d_func{std::move(func)}, d_max_size{cache_size} {
+        allocate(cache_size != 0 ? cache_size : initial_unbounded_slots);
+      }
+
+      /**
+       * Calls the underlying function or returns historic value.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS> RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) {
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        const std::size_t hash = std::hash<cache_key>{}(key);
+        index_type position = home_position(hash);
+        for (index_type found = d_index[position]; found != npos; found = d_index[position]) {
+          if (d_slots[found].d_hash == hash && d_slots[found].d_entry->first == key) {
+            touch(found);
+            return d_slots[found].d_entry->second;
+          }
+          position = next_position(position);
+        }
+        decayed_return_type value = std::apply(d_func, key);
+        return d_slots[insert(position, hash, std::move(key), std::move(value))].d_entry->second;
+      }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      constexpr auto max_size() const { return d_max_size; }
+
+      /** The current number of retained historic values */
+      auto size() const { return static_cast<std::size_t>(d_size); }
+
+    private:
+      void allocate(index_type slot_count) {
+        d_slots.resize(slot_count);
+        // Keep the index at most half full so probe sequences stay short.
+        d_index_bits = 1;
+        while ((std::size_t{1} << d_index_bits) < 2 * std::size_t{slot_count}) {
+          ++d_index_bits;
+        }
+        d_index.assign(std::size_t{1} << d_index_bits, npos);
+        for (index_type i = 0; i < d_used; ++i) {
+          if (!d_slots[i].d_entry) {
+            continue;
+          }
+          index_type position = home_position(d_slots[i].d_hash);
+          while (d_index[position] != npos) {
+            position = next_position(position);
+          }
+          d_index[position] = i;
+        }
+      }
+
+      index_type home_position(std::size_t hash) const {
+        // Fibonacci hashing so weak std::hash implementations do not cluster the probes.
+        return static_cast<index_type>((static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ull)
+                                       >> (64u - d_index_bits));
+      }
+
+      index_type next_position(index_type position) const {
+        return (position + 1) & static_cast<index_type>(d_index.size() - 1);
+      }
+
+      index_type insert(index_type position, std::size_t hash, cache_key&& key,
+                        decayed_return_type&& value) {
+        if (d_free == npos && d_used == d_slots.size()) {
+          if (d_max_size == 0) {
+            allocate(static_cast<index_type>(d_slots.size() * 2));
+          } else {
+            evict_oldest();
+          }
+          position = free_position(hash);
+        }
+        // The slot is only taken once its entry is built, so a throwing key or value leaves it free.
+        const bool reused = d_free != npos;
+        const index_type target = reused ? d_free : d_used;
+        slot& entry = d_slots[target];
+        entry.d_entry.emplace(std::move(key), std::move(value));
+        if (reused) {
+          d_free = entry.d_next;
+        } else {
+          ++d_used;
+        }
+        ++d_size;
+        entry.d_hash = hash;
+        d_index[position] = target;
+        link_newest(target);
+        return target;
+      }
+
+      void evict_oldest() {
+        const index_type target = d_oldest;
+        unlink(target);
+        erase_from_index(target);
+        d_slots[target].d_entry.reset();
+        d_slots[target].d_next = d_free;
+        d_free = target;
+        --d_size;
+      }
+
+      index_type free_position(std::size_t hash) const {
+        index_type position = home_position(hash);
+        while (d_index[position] != npos) {
+          position = next_position(position);
+        }
+        return position;
+      }
+
+      void erase_from_index(index_type target) {
+        index_type position = home_position(d_slots[target].d_hash);
+        while (d_index[position] != target) {
+          position = next_position(position);
+        }
+        // Backward-shift deletion keeps every remaining entry reachable from its home position.
+        const index_type mask = static_cast<index_type>(d_index.size() - 1);
+        index_type hole = position;
+        for (position = next_position(position); d_index[position] != npos;
+             position = next_position(position)) {
+          const index_type home = home_position(d_slots[d_index[position]].d_hash);
+          if (((position - home) & mask) >= ((position - hole) & mask)) {
+            d_index[hole] = d_index[position];
+            hole = position;
+          }
+        }
+        d_index[hole] = npos;
+      }
+
+      void unlink(index_type target) {
+        slot& entry = d_slots[target];
+        if (entry.d_prev != npos) {
+          d_slots[entry.d_prev].d_next = entry.d_next;
+        } else {
+          d_oldest = entry.d_next;
+        }
+        if (entry.d_next != npos) {
+          d_slots[entry.d_next].d_prev = entry.d_prev;
+        } else {
+          d_newest = entry.d_prev;
+        }
+        entry.d_prev = entry.d_next = npos;
+      }
+
+      void link_newest(index_type target) {
+        slot& entry = d_slots[target];
+        entry.d_prev = d_newest;
+        entry.d_next = npos;
+        if (d_newest != npos) {
+          d_slots[d_newest].d_next = target;
+        } else {
+          d_oldest = target;
+        }
+        d_newest = target;
+      }
+
+      void touch(index_type target) {
+        if (target != d_newest) {
+          unlink(target);
+          link_newest(target);
+        }
+      }
+    };
+
+    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_flat_lrucache(std::function<RETURN_TYPE(ARGUMENTS...)> func,
+                            unsigned int size = DEFAULT_SIZE) {
+      return flat_lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size);
+    }
+    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_flat_lrucache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int size = DEFAULT_SIZE) {
+      return flat_lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size);
+    }
+  }  // namespace functools
+
+}  // namespace hh
+#endif
@@ -1,6 +1,16 @@
 #ifndef INCLUDED_HASH_HPP
 #define INCLUDED_HASH_HPP
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <hh/key_view.hpp>
+#include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 namespace std{
     namespace
     {
@@ -51,4 +61,220 @@ namespace std{
 
     };
 }
+
+/**
+ * Pluggable hashers for cache keys.
+ *
+ * A hasher is a type whose `hash<CACHE_KEY>` member template is a functor hashing a CACHE_KEY, or a
+ * tuple of arguments which would build an equal key, to the same value, as key_hash does.
+ * combining_hasher folds std::hash through the boost-style hash_combine. wy_hasher mixes with
+ * wyhash's multiply-and-fold instead, which avalanches well even over the identity hash libstdc++
+ * uses for integers.
+ */
+namespace hh {
+  namespace functools {
+    namespace detail {
+      constexpr std::uint64_t wy_secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                              0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+      /** Multiplies two 64-bit values to 128 bits and folds the halves together. */
+      inline std::uint64_t wy_mix(std::uint64_t left, std::uint64_t right) {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+        return static_cast<std::uint64_t>(product) ^ static_cast<std::uint64_t>(product >> 64);
+#else
+        const std::uint64_t left_high = left >> 32, left_low = static_cast<std::uint32_t>(left);
+        const std::uint64_t right_high = right >> 32, right_low = static_cast<std::uint32_t>(right);
+        const std::uint64_t high_high = left_high * right_high, high_low = left_high * right_low;
+        const std::uint64_t low_high = left_low * right_high, low_low = left_low * right_low;
+        const std::uint64_t middle = (low_low >> 32) + static_cast<std::uint32_t>(high_low)
+                                     + static_cast<std::uint32_t>(low_high);
+        const std::uint64_t low = (middle << 32) | static_cast<std::uint32_t>(low_low);
+        const std::uint64_t high = high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32);
+        return low ^ high;
+#endif
+      }
+
+      inline std::uint64_t read_64(const unsigned char* bytes) {
+        std::uint64_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+      }
+
+      inline std::uint64_t read_32(const unsigned char* bytes) {
+        std::uint32_t value;
+        std::memcpy(&value, bytes, sizeof(value));
+        return value;
+      }
+
+      template <typename ELEMENT> constexpr bool is_contiguously_hashable
+          = std::is_trivially_copyable_v<ELEMENT> && std::has_unique_object_representations_v<ELEMENT>;
+
+      template <typename CACHE_KEY, std::size_t... INDICES>
+      constexpr bool is_contiguously_hashable_key(std::index_sequence<INDICES...>) {
+        return (is_contiguously_hashable<std::tuple_element_t<INDICES, CACHE_KEY>> && ...);
+      }
+
+      /** The number of 64-bit words the first elements of a key are packed into. */
+      template <typename CACHE_KEY, std::size_t... INDICES>
+      constexpr std::size_t packed_words(std::index_sequence<INDICES...>) {
+        return (std::size_t{0} + ... + ((sizeof(std::tuple_element_t<INDICES, CACHE_KEY>) + 7) / 8));
+      }
+    }  // namespace detail
+
+    /** Hashes a block of bytes in the manner of wyhash. */
+    inline std::uint64_t wyhash(const void* data, std::size_t length, std::uint64_t seed = 0) {
+      using detail::read_32;
+      using detail::read_64;
+      using detail::wy_mix;
+      using detail::wy_secret;
+      const auto* bytes = static_cast<const unsigned char*>(data);
+      seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+      std::uint64_t first = 0;
+      std::uint64_t second = 0;
+      if (length <= 16) {
+        if (length >= 4) {
+          const std::size_t offset = (length >> 3) << 2;
+          first = (read_32(bytes) << 32) | read_32(bytes + offset);
+          second = (read_32(bytes + length - 4) << 32) | read_32(bytes + length - 4 - offset);
+        } else if (length > 0) {
+          first = (std::uint64_t{bytes[0]} << 16) | (std::uint64_t{bytes[length >> 1]} << 8)
+                  | bytes[length - 1];
+        }
+      } else {
+        std::size_t remaining = length;
+        if (remaining > 48) {
+          std::uint64_t lane_one = seed;
+          std::uint64_t lane_two = seed;
+          do {
+            seed = wy_mix(read_64(bytes) ^ wy_secret[1], read_64(bytes + 8) ^ seed);
+            lane_one = wy_mix(read_64(bytes + 16) ^ wy_secret[2], read_64(bytes + 24) ^ lane_one);
+            lane_two = wy_mix(read_64(bytes + 32) ^ wy_secret[3], read_64(bytes + 40) ^ lane_two);
+            bytes += 48;
+            remaining -= 48;
+          } while (remaining > 48);
+          seed ^= lane_one ^ lane_two;
+        }
+        while (remaining > 16) {
+          seed = wy_mix(read_64(bytes) ^ wy_secret[1], read_64(bytes + 8) ^ seed);
+          bytes += 16;
+          remaining -= 16;
+        }
+        first = read_64(bytes + remaining - 16);
+        second = read_64(bytes + remaining - 8);
+      }
+      first ^= wy_secret[1];
+      second ^= seed;
+#if defined(__SIZEOF_INT128__)
+      const unsigned __int128 product = static_cast<unsigned __int128>(first) * second;
+      first = static_cast<std::uint64_t>(product);
+      second = static_cast<std::uint64_t>(product >> 64);
+#else
+      const std::uint64_t folded = wy_mix(first, second);
+      first = folded;
+      second = folded * wy_secret[0];
+#endif
+      return wy_mix(first ^ wy_secret[0] ^ length, second ^ wy_secret[1]);
+    }
+
+    /**
+     * Hashes a single key element or anything it can be compared with, as element_hash does, but
+     * with strings hashed by wyhash and every other hash passed through wyhash's mixer.
+     *
+     * @tparam ELEMENT The decayed element type stored in the key.
+     */
+    template <typename ELEMENT> struct wy_element_hash {
+      template <typename ARGUMENT> std::uint64_t operator()(const ARGUMENT& argument) const {
+        return detail::wy_mix(element_hash<ELEMENT>{}(argument) ^ detail::wy_secret[0],
+                              detail::wy_secret[1]);
+      }
+    };
+
+    template <typename CHAR, typename TRAITS, typename ALLOCATOR>
+    struct wy_element_hash<std::basic_string<CHAR, TRAITS, ALLOCATOR>> {
+      template <typename ARGUMENT> std::uint64_t operator()(const ARGUMENT& argument) const {
+        const std::basic_string_view<CHAR, TRAITS> view(argument);
+        return wyhash(view.data(), view.size() * sizeof(CHAR));
+      }
+    };
+
+    /**
+     * Hashes a cache key, or a tuple of arguments which would build an equal key, with wyhash.
+     *
+     * When every element of the key is trivially copyable with a unique object representation,
+     * such as integers, enumerations and pointers, the elements are packed into one block of 64-bit
+     * words, without the tuple's padding or its reversed layout, and the block is hashed in a
+     * single pass. Every element starts a new word, so no word is read back across two stores.
+     * Other keys hash each element with wy_element_hash and mix the results.
+     *
+     * @tparam CACHE_KEY The tuple type keying the cache.
+     */
+    template <typename CACHE_KEY> struct wy_key_hash {
+      static constexpr auto indices = std::make_index_sequence<std::tuple_size<CACHE_KEY>::value>{};
+      static constexpr bool is_contiguous = detail::is_contiguously_hashable_key<CACHE_KEY>(indices);
+
+      template <typename PROBE> std::size_t operator()(const PROBE& probe) const {
+        static_assert(std::tuple_size<PROBE>::value == std::tuple_size<CACHE_KEY>::value,
+                      "A cache must be called with one argument per key element.");
+        return static_cast<std::size_t>(hash(probe, indices));
+      }
+
+    private:
+      static constexpr std::size_t word_count = detail::packed_words<CACHE_KEY>(indices);
+
+      template <std::size_t INDEX, typename ARGUMENT>
+      static void pack(std::uint64_t* words, const ARGUMENT& argument) {
+        using element_type = std::tuple_element_t<INDEX, CACHE_KEY>;
+        const element_type element(argument);
+        constexpr std::size_t first_word
+            = detail::packed_words<CACHE_KEY>(std::make_index_sequence<INDEX>{});
+        const auto* bytes = reinterpret_cast<const unsigned char*>(&element);
+        for (std::size_t offset = 0; offset < sizeof(element_type); offset += 8) {
+          std::uint64_t word = 0;
+          std::memcpy(&word, bytes + offset, std::min<std::size_t>(8, sizeof(element_type) - offset));
+          words[first_word + offset / 8] = word;
+        }
+      }
+
+      template <typename PROBE, std::size_t... INDICES>
+      static std::uint64_t hash(const PROBE& probe, std::index_sequence<INDICES...>) {
+        using detail::wy_mix;
+        using detail::wy_secret;
+        if constexpr (is_contiguous) {
+          // Whole words are mixed two at a time as wyhash mixes 16-byte blocks, but without
+          // reading any word across two element stores.
+          std::array<std::uint64_t, word_count> words;
+          (pack<INDICES>(words.data(), std::get<INDICES>(probe)), ...);
+          std::uint64_t seed = wy_secret[0] ^ word_count;
+          std::size_t word = 0;
+          for (; word + 1 < word_count; word += 2) {
+            seed = wy_mix(words[word] ^ wy_secret[1], words[word + 1] ^ seed);
+          }
+          if (word < word_count) {
+            seed = wy_mix(words[word] ^ wy_secret[2], seed ^ wy_secret[3]);
+          }
+          return wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+        } else {
+          std::uint64_t seed = detail::wy_secret[0];
+          ((seed = detail::wy_mix(
+                seed ^ wy_element_hash<std::tuple_element_t<INDICES, CACHE_KEY>>{}(
+                           std::get<INDICES>(probe)),
+                detail::wy_secret[1])),
+           ...);
+          return seed;
+        }
+      }
+    };
+
+    /** Hashes keys by folding std::hash through the boost-style hash_combine. */
+    struct combining_hasher {
+      template <typename CACHE_KEY> using hash = key_hash<CACHE_KEY>;
+    };
+
+    /** Hashes keys with wyhash, packing trivially copyable keys into one block. */
+    struct wy_hasher {
+      template <typename CACHE_KEY> using hash = wy_key_hash<CACHE_KEY>;
+    };
+  }  // namespace functools
+}  // namespace hh
 #endif
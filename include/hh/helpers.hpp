@@ -1,9 +1,26 @@
 #ifndef INCLUDED_HH_HELPERS_H
 #define INCLUDED_HH_HELPERS_H
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <hh/executor.hpp>
+#include <hh/hash.hpp>
+#include <hh/typetraits.hpp>
+#include <stdexcept>
 #include <thread>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace hh::helpers{
     
@@ -39,6 +56,275 @@ std::function<RETURN_TYPE(ARGUMENTS...)> make_delayed(RETURN_TYPE (C::*func)(ARG
         return func(std::forward<ARGUMENTS>(args)...);
     };
 }
+
+/**
+ * Clock whose time only moves when advance() is called, for testing time dependent code without
+ * sleeping. Copies share the same time, so a test can keep one copy and hand another to the code
+ * under test.
+ */
+class manual_clock {
+public:
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<manual_clock>;
+    static constexpr bool is_steady = true;
+
+    manual_clock() : d_now{std::make_shared<std::atomic<rep>>(0)} {}
+
+    time_point now() const { return time_point{duration{d_now->load()}}; }
+
+    template <typename REP, typename PERIOD>
+    void advance(std::chrono::duration<REP, PERIOD> step) {
+        d_now->fetch_add(std::chrono::duration_cast<duration>(step).count());
+    }
+
+private:
+    std::shared_ptr<std::atomic<rep>> d_now;
+};
+
+namespace detail {
+template <typename RESULT, typename KEY> struct tuple_signature;
+template <typename RESULT, typename... ARGUMENTS>
+struct tuple_signature<RESULT, std::tuple<ARGUMENTS...>> {
+    using type = RESULT(ARGUMENTS...);
+};
+
+/** The per-call signature RESULT(ARGUMENTS...) of a bulk function taking and returning vectors. */
+template <typename BULK_SIGNATURE> struct batch_signature;
+template <typename RESULTS, typename CALLS> struct batch_signature<RESULTS(CALLS)> {
+    using type = typename tuple_signature<typename std::decay_t<RESULTS>::value_type,
+                                          typename std::decay_t<CALLS>::value_type>::type;
+};
+}
+
+template <typename SIGNATURE, typename FUNCTION,
+          typename EXECUTOR = hh::functools::thread_pool_executor>
+class batched_function;
+
+/**
+ * Gathers individual calls into calls of a bulk function, for backends which are far cheaper per
+ * item when called with many items at once.
+ *
+ * Every call returns a std::future at once and joins the pending batch. The batch is handed to the
+ * executor as one call of the bulk function when it holds max_batch_size distinct calls, or when
+ * max_wait has passed since its first call, whichever comes first; so a lone caller waits at most
+ * max_wait longer than the bulk call takes. Identical calls within a batch, compared and hashed as
+ * the caches key their arguments, are sent to the bulk function once and every caller receives
+ * the result. An exception thrown by the bulk function, or a result of the wrong length, fails
+ * the future of every call in the batch, as does the executor refusing the batch.
+ *
+ * The bulk function is called from the executor, concurrently for different batches when the
+ * executor has several threads, so it must be safe to call concurrently. Pending calls are
+ * flushed when the wrapper is destroyed.
+ *
+ * @see make_batched
+ * @see hh::functools::wy_key_hash
+ * @tparam RETURN_TYPE The result of one call.
+ * @tparam ARGUMENTS... The arguments of one call.
+ * @tparam FUNCTION The bulk function, taking a `const std::vector<std::tuple<ARGUMENTS...>>&` and
+ * returning a `std::vector<RETURN_TYPE>` with one result per call in the same order.
+ * @tparam EXECUTOR The executor the bulk function is called on.
+ */
+template <typename RETURN_TYPE, typename... ARGUMENTS, typename FUNCTION, typename EXECUTOR>
+class batched_function<RETURN_TYPE(ARGUMENTS...), FUNCTION, EXECUTOR> {
+public:
+    using result_type = std::decay_t<RETURN_TYPE>;
+    using call_type = std::tuple<std::decay_t<ARGUMENTS>...>;
+    using clock = std::chrono::steady_clock;
+
+private:
+    struct batch {
+        std::vector<call_type> d_calls;
+        std::vector<std::vector<std::promise<result_type>>> d_waiters;
+    };
+
+    struct state {
+        std::mutex d_mutex;
+        std::condition_variable d_wake;
+        batch d_pending;
+        std::unordered_map<call_type, std::size_t, hh::functools::wy_key_hash<call_type>> d_index;
+        clock::time_point d_deadline;
+        std::size_t d_batches = 0;
+        bool d_stopping = false;
+    };
+
+    std::shared_ptr<FUNCTION> d_func;
+    std::size_t d_max_batch_size;
+    clock::duration d_max_wait;
+    EXECUTOR d_executor;
+    std::unique_ptr<state> d_state;
+    std::thread d_timer;
+
+public:
+    batched_function() = delete;
+    /**
+     * @param func The bulk function.
+     * @param max_batch_size The most distinct calls in one batch, at least one.
+     * @param max_wait How long after its first call a batch is flushed however small it is.
+     * @param executor The executor the bulk function is called on.
+     */
+    batched_function(FUNCTION func, std::size_t max_batch_size, clock::duration max_wait,
+                     EXECUTOR executor = EXECUTOR{})
+        : d_func{std::make_shared<FUNCTION>(std::move(func))},
+          d_max_batch_size{std::max<std::size_t>(max_batch_size, 1)},
+          d_max_wait{max_wait},
+          d_executor{std::move(executor)},
+          d_state{std::make_unique<state>()},
+          d_timer{[this] { flush_on_deadlines(); }} {}
+
+    batched_function(const batched_function&) = delete;
+    batched_function& operator=(const batched_function&) = delete;
+
+    ~batched_function() {
+        {
+            std::lock_guard<std::mutex> lock{d_state->d_mutex};
+            d_state->d_stopping = true;
+        }
+        d_state->d_wake.notify_one();
+        d_timer.join();
+    }
+
+    /**
+     * Adds a call to the pending batch, returning the future of its result.
+     *
+     * @param args The arguments of the call, converted to call_type.
+     */
+    template <typename... INPUT_ARGUMENTS>
+    std::future<result_type> operator()(INPUT_ARGUMENTS&&... args) {
+        call_type call{std::forward<INPUT_ARGUMENTS>(args)...};
+        std::promise<result_type> promise;
+        std::future<result_type> result = promise.get_future();
+        batch full;
+        {
+            std::lock_guard<std::mutex> lock{d_state->d_mutex};
+            state& pending = *d_state;
+            const auto found = pending.d_index.find(call);
+            if (found != pending.d_index.end()) {
+                pending.d_pending.d_waiters[found->second].push_back(std::move(promise));
+                return result;
+            }
+            if (pending.d_pending.d_calls.empty()) {
+                pending.d_deadline = clock::now() + d_max_wait;
+                pending.d_wake.notify_one();
+            }
+            pending.d_index.emplace(call, pending.d_pending.d_calls.size());
+            pending.d_pending.d_calls.push_back(std::move(call));
+            pending.d_pending.d_waiters.emplace_back();
+            pending.d_pending.d_waiters.back().push_back(std::move(promise));
+            if (pending.d_pending.d_calls.size() < d_max_batch_size) {
+                return result;
+            }
+            full = take_pending();
+        }
+        submit(std::move(full));
+        return result;
+    }
+
+    /** The number of batches handed to the bulk function so far. */
+    std::size_t batches() const {
+        std::lock_guard<std::mutex> lock{d_state->d_mutex};
+        return d_state->d_batches;
+    }
+
+    std::size_t max_batch_size() const { return d_max_batch_size; }
+    clock::duration max_wait() const { return d_max_wait; }
+
+private:
+    /** Detaches the pending batch; the state's lock must be held. */
+    batch take_pending() {
+        batch taken = std::move(d_state->d_pending);
+        d_state->d_pending = batch{};
+        d_state->d_index.clear();
+        ++d_state->d_batches;
+        return taken;
+    }
+
+    /**
+     * Hands a batch to the executor. A batch the executor refuses fails the future of every call
+     * in it, so neither a caller nor the timer thread sees the executor's exception.
+     */
+    void submit(batch&& taken) {
+        std::shared_ptr<batch> shared;
+        try {
+            shared = std::make_shared<batch>(std::move(taken));
+            d_executor.execute([func = d_func, shared]() noexcept {
+                try {
+                    const std::vector<call_type>& calls = shared->d_calls;
+                    std::vector<result_type> results = (*func)(calls);
+                    if (results.size() != calls.size()) {
+                        throw std::length_error("The bulk function returned the wrong number of "
+                                                "results.");
+                    }
+                    for (std::size_t index = 0; index < results.size(); ++index) {
+                        for (auto& waiter : shared->d_waiters[index]) {
+                            waiter.set_value(results[index]);
+                        }
+                    }
+                } catch (...) {
+                    fail(*shared, std::current_exception());
+                }
+            });
+        } catch (...) {
+            fail(shared ? *shared : taken, std::current_exception());
+        }
+    }
+
+    /** Fails the calls of a batch which have no result yet, such as those after a throwing copy. */
+    static void fail(batch& failed, const std::exception_ptr& error) {
+        for (auto& waiters : failed.d_waiters) {
+            for (auto& waiter : waiters) {
+                try {
+                    waiter.set_exception(error);
+                } catch (const std::future_error&) {
+                    // Already satisfied before the batch failed.
+                }
+            }
+        }
+    }
+
+    /** Runs on the timer thread, flushing batches whose deadline passed and the last on exit. */
+    void flush_on_deadlines() {
+        std::unique_lock<std::mutex> lock{d_state->d_mutex};
+        while (true) {
+            state& pending = *d_state;
+            if (pending.d_pending.d_calls.empty()) {
+                if (pending.d_stopping) {
+                    return;
+                }
+                pending.d_wake.wait(lock);
+                continue;
+            }
+            if (!pending.d_stopping && clock::now() < pending.d_deadline) {
+                pending.d_wake.wait_until(lock, pending.d_deadline);
+                continue;
+            }
+            batch due = take_pending();
+            lock.unlock();
+            submit(std::move(due));
+            lock.lock();
+        }
+    }
+};
+
+/**
+ * Wraps a bulk function in a per-call function returning futures, gathering concurrent calls
+ * into batches.
+ *
+ * @see batched_function
+ * @param func The bulk function, taking a `const std::vector<std::tuple<ARGUMENTS...>>&` and
+ * returning a `std::vector` of one result per call.
+ * @param max_batch_size The most distinct calls in one batch.
+ * @param max_wait How long after its first call a batch is flushed however small it is.
+ * @param executor The executor the bulk function is called on.
+ */
+template <typename FUNCTION, typename EXECUTOR = hh::functools::thread_pool_executor>
+auto make_batched(FUNCTION func, std::size_t max_batch_size,
+                  std::chrono::steady_clock::duration max_wait, EXECUTOR executor = EXECUTOR{}) {
+    using signature = typename detail::batch_signature<hh::callable_signature_t<FUNCTION>>::type;
+    return batched_function<signature, FUNCTION, EXECUTOR>(std::move(func), max_batch_size,
+                                                           max_wait, std::move(executor));
+}
 }
 
 #endif
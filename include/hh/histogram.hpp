@@ -0,0 +1,140 @@
+#ifndef INCLUDED_HH_HISTOGRAM_HPP
+#define INCLUDED_HH_HISTOGRAM_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hh {
+  namespace collection {
+    namespace detail {
+      /** The index of the highest set bit of a non-zero value. */
+      inline unsigned int highest_bit(std::uint64_t value) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned int>(__builtin_clzll(value));
+#else
+        unsigned int bit = 0;
+        while (value >>= 1) {
+          ++bit;
+        }
+        return bit;
+#endif
+      }
+    }  // namespace detail
+
+    /**
+     * Histogram of non-negative integers, such as latencies in nanoseconds, in the style of an HDR
+     * histogram.
+     *
+     * Values are bucketed by their highest set bit and then linearly within each power of two, so
+     * every recorded value is known to within a relative error of 2^-PRECISION_BITS across the
+     * whole 64-bit range, in a fixed amount of memory. Counts are relaxed atomics, so values can be
+     * recorded from several threads and a snapshot taken from any thread without locking.
+     *
+     * @tparam PRECISION_BITS The number of bits of each value retained after its highest set bit.
+     */
+    template <unsigned int PRECISION_BITS = 5> class log_linear_histogram {
+      static_assert(PRECISION_BITS > 0 && PRECISION_BITS < 16,
+                    "The histogram precision must be between 1 and 15 bits.");
+
+    public:
+      static constexpr std::size_t sub_bucket_count = std::size_t{1} << PRECISION_BITS;
+      static constexpr std::size_t bucket_count = (65 - PRECISION_BITS) * sub_bucket_count;
+
+      /** A point-in-time copy of the histogram's counts. */
+      class snapshot {
+        std::vector<std::uint64_t> d_counts;
+        std::uint64_t d_count;
+
+      public:
+        explicit snapshot(std::vector<std::uint64_t> counts)
+            : d_counts{std::move(counts)}, d_count{0} {
+          for (auto count : d_counts) {
+            d_count += count;
+          }
+        }
+
+        /** The number of recorded values. */
+        std::uint64_t count() const { return d_count; }
+
+        /**
+         * The smallest bucket bound at or below which the given percentage of values fall, zero
+         * when nothing was recorded.
+         *
+         * @param percent The percentile to look up, between 0 and 100.
+         */
+        std::uint64_t percentile(double percent) const {
+          if (d_count == 0) {
+            return 0;
+          }
+          const double wanted = percent / 100.0 * static_cast<double>(d_count);
+          std::uint64_t seen = 0;
+          for (std::size_t index = 0; index < d_counts.size(); ++index) {
+            seen += d_counts[index];
+            if (d_counts[index] != 0 && static_cast<double>(seen) >= wanted) {
+              return highest_equivalent(index);
+            }
+          }
+          return max();
+        }
+
+        /** The upper bound of the highest non-empty bucket, zero when nothing was recorded. */
+        std::uint64_t max() const {
+          for (std::size_t index = d_counts.size(); index > 0; --index) {
+            if (d_counts[index - 1] != 0) {
+              return highest_equivalent(index - 1);
+            }
+          }
+          return 0;
+        }
+      };
+
+    private:
+      std::array<std::atomic<std::uint64_t>, bucket_count> d_counts{};
+
+    public:
+      log_linear_histogram() = default;
+      log_linear_histogram(const log_linear_histogram&) = delete;
+      log_linear_histogram& operator=(const log_linear_histogram&) = delete;
+
+      /** Records one occurrence of the value. */
+      void record(std::uint64_t value) {
+        d_counts[index_of(value)].fetch_add(1, std::memory_order_relaxed);
+      }
+
+      /** Copies the current counts; values recorded concurrently may or may not be included. */
+      snapshot take_snapshot() const {
+        std::vector<std::uint64_t> counts(bucket_count);
+        for (std::size_t index = 0; index < bucket_count; ++index) {
+          counts[index] = d_counts[index].load(std::memory_order_relaxed);
+        }
+        return snapshot{std::move(counts)};
+      }
+
+      /** The bucket a value is counted in. */
+      static std::size_t index_of(std::uint64_t value) {
+        if (value < sub_bucket_count) {
+          return static_cast<std::size_t>(value);
+        }
+        const unsigned int bit = detail::highest_bit(value);
+        const std::size_t bucket = bit - PRECISION_BITS + 1;
+        const std::size_t sub_bucket
+            = static_cast<std::size_t>(value >> (bit - PRECISION_BITS)) - sub_bucket_count;
+        return bucket * sub_bucket_count + sub_bucket;
+      }
+
+      /** The largest value counted in the same bucket as the value at the given index. */
+      static std::uint64_t highest_equivalent(std::size_t index) {
+        if (index < sub_bucket_count) {
+          return index;
+        }
+        const std::size_t bucket = index / sub_bucket_count;
+        const std::uint64_t sub_bucket = index % sub_bucket_count + sub_bucket_count;
+        return ((sub_bucket + 1) << (bucket - 1)) - 1;
+      }
+    };
+  }  // namespace collection
+}  // namespace hh
+
+#endif
@@ -0,0 +1,162 @@
+#ifndef INCLUDED_HH_KEY_VIEW_HPP
+#define INCLUDED_HH_KEY_VIEW_HPP
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Heterogeneous lookup of cache keys.
+ *
+ * Caches key their entries on a tuple of decayed arguments, which for arguments such as strings
+ * means building the tuple copies and allocates. A key_view stands in for a key in the cache's
+ * index instead: either a stored key owned by the cache, or a probe referring to the arguments of
+ * a call. Probes hash and compare the arguments as they were passed, so a hit never builds the
+ * owning key. This gives C++17 caches the transparent lookup unordered_map only gains in C++20.
+ */
+namespace hh {
+  namespace functools {
+
+    /**
+     * Hashes a single key element or anything it can be compared with, agreeing between the two.
+     * Strings are hashed through their string_view so string_view and character pointer arguments
+     * hash without being converted; other arguments are converted to the element type first
+     * unless they already are one.
+     *
+     * @tparam ELEMENT The decayed element type stored in the key.
+     */
+    template <typename ELEMENT> struct element_hash {
+      template <typename ARGUMENT> std::size_t operator()(const ARGUMENT& argument) const {
+        if constexpr (std::is_same_v<ARGUMENT, ELEMENT>) {
+          return std::hash<ELEMENT>{}(argument);
+        } else {
+          return std::hash<ELEMENT>{}(ELEMENT(argument));
+        }
+      }
+    };
+
+    template <typename CHAR, typename TRAITS, typename ALLOCATOR>
+    struct element_hash<std::basic_string<CHAR, TRAITS, ALLOCATOR>> {
+      template <typename ARGUMENT> std::size_t operator()(const ARGUMENT& argument) const {
+        return std::hash<std::basic_string_view<CHAR, TRAITS>>{}(
+            std::basic_string_view<CHAR, TRAITS>(argument));
+      }
+    };
+
+    namespace detail {
+      template <typename LEFT, typename RIGHT, typename = void> struct is_equality_comparable
+          : std::false_type {};
+      template <typename LEFT, typename RIGHT> struct is_equality_comparable<
+          LEFT, RIGHT, std::void_t<decltype(std::declval<const LEFT&>() == std::declval<const RIGHT&>())>>
+          : std::true_type {};
+
+      template <typename ELEMENT, typename ARGUMENT>
+      bool element_equal(const ELEMENT& element, const ARGUMENT& argument) {
+        // Arithmetic arguments are converted so they compare as the key they would build.
+        if constexpr (!std::is_arithmetic_v<ELEMENT>
+                      && is_equality_comparable<ELEMENT, ARGUMENT>::value) {
+          return element == argument;
+        } else {
+          return element == ELEMENT(argument);
+        }
+      }
+
+      inline void hash_combine(std::size_t& seed, std::size_t hash) {
+        seed ^= hash + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+      }
+
+      template <typename CACHE_KEY, typename PROBE, std::size_t... INDICES>
+      std::size_t hash_key(const PROBE& probe, std::index_sequence<INDICES...>) {
+        std::size_t seed = 0;
+        (hash_combine(seed, element_hash<std::tuple_element_t<INDICES, CACHE_KEY>>{}(
+                                std::get<INDICES>(probe))),
+         ...);
+        return seed;
+      }
+
+      template <typename CACHE_KEY, typename PROBE, std::size_t... INDICES>
+      bool key_equal(const CACHE_KEY& key, const PROBE& probe, std::index_sequence<INDICES...>) {
+        return (element_equal(std::get<INDICES>(key), std::get<INDICES>(probe)) && ...);
+      }
+    }  // namespace detail
+
+    /**
+     * Hashes a cache key, or a tuple of arguments which would build an equal key, to the same
+     * value.
+     *
+     * @tparam CACHE_KEY The tuple type keying the cache.
+     */
+    template <typename CACHE_KEY> struct key_hash {
+      template <typename PROBE> std::size_t operator()(const PROBE& probe) const {
+        static_assert(std::tuple_size<PROBE>::value == std::tuple_size<CACHE_KEY>::value,
+                      "A cache must be called with one argument per key element.");
+        return detail::hash_key<CACHE_KEY>(
+            probe, std::make_index_sequence<std::tuple_size<CACHE_KEY>::value>{});
+      }
+    };
+
+    /**
+     * Non-owning reference to either a stored cache key or the arguments of a call, together with
+     * their hash.
+     *
+     * @tparam CACHE_KEY The tuple type keying the cache.
+     * @tparam KEY_HASH The functor hashing keys and probes alike.
+     */
+    template <typename CACHE_KEY, typename KEY_HASH = key_hash<CACHE_KEY>> class key_view {
+      std::size_t d_hash;
+      const CACHE_KEY* d_key;
+      const void* d_probe;
+      bool (*d_matches)(const void*, const CACHE_KEY&);
+
+      key_view(std::size_t hash, const CACHE_KEY* key, const void* probe,
+               bool (*matches)(const void*, const CACHE_KEY&))
+          : d_hash{hash}, d_key{key}, d_probe{probe}, d_matches{matches} {}
+
+    public:
+      /** Views a key owned by the cache, which must outlive the view. */
+      static key_view stored(const CACHE_KEY& key) {
+        return stored(key, KEY_HASH{}(key));
+      }
+
+      /** Views a key owned by the cache whose hash is already known. */
+      static key_view stored(const CACHE_KEY& key, std::size_t hash) {
+        return key_view{hash, &key, nullptr, nullptr};
+      }
+
+      /** Views the arguments of a call, as a tuple of references which must outlive the view. */
+      template <typename PROBE> static key_view probe(const PROBE& probe) {
+        return key_view{KEY_HASH{}(probe), nullptr, &probe,
+                        [](const void* erased, const CACHE_KEY& key) {
+                          return detail::key_equal(
+                              key, *static_cast<const PROBE*>(erased),
+                              std::make_index_sequence<std::tuple_size<CACHE_KEY>::value>{});
+                        }};
+      }
+
+      std::size_t hash() const { return d_hash; }
+
+      friend bool operator==(const key_view& left, const key_view& right) {
+        if (left.d_key == nullptr) {
+          return right.d_key != nullptr && left.d_matches(left.d_probe, *right.d_key);
+        }
+        if (right.d_key == nullptr) {
+          return right.d_matches(right.d_probe, *left.d_key);
+        }
+        return left.d_key == right.d_key || *left.d_key == *right.d_key;
+      }
+    };
+
+    /** Hash functor returning the precomputed hash of a key_view. */
+    struct key_view_hash {
+      template <typename CACHE_KEY, typename KEY_HASH>
+      std::size_t operator()(const key_view<CACHE_KEY, KEY_HASH>& view) const {
+        return view.hash();
+      }
+    };
+  }  // namespace functools
+}  // namespace hh
+
+#endif
@@ -1,19 +1,53 @@
 #ifndef INCLUDED_HH_LRU_CACHE_HPP
 #define INCLUDED_HH_LRU_CACHE_HPP
+#include <algorithm>
+#include <cstddef>
 #include <experimental/iterator>
 #include <functional>
+#include <hh/cache_metrics.hpp>
+#include <hh/eviction_policy.hpp>
 #include <hh/hash.hpp>
+#include <hh/key_view.hpp>
 #include <hh/optional.hpp>
-#include <list>
+#include <hh/typetraits.hpp>
+#include <hh/weigher.hpp>
+#include <memory>
 #include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
 #include <tl/expected.hpp>
 #include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace hh {
   namespace functools {
+    namespace detail {
+      /** Hints that the memory at the address is about to be read. */
+      inline void prefetch(const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address);
+#else
+        (void)address;
+#endif
+      }
+
+      /**
+       * The snapshot functions behind lru_cache::save() and lru_cache::load(), defined by
+       * snapshot.hpp so that caches which are never persisted do not pull in file and mapping
+       * headers. DEFER is always void; it only delays the lookup until save() or load() is used.
+       */
+      template <typename DEFER> struct snapshot_io;
+    }  // namespace detail
+
+    template <typename SIGNATURE, typename EVICTION_POLICY = lru_eviction,
+              typename WEIGHER = unit_weigher, typename METRICS = no_metrics,
+              typename HASHER = wy_hasher, typename FUNCTION = std::function<SIGNATURE>,
+              typename ALLOCATOR = std::allocator<std::byte>>
+    class basic_lru_cache;
 
     /**
      * Functional-style lru-cache which either calls the function from cache or returns a previouly
@@ -27,12 +61,60 @@ namespace hh {
      * used to call the function, for this reason all types in the argument list for the underlying
      * function must implement the std::hash<T> specialisation and all for equality comparison.
      *
+     * Which entry is dropped once the cache is full is decided by the eviction policy, strict LRU
+     * by default. Scan-resistant policies such as segmented_lru_eviction, arc_eviction and
+     * wtinylfu_eviction can be selected through basic_lru_cache.
+     *
+     * The cache can also be bounded by weight, for example the bytes its entries hold. Every entry
+     * is weighed on insertion and entries are evicted, in the policy's order, until the total
+     * weight is back within the budget. An entry heavier than the whole budget is kept until the
+     * next insertion displaces it. The policies size their segments in entries, so under a weight
+     * budget alone the scan-resistant policies retain their eviction order but not their segment
+     * proportions.
+     *
+     * Hits, misses, insertions, evictions and the latency of the underlying function are reported
+     * through the metrics policy and read back with stats(). The default policy records nothing
+     * and costs nothing; atomic_metrics counts everything cheaply enough for production use.
+     *
+     * Argument tuples are hashed by the hasher, wyhash by default, which spreads keys such as small
+     * integers evenly over the index where the boost-style hash_combine clusters them.
+     *
+     * The underlying function is stored as its own callable type, so a miss calls it directly and
+     * a small function inlines into the cache. make_lrucache and class template argument deduction
+     * pick that type from the function pointer, lambda, functor or member function pointer they are
+     * given. Naming the signature alone, as lru_cache does, or passing a std::function opts in to
+     * type erasure instead.
+     *
+     * Every call returns the cached value by copy. For large values shared_lru_cache stores and
+     * returns a value_handle instead, which a hit copies in constant time.
+     *
+     * The entries and the index are allocated with the allocator, rebound to each node type, so
+     * a cache under churn can recycle its nodes from a pool_allocator or a std::pmr resource
+     * instead of the global heap.
+     *
      * @see std::hash()
+     * @see hash.hpp
      * @see make_lrucache
+     * @see make_weighted_lrucache
+     * @see eviction_policy.hpp
+     * @see weigher.hpp
+     * @see cache_metrics.hpp
+     * @see shared_lru_cache
+     * @see pool_allocator.hpp
      * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
-     * @tparams ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam EVICTION_POLICY The policy deciding which entries are dropped when the cache is full.
+     * @tparam WEIGHER The callable weighing each entry against the weight budget.
+     * @tparam METRICS The policy recording the cache's hits, misses and load latencies.
+     * @tparam HASHER The hasher of argument tuples.
+     * @tparam FUNCTION The type of the stored underlying function.
+     * @tparam ALLOCATOR The allocator of the entries and the index.
      */
-    template <typename RETURN_TYPE, typename... ARGUMENTS> class lru_cache {
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename EVICTION_POLICY,
+              typename WEIGHER, typename METRICS, typename HASHER, typename FUNCTION,
+              typename ALLOCATOR>
+    class basic_lru_cache<RETURN_TYPE(ARGUMENTS...), EVICTION_POLICY, WEIGHER, METRICS, HASHER,
+                          FUNCTION, ALLOCATOR> {
     public:
       static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
       using return_type = RETURN_TYPE; /** The return type of this cache.*/
@@ -47,13 +129,29 @@ namespace hh {
                       decayed_return_type>; /** The entry in the cache implementation. The decayed
                                                type is used to prevent naught reference tricks. */
       using function_signature = std::function<RETURN_TYPE(ARGUMENTS...)>;
+      using function_type = FUNCTION;
+      using allocator_type = ALLOCATOR;
+      using policy_type = typename EVICTION_POLICY::template policy<
+          cache_entry, detail::rebind_alloc<ALLOCATOR, cache_entry>>;
+      using weigher_type = WEIGHER;
+      using metrics_type = METRICS;
+      using key_hash_type = typename HASHER::template hash<cache_key>;
+      using key_view_type = key_view<cache_key, key_hash_type>;
+      using cache_map = std::unordered_map<
+          key_view_type, typename policy_type::handle, key_view_hash, std::equal_to<key_view_type>,
+          detail::rebind_alloc<ALLOCATOR,
+                               std::pair<const key_view_type, typename policy_type::handle>>>;
 
-      function_signature d_func;
+      mutable FUNCTION d_func;
       unsigned int d_max_size;
-      mutable std::list<cache_entry> d_cache;
-      mutable std::unordered_map<cache_key, typename decltype(d_cache)::iterator> d_cache_map;
+      std::size_t d_max_weight;
+      WEIGHER d_weigher;
+      mutable std::size_t d_weight;
+      mutable policy_type d_cache;
+      mutable cache_map d_cache_map;
+      mutable METRICS d_metrics;
 
-      lru_cache() = delete;
+      basic_lru_cache() = delete;
       /**
        * Constructs a cache with a given function and size.
        *
@@ -61,18 +159,38 @@ namespace hh {
        * @param func The underlying function which will be used to populate the cache on call.
        * @param cache_size The maximum size of the underlying cache.
        */
-      constexpr lru_cache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int cache_size)
-          : d_func{func}, d_max_size{cache_size}, d_cache{}, d_cache_map{cache_size} {}
+      constexpr basic_lru_cache(FUNCTION func, unsigned int cache_size)
+          : basic_lru_cache(std::move(func), cache_size, 0) {}
       /**
-       * Constructs a cache with a given function and size.
+       * Constructs a cache with a given function and size, allocating with the allocator.
        *
-       * @see make_lrucache()
        * @param func The underlying function which will be used to populate the cache on call.
        * @param cache_size The maximum size of the underlying cache.
+       * @param allocator The allocator of the entries and the index.
        */
-      constexpr lru_cache(function_signature func, unsigned int cache_size)
-          : d_func{func}, d_max_size{cache_size}, d_cache{}, d_cache_map{cache_size} {}
-      virtual ~lru_cache() = default;
+      basic_lru_cache(FUNCTION func, unsigned int cache_size, const ALLOCATOR& allocator)
+          : basic_lru_cache(std::move(func), cache_size, 0, WEIGHER{}, allocator) {}
+      /**
+       * Constructs a cache with a given function, size and weight budget.
+       *
+       * @see make_weighted_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum number of entries, zero for no limit besides the weight.
+       * @param max_weight The maximum total weight of the entries, zero for no limit.
+       * @param weigher The callable used to weigh each entry.
+       * @param allocator The allocator of the entries and the index.
+       */
+      basic_lru_cache(FUNCTION func, unsigned int cache_size, std::size_t max_weight,
+                      WEIGHER weigher = WEIGHER{}, const ALLOCATOR& allocator = ALLOCATOR{})
+          : d_func{std::move(func)},
+            d_max_size{cache_size},
+            d_max_weight{max_weight},
+            d_weigher{std::move(weigher)},
+            d_weight{0},
+            d_cache{cache_size, detail::rebind_alloc<ALLOCATOR, cache_entry>{allocator}},
+            d_cache_map{cache_size, typename cache_map::allocator_type{allocator}},
+            d_metrics{} {}
+      virtual ~basic_lru_cache() = default;
 
       /**
        * Calls the underlying function or returns historic value.
@@ -80,9 +198,12 @@ namespace hh {
        * Will first check to see if the tuple has been calculated previously, to do this is requires
        * us to hash the arguments and call an equality of cache keys. This can have performance
        * implications for functions which have very long argument lists where this operation is more
-       * expensive than calling the underlying function.
+       * expensive than calling the underlying function. The arguments are hashed and compared as
+       * they are passed, so a hit with a std::string_view or character pointer for a std::string
+       * parameter neither copies nor allocates; the cache key is only built on a miss.
        *
-       * @see lru_cache()
+       * @see basic_lru_cache()
+       * @see key_view
        * @tparam INPUT_ARGUMENTS A collection of arguments which should be convertibale to the
        * cachekey of the underlying. A static assertion checks this property.
        * @params args The arguments to call the function with, arguments are perfectly forwarded to
@@ -90,26 +211,214 @@ namespace hh {
        * converting arguments as required.
        */
       template <typename... INPUT_ARGUMENTS> RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) {
-        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
-        get_entry_from_cache(key)
-            .map([this](const auto& entry_it) { d_cache.splice(d_cache.end(), d_cache, entry_it); })
-            .map_error(
-                [this, &key](...) { put_in_cache(std::move(key), std::apply(d_func, key)); });
-        return d_cache.back().second;
+        const auto probe = std::forward_as_tuple(args...);
+        const auto lookup = key_view_type::probe(probe);
+        const auto entry_it
+            = get_entry_from_cache(lookup)
+                  .map([this](const auto& found_it) {
+                    d_cache.touch(found_it);
+                    d_metrics.hit();
+                    return found_it;
+                  })
+                  .or_else([this, &lookup, &args...](...) {
+                    d_metrics.miss();
+                    cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+                    return put_in_cache(std::move(key), compute(key), lookup.hash());
+                  });
+        return policy_type::entry(*entry_it).second;
+      }
+
+      /**
+       * Resolves a batch of calls, writing one result per call to the output in order.
+       *
+       * Every call is hashed and its bucket prefetched before any of them are looked up, so the
+       * cache misses of a large batch overlap instead of being paid one probe at a time. Calls
+       * which are not cached are computed together after every lookup, each distinct key once,
+       * and only inserted once every result has been written, so a batch larger than the cache
+       * cannot evict its own hits.
+       *
+       * @see operator()()
+       * @param calls A range of tuples, each holding the arguments of one call. The range must
+       * yield references to tuples which outlive the call.
+       * @param out The output iterator receiving the results.
+       * @return The output iterator past the last result.
+       */
+      template <typename CALLS, typename OUTPUT_ITERATOR>
+      OUTPUT_ITERATOR get_many(const CALLS& calls, OUTPUT_ITERATOR out) {
+        return resolve_many(calls, out, [this](const std::vector<cache_key>& missing) {
+          std::vector<decayed_return_type> values;
+          values.reserve(missing.size());
+          for (const auto& key : missing) {
+            values.push_back(compute(key));
+          }
+          return values;
+        });
+      }
+
+      /**
+       * Resolves a batch of calls as get_many(calls, out), handing the keys which are not cached
+       * to the bulk loader in a single call instead of calling the underlying function for each.
+       *
+       * @param calls A range of tuples, each holding the arguments of one call. The range must
+       * yield references to tuples which outlive the call.
+       * @param out The output iterator receiving the results.
+       * @param loader Callable taking a `const std::vector<cache_key>&` of distinct missing keys and
+       * returning a `std::vector<decayed_return_type>` of their values in the same order. Each
+       * call of the loader is recorded as a single load by the metrics policy.
+       * @return The output iterator past the last result.
+       */
+      template <typename CALLS, typename OUTPUT_ITERATOR, typename BULK_LOADER>
+      OUTPUT_ITERATOR get_many(const CALLS& calls, OUTPUT_ITERATOR out, BULK_LOADER&& loader) {
+        return resolve_many(calls, out, [this, &loader](const std::vector<cache_key>& missing) {
+          return d_metrics.load([&loader, &missing] { return loader(missing); });
+        });
       }
 
       /** The maximum number of entries this cache can store. If 0 an infinite number of values can
        * be stored. */
       constexpr auto max_size() const { return d_max_size; }
 
+      /** The maximum total weight of the retained values. If 0 only max_size() bounds the cache. */
+      constexpr auto max_weight() const { return d_max_weight; }
+
       /** The current number of retained historic values */
       auto size() const { return d_cache_map.size(); }
 
+      /** The total weight of the retained historic values as measured by the weigher. */
+      auto weight() const { return d_weight; }
+
+      /** A snapshot of the metrics recorded by the metrics policy, empty if it records nothing. */
+      cache_stats stats() const { return d_metrics.stats(); }
+
+      /**
+       * Writes the cached entries to a binary snapshot file, least recently used first, so a new
+       * process can warm-start from them with load(). Requires including hh/snapshot.hpp.
+       *
+       * @see snapshot.hpp
+       * @param path The file to write, replaced if it exists.
+       */
+      template <typename DEFER = void> void save(const std::string& path) const {
+        using io = detail::snapshot_io<DEFER>;
+        io::template save<cache_key, decayed_return_type>(path, size(), [this](auto&& visit) {
+          d_cache.for_each([&visit](const cache_entry& entry) { visit(entry.first, entry.second); });
+        });
+      }
+
+      /**
+       * Inserts the entries of a snapshot written by save(), in the order they were saved, so the
+       * most recently used entries stay most recent. Entries already cached are kept and touched
+       * instead, and a snapshot larger than the cache leaves only its most recent entries. The
+       * underlying function is not called. Requires including hh/snapshot.hpp.
+       *
+       * @see snapshot.hpp
+       * @param path The snapshot file to read.
+       */
+      template <typename DEFER = void> void load(const std::string& path) {
+        using io = detail::snapshot_io<DEFER>;
+        io::template load<cache_key, decayed_return_type>(
+            path, [this](cache_key&& key, decayed_return_type&& value) {
+              const auto lookup = key_view_type::stored(key);
+              auto found = get_entry_from_cache(lookup);
+              if (found) {
+                d_cache.touch(*found);
+              } else {
+                put_in_cache(std::move(key), std::move(value), lookup.hash());
+              }
+            });
+      }
+
     private:
-      struct unexpected_tag {};
+      /** How many lookups ahead of the current one get_many prefetches. */
+      static constexpr std::size_t prefetch_distance = 16;
+
+      struct batch_slot {
+        hh::optional<typename policy_type::handle> d_hit;
+        std::size_t d_missing;
+      };
+
+      template <typename CALLS, typename OUTPUT_ITERATOR, typename BULK_LOADER>
+      OUTPUT_ITERATOR resolve_many(const CALLS& calls, OUTPUT_ITERATOR out, BULK_LOADER&& loader) {
+        std::vector<key_view_type> lookups;
+        for (const auto& call : calls) {
+          lookups.push_back(key_view_type::probe(call));
+        }
+        for (std::size_t i = 0; i < std::min(lookups.size(), prefetch_distance); ++i) {
+          prefetch_bucket(lookups[i]);
+        }
+
+        std::vector<batch_slot> slots;
+        slots.reserve(lookups.size());
+        std::vector<cache_key> missing;
+        std::vector<std::size_t> missing_hashes;
+        // Reserved so the views of missing keys stay valid while they are deduplicated.
+        missing.reserve(lookups.size());
+        std::unordered_map<key_view_type, std::size_t, key_view_hash> missing_index;
+        auto call_it = std::begin(calls);
+        for (std::size_t i = 0; i < lookups.size(); ++i) {
+          if (i + prefetch_distance < lookups.size()) {
+            prefetch_bucket(lookups[i + prefetch_distance]);
+          }
+          const key_view_type& lookup = lookups[i];
+          auto found = get_entry_from_cache(lookup);
+          if (found) {
+            d_metrics.hit();
+            slots.push_back(batch_slot{*found, 0});
+          } else {
+            d_metrics.miss();
+            auto known = missing_index.find(lookup);
+            if (known == missing_index.end()) {
+              missing.push_back(std::apply(
+                  [](const auto&... arguments) { return cache_key{arguments...}; }, *call_it));
+              missing_hashes.push_back(lookup.hash());
+              known = missing_index
+                          .emplace(key_view_type::stored(missing.back(), lookup.hash()),
+                                   missing.size() - 1)
+                          .first;
+            }
+            slots.push_back(batch_slot{hh::nullopt, known->second});
+          }
+          ++call_it;
+        }
 
-      hh::optional<typename decltype(d_cache)::iterator> get_entry_from_cache(
-          const cache_key& key) const {
+        std::vector<decayed_return_type> loaded;
+        if (!missing.empty()) {
+          loaded = loader(static_cast<const std::vector<cache_key>&>(missing));
+          if (loaded.size() != missing.size()) {
+            throw std::length_error("get_many bulk loader returned the wrong number of values.");
+          }
+        }
+        for (std::size_t i = 0; i < slots.size(); ++i) {
+          if (i + prefetch_distance < slots.size() && slots[i + prefetch_distance].d_hit) {
+            detail::prefetch(&policy_type::entry(*slots[i + prefetch_distance].d_hit));
+          }
+          const batch_slot& slot = slots[i];
+          if (slot.d_hit) {
+            d_cache.touch(*slot.d_hit);
+            *out++ = policy_type::entry(*slot.d_hit).second;
+          } else {
+            *out++ = loaded[slot.d_missing];
+          }
+        }
+        for (std::size_t i = 0; i < missing.size(); ++i) {
+          put_in_cache(std::move(missing[i]), std::move(loaded[i]), missing_hashes[i]);
+        }
+        return out;
+      }
+
+      decayed_return_type compute(const cache_key& key) const {
+        return d_metrics.load([this, &key] { return std::apply(d_func, key); });
+      }
+
+      void prefetch_bucket(const key_view_type& lookup) const {
+        const auto bucket = d_cache_map.bucket(lookup);
+        const auto node = d_cache_map.begin(bucket);
+        if (node != d_cache_map.end(bucket)) {
+          detail::prefetch(&*node);
+        }
+      }
+
+      hh::optional<typename policy_type::handle> get_entry_from_cache(
+          const key_view_type& key) const {
         auto found_it = d_cache_map.find(key);
         if (found_it == d_cache_map.end()) {
           return hh::nullopt;
@@ -117,30 +426,179 @@ namespace hh {
         return found_it->second;
       }
 
-      template <typename... ARGS>
-      tl::expected<void, unexpected_tag> put_in_cache(cache_key&& key,
-                                                      decayed_return_type&& return_value) const {
-        d_cache.emplace_back(std::move(key), std::move(return_value));
-        d_cache_map[key] = std::prev(d_cache.end());
-        if (max_size() != 0 && size() > max_size()) {
-          d_cache_map.erase(d_cache.front().first);
-          d_cache.pop_front();
+      hh::optional<typename policy_type::handle> put_in_cache(
+          cache_key&& key, decayed_return_type&& return_value, std::size_t hash) const {
+        const auto evict = [this](const cache_entry& evicted) {
+          d_metrics.evicted();
+          d_weight -= d_weigher(evicted.first, evicted.second);
+          d_cache_map.erase(key_view_type::stored(evicted.first));
+        };
+        d_metrics.inserted();
+        d_weight += d_weigher(key, return_value);
+        auto entry_it
+            = d_cache.insert(cache_entry{std::move(key), std::move(return_value)}, hash, evict);
+        d_cache_map.emplace(key_view_type::stored(policy_type::entry(entry_it).first, hash),
+                            entry_it);
+        // The new entry is kept even when it alone exceeds the budget, so it can be returned.
+        while (d_max_weight != 0 && d_weight > d_max_weight && size() > 1) {
+          d_cache.evict_one(entry_it, evict);
         }
-        return {};
+        return entry_it;
       }
     };
 
+    /**
+     * The strict LRU cache, keyed on a parameter pack.
+     *
+     * @see basic_lru_cache
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using lru_cache
+        = basic_lru_cache<RETURN_TYPE(ARGUMENTS...)>;
+
     constexpr static auto DEFAULT_SIZE = 128u;
 
-    template <typename RETURN_TYPE, typename... ARGUMENTS>
-    constexpr auto make_lrucache(std::function<RETURN_TYPE(ARGUMENTS...)> func,
-                                 unsigned int size = DEFAULT_SIZE) {
-      return lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size);
+    template <typename FUNCTION> basic_lru_cache(FUNCTION, unsigned int)
+        -> basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, unit_weigher, no_metrics,
+                           wy_hasher, FUNCTION>;
+    template <typename FUNCTION> basic_lru_cache(FUNCTION, unsigned int, std::size_t)
+        -> basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, unit_weigher, no_metrics,
+                           wy_hasher, FUNCTION>;
+    template <typename FUNCTION, typename WEIGHER>
+    basic_lru_cache(FUNCTION, unsigned int, std::size_t, WEIGHER)
+        -> basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, WEIGHER, no_metrics,
+                           wy_hasher, FUNCTION>;
+
+    /**
+     * Makes a strict LRU cache of the function, stored as its own type.
+     *
+     * @param func A function pointer, lambda, functor or member function pointer, or a
+     * std::function to opt in to type erasure.
+     * @param size The maximum size of the cache.
+     */
+    template <typename FUNCTION>
+    constexpr auto make_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      return basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, unit_weigher,
+                             no_metrics, wy_hasher, FUNCTION>(std::move(func), size);
+    }
+    /**
+     * Makes a strict LRU cache of the function allocating its entries with the allocator.
+     *
+     * @see pool_allocator.hpp
+     * @param func A function pointer, lambda, functor or member function pointer.
+     * @param size The maximum size of the cache.
+     * @param allocator The allocator, such as a pool_allocator or a
+     * std::pmr::polymorphic_allocator, rebound to the cache's nodes.
+     */
+    template <typename FUNCTION, typename ALLOCATOR>
+    auto make_lrucache(FUNCTION func, unsigned int size, const ALLOCATOR& allocator) {
+      return basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, unit_weigher,
+                             no_metrics, wy_hasher, FUNCTION, ALLOCATOR>(std::move(func), size,
+                                                                         allocator);
+    }
+    template <typename EVICTION_POLICY, typename FUNCTION>
+    constexpr auto make_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      return basic_lru_cache<callable_signature_t<FUNCTION>, EVICTION_POLICY, unit_weigher,
+                             no_metrics, wy_hasher, FUNCTION>(std::move(func), size);
+    }
+
+    /**
+     * The strict LRU cache bounded by the estimated bytes its entries hold.
+     *
+     * @see basic_lru_cache
+     * @see default_weigher
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using weighted_lru_cache
+        = basic_lru_cache<RETURN_TYPE(ARGUMENTS...), lru_eviction, default_weigher>;
+
+    template <typename FUNCTION, typename WEIGHER = default_weigher>
+    auto make_weighted_lrucache(FUNCTION func, std::size_t max_weight,
+                                WEIGHER weigher = WEIGHER{}) {
+      return basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, WEIGHER, no_metrics,
+                             wy_hasher, FUNCTION>(std::move(func), 0, max_weight,
+                                                  std::move(weigher));
+    }
+
+    /**
+     * The strict LRU cache recording its hits, misses, evictions and load latencies.
+     *
+     * @see basic_lru_cache
+     * @see atomic_metrics
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using instrumented_lru_cache
+        = basic_lru_cache<RETURN_TYPE(ARGUMENTS...), lru_eviction, unit_weigher, atomic_metrics>;
+
+    template <typename FUNCTION>
+    auto make_instrumented_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      return basic_lru_cache<callable_signature_t<FUNCTION>, lru_eviction, unit_weigher,
+                             atomic_metrics, wy_hasher, FUNCTION>(std::move(func), size);
+    }
+
+    /**
+     * A handle to a cached value, sharing its ownership with the cache. Copying a handle costs an
+     * atomic increment however large the value, and a handle keeps the value alive after the
+     * entry holding it is evicted. The value is const, as every caller shares it.
+     */
+    template <typename VALUE> using value_handle = std::shared_ptr<const VALUE>;
+
+    namespace detail {
+      /** Calls the function and moves its result into a value the cache and its handles share. */
+      template <typename FUNCTION> struct share_result {
+        FUNCTION d_func;
+
+        /** Converts from anything the function can be made from, as the function itself would. */
+        template <typename FROM,
+                  typename = std::enable_if_t<!std::is_same_v<std::decay_t<FROM>, share_result>>>
+        share_result(FROM&& func) : d_func(std::forward<FROM>(func)) {}
+
+        template <typename... ARGUMENTS> auto operator()(ARGUMENTS&&... args) {
+          using value = std::decay_t<std::invoke_result_t<FUNCTION&, ARGUMENTS...>>;
+          return std::make_shared<const value>(
+              std::invoke(d_func, std::forward<ARGUMENTS>(args)...));
+        }
+      };
+
+      template <typename SIGNATURE> struct shared_signature;
+      template <typename RETURN_TYPE, typename... ARGUMENTS>
+      struct shared_signature<RETURN_TYPE(ARGUMENTS...)> {
+        using type = value_handle<std::decay_t<RETURN_TYPE>>(ARGUMENTS...);
+      };
+    }  // namespace detail
+
+    /**
+     * The strict LRU cache returning a value_handle to each result instead of a copy of it, for
+     * functions returning large values such as long strings or vectors, where copying the value
+     * out on every hit costs more than the lookup.
+     *
+     * @see basic_lru_cache
+     * @see value_handle
+     * @see make_shared_lrucache
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using shared_lru_cache
+        = basic_lru_cache<value_handle<std::decay_t<RETURN_TYPE>>(ARGUMENTS...), lru_eviction,
+                          unit_weigher, no_metrics, wy_hasher,
+                          detail::share_result<std::function<RETURN_TYPE(ARGUMENTS...)>>>;
+
+    /**
+     * Makes a cache of the function which returns a value_handle to each result, stored as its
+     * own type.
+     *
+     * @param func A function pointer, lambda, functor or member function pointer, or a
+     * std::function to opt in to type erasure.
+     * @param size The maximum size of the cache.
+     */
+    template <typename FUNCTION>
+    auto make_shared_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      using signature = typename detail::shared_signature<callable_signature_t<FUNCTION>>::type;
+      return basic_lru_cache<signature, lru_eviction, unit_weigher, no_metrics, wy_hasher,
+                             detail::share_result<FUNCTION>>(
+          detail::share_result<FUNCTION>{std::move(func)}, size);
     }
-    template <typename RETURN_TYPE, typename... ARGUMENTS>
-    constexpr auto make_lrucache(RETURN_TYPE (*func)(ARGUMENTS...),
-                                 unsigned int size = DEFAULT_SIZE) {
-      return lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size);
+    template <typename EVICTION_POLICY, typename FUNCTION>
+    auto make_shared_lrucache(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      using signature = typename detail::shared_signature<callable_signature_t<FUNCTION>>::type;
+      return basic_lru_cache<signature, EVICTION_POLICY, unit_weigher, no_metrics, wy_hasher,
+                             detail::share_result<FUNCTION>>(
+          detail::share_result<FUNCTION>{std::move(func)}, size);
     }
 
     template <class Ch, class Tr, class Tuple, std::size_t... Is> void print_tuple_impl(
@@ -170,15 +628,23 @@ namespace hh {
      * @see make_lrucache()
      * @param os The output strem to stream the cache into.
      * @param cache The cache to output to the given stream.
-     * @tparam RETURN_TYPE The return type of the cache.
-     * @tparam ARGUMENTS... The arguments that are used to construct the cache keys.
+     * @tparam SIGNATURE The signature of the cached function.
+     * @tparam EVICTION_POLICY The eviction policy of the cache.
+     * @tparam WEIGHER The weigher of the cache.
+     * @tparam METRICS The metrics policy of the cache.
+     * @tparam HASHER The hasher of the cache.
+     * @tparam FUNCTION The stored function type of the cache.
+     * @tparam ALLOCATOR The allocator of the cache.
      */
-    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    template <typename SIGNATURE, typename EVICTION_POLICY, typename WEIGHER, typename METRICS,
+              typename HASHER, typename FUNCTION, typename ALLOCATOR>
     inline std::ostream& operator<<(std::ostream& os,
-                                    const lru_cache<RETURN_TYPE, ARGUMENTS...>& cache) {
+                                    const basic_lru_cache<SIGNATURE, EVICTION_POLICY, WEIGHER,
+                                                          METRICS, HASHER, FUNCTION, ALLOCATOR>&
+                                        cache) {
       os << "lru_cache<" << cache.size() << "/" << cache.max_size() << ">[ ";
-      std::copy(cache.d_cache.begin(), cache.d_cache.end(),
-                std::experimental::make_ostream_joiner(os, ", "));
+      auto joiner = std::experimental::make_ostream_joiner(os, ", ");
+      cache.d_cache.for_each([&joiner](const auto& entry) { *joiner++ = entry; });
       os << " ]";
       return os;
     }
@@ -0,0 +1,190 @@
+#ifndef INCLUDED_HH_MEMOIZE_HPP
+#define INCLUDED_HH_MEMOIZE_HPP
+#include <algorithm>
+#include <cstddef>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+/**
+ * Memoization of recursive functions.
+ *
+ * make_lrucache wraps a function from the outside, so the calls a recursive function makes to
+ * itself bypass the cache. The caches here instead call the function with a reference to the cache
+ * as its first argument, which it calls for every subproblem:
+ *
+ *     auto fibonacci = memoize_recursive<std::uint64_t(int)>([](auto& self, int n) {
+ *       return n < 2 ? std::uint64_t(n) : self(n - 1) + self(n - 2);
+ *     });
+ *
+ * Every call returns its value by copy, taken from the cache before any other entry is inserted,
+ * so values stay valid however many entries the nested calls insert or evict.
+ */
+namespace hh {
+  namespace functools {
+
+    template <typename SIGNATURE, typename FUNCTION> class recursive_lru_cache;
+    template <typename SIGNATURE, typename FUNCTION> class recursive_memo;
+
+    /**
+     * Strict LRU cache of a recursive function, whose self-calls go through the cache.
+     *
+     * The function is called as func(self, args...) on a miss, self being this cache. Nested misses
+     * may evict any entry, including ones the outer calls will need again, so a cache smaller than
+     * the live subproblems recomputes some of them, but never returns a wrong or dangling value.
+     *
+     * @see memoize_recursive
+     * @see lru_cache
+     * @tparam RETURN_TYPE The return type of the function, returned by value.
+     * @tparam ARGUMENTS... Paramter Pack of the types of the function's arguments after self.
+     * @tparam FUNCTION The type of the stored recursive function.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename FUNCTION>
+    class recursive_lru_cache<RETURN_TYPE(ARGUMENTS...), FUNCTION> {
+    public:
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+
+    private:
+      /** Calls the recursive function on a miss, handing it the cache. */
+      struct recursion {
+        recursive_lru_cache* d_owner;
+
+        decayed_return_type operator()(const std::decay_t<ARGUMENTS>&... args) const {
+          return d_owner->d_func(*d_owner, args...);
+        }
+      };
+
+      using cache_type = basic_lru_cache<decayed_return_type(ARGUMENTS...), lru_eviction,
+                                         unit_weigher, no_metrics, wy_hasher, recursion>;
+
+      FUNCTION d_func;
+      cache_type d_cache;
+
+    public:
+      recursive_lru_cache() = delete;
+      /**
+       * @param func The recursive function, called as func(self, args...).
+       * @param cache_size The maximum size of the cache, zero for no limit.
+       */
+      recursive_lru_cache(FUNCTION func, unsigned int cache_size)
+          : d_func{std::move(func)}, d_cache{recursion{this}, cache_size} {}
+      recursive_lru_cache(const recursive_lru_cache&) = delete;
+      recursive_lru_cache& operator=(const recursive_lru_cache&) = delete;
+
+      /**
+       * Returns the historic value for the arguments, or calls the function to compute it.
+       *
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS>
+      decayed_return_type operator()(INPUT_ARGUMENTS&&... args) {
+        return d_cache(std::forward<INPUT_ARGUMENTS>(args)...);
+      }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      auto max_size() const { return d_cache.max_size(); }
+
+      /** The current number of retained historic values */
+      auto size() const { return d_cache.size(); }
+    };
+
+    /**
+     * Unbounded memo table of a recursive function, whose self-calls go through the table.
+     *
+     * Nothing is ever evicted, so each distinct set of arguments is computed once. The table and
+     * its entries are carved from a buffer sized for the expected number of keys when the table is
+     * constructed, so a computation staying within that key space neither allocates nor rehashes;
+     * beyond it the buffer grows geometrically.
+     *
+     * @see memoize_recursive_unbounded
+     * @tparam RETURN_TYPE The return type of the function, returned by value.
+     * @tparam ARGUMENTS... Paramter Pack of the types of the function's arguments after self.
+     * @tparam FUNCTION The type of the stored recursive function.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename FUNCTION>
+    class recursive_memo<RETURN_TYPE(ARGUMENTS...), FUNCTION> {
+    public:
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+
+    private:
+      using table_type = std::pmr::unordered_map<cache_key, decayed_return_type,
+                                                 wy_key_hash<cache_key>>;
+
+      /** A node holds the entry, the next pointer and the cached hash, and a bucket one pointer. */
+      static constexpr std::size_t bytes_per_key
+          = sizeof(typename table_type::value_type) + 2 * sizeof(void*) + 2 * sizeof(std::size_t);
+
+      FUNCTION d_func;
+      std::pmr::monotonic_buffer_resource d_memory;
+      table_type d_values;
+
+    public:
+      recursive_memo() = delete;
+      /**
+       * @param func The recursive function, called as func(self, args...).
+       * @param expected_keys The number of distinct arguments the table is preallocated for.
+       */
+      recursive_memo(FUNCTION func, std::size_t expected_keys)
+          : d_func{std::move(func)},
+            d_memory{std::max<std::size_t>(expected_keys, 1) * bytes_per_key},
+            d_values{&d_memory} {
+        d_values.reserve(expected_keys);
+      }
+      recursive_memo(const recursive_memo&) = delete;
+      recursive_memo& operator=(const recursive_memo&) = delete;
+
+      /**
+       * Returns the memoized value for the arguments, or calls the function to compute it.
+       *
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS>
+      decayed_return_type operator()(INPUT_ARGUMENTS&&... args) {
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        const auto found = d_values.find(key);
+        if (found != d_values.end()) {
+          return found->second;
+        }
+        // Computed before inserting, so nested calls never see a partly built entry.
+        decayed_return_type value = std::apply(
+            [this](const auto&... arguments) { return d_func(*this, arguments...); }, key);
+        return d_values.emplace(std::move(key), std::move(value)).first->second;
+      }
+
+      /** The number of memoized values. */
+      std::size_t size() const { return d_values.size(); }
+    };
+
+    /**
+     * Memoizes a recursive function in a strict LRU cache.
+     *
+     * @tparam SIGNATURE The signature of the function without self, as RETURN_TYPE(ARGUMENTS...).
+     * @param func The recursive function, called as func(self, args...).
+     * @param size The maximum size of the cache, zero for no limit.
+     */
+    template <typename SIGNATURE, typename FUNCTION>
+    auto memoize_recursive(FUNCTION func, unsigned int size = DEFAULT_SIZE) {
+      return recursive_lru_cache<SIGNATURE, FUNCTION>(std::move(func), size);
+    }
+
+    /**
+     * Memoizes a recursive function in an unbounded table preallocated for a known key space.
+     *
+     * @tparam SIGNATURE The signature of the function without self, as RETURN_TYPE(ARGUMENTS...).
+     * @param func The recursive function, called as func(self, args...).
+     * @param expected_keys The number of distinct arguments the table is preallocated for.
+     */
+    template <typename SIGNATURE, typename FUNCTION>
+    auto memoize_recursive_unbounded(FUNCTION func, std::size_t expected_keys) {
+      return recursive_memo<SIGNATURE, FUNCTION>(std::move(func), expected_keys);
+    }
+  }  // namespace functools
+}  // namespace hh
+#endif
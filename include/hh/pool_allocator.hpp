@@ -0,0 +1,214 @@
+#ifndef INCLUDED_HH_POOL_ALLOCATOR_HPP
+#define INCLUDED_HH_POOL_ALLOCATOR_HPP
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+/**
+ * Allocators for the nodes of the caches and counters.
+ *
+ * Every cache and counter taking an ALLOCATOR template parameter rebinds it to each node type it
+ * stores, so any standard allocator works, including std::pmr::polymorphic_allocator over a
+ * std::pmr::unsynchronized_pool_resource or monotonic_buffer_resource passed to the constructor.
+ * pool_allocator is a ready-made allocator for fixed-size nodes which needs no resource.
+ */
+namespace hh {
+  namespace functools {
+    namespace detail {
+      /**
+       * Free lists of the nodes of one thread, one list per size class.
+       *
+       * Nodes are carved from large chunks and, once freed, kept on the freeing thread's list for
+       * reuse. A node may be freed on another thread than the one which carved it, so chunks are
+       * never returned to the system; a thread's free lists pass to a shared depot when it exits,
+       * and the next thread to start adopts them. A thread's pool is destroyed before the
+       * thread_local objects constructed ahead of it and, on the main thread, before static
+       * objects, so from then on the thread takes nodes from and frees them to the depot directly.
+       */
+      class node_pool {
+      public:
+        static constexpr std::size_t granularity = alignof(std::max_align_t);
+        static constexpr std::size_t max_node_size = 512;
+
+      private:
+        static constexpr std::size_t class_count = max_node_size / granularity;
+        static constexpr std::size_t chunk_size = 64 * 1024;
+
+        struct free_node {
+          free_node* d_next;
+        };
+
+        using free_lists = std::array<free_node*, class_count>;
+
+        struct depot {
+          std::mutex d_mutex;
+          free_lists d_free{};
+        };
+
+        free_lists d_free{};
+        char* d_cursor = nullptr;
+        std::size_t d_remaining = 0;
+
+        static depot& shared_depot() {
+          // Never destroyed, so threads exiting during static destruction can still return nodes.
+          static depot* const instance = new depot{};
+          return *instance;
+        }
+
+        static std::size_t size_class(std::size_t bytes) { return (bytes - 1) / granularity; }
+
+        /** Whether the calling thread's pool was destroyed. Trivial, so it outlives the pool. */
+        static bool& destroyed() {
+          thread_local bool flag = false;
+          return flag;
+        }
+
+        /** The pool of the calling thread. */
+        static node_pool& local() {
+          thread_local node_pool pool;
+          return pool;
+        }
+
+      public:
+        node_pool() {
+          depot& shared = shared_depot();
+          std::lock_guard<std::mutex> lock{shared.d_mutex};
+          d_free = shared.d_free;
+          shared.d_free.fill(nullptr);
+        }
+
+        node_pool(const node_pool&) = delete;
+        node_pool& operator=(const node_pool&) = delete;
+
+        ~node_pool() {
+          destroyed() = true;
+          depot& shared = shared_depot();
+          std::lock_guard<std::mutex> lock{shared.d_mutex};
+          for (std::size_t index = 0; index < class_count; ++index) {
+            if (d_free[index] == nullptr) {
+              continue;
+            }
+            free_node* last = d_free[index];
+            while (last->d_next != nullptr) {
+              last = last->d_next;
+            }
+            last->d_next = shared.d_free[index];
+            shared.d_free[index] = d_free[index];
+          }
+        }
+
+        /** A node of at least the given size, which must be at most max_node_size. */
+        static void* acquire(std::size_t bytes) {
+          if (!destroyed()) {
+            return local().allocate(bytes);
+          }
+          depot& shared = shared_depot();
+          {
+            std::lock_guard<std::mutex> lock{shared.d_mutex};
+            free_node*& head = shared.d_free[size_class(bytes)];
+            if (head != nullptr) {
+              free_node* node = head;
+              head = node->d_next;
+              return node;
+            }
+          }
+          return ::operator new((size_class(bytes) + 1) * granularity);
+        }
+
+        /** Frees a node acquired with the same size, on this or any other thread. */
+        static void release(void* node, std::size_t bytes) {
+          if (!destroyed()) {
+            local().deallocate(node, bytes);
+            return;
+          }
+          depot& shared = shared_depot();
+          std::lock_guard<std::mutex> lock{shared.d_mutex};
+          free_node*& head = shared.d_free[size_class(bytes)];
+          head = ::new (node) free_node{head};
+        }
+
+      private:
+        void* allocate(std::size_t bytes) {
+          free_node*& head = d_free[size_class(bytes)];
+          if (head != nullptr) {
+            free_node* node = head;
+            head = node->d_next;
+            return node;
+          }
+          const std::size_t rounded = (size_class(bytes) + 1) * granularity;
+          if (d_remaining < rounded) {
+            // The rest of the old chunk is too small for this class and is left unused.
+            d_cursor = static_cast<char*>(::operator new(chunk_size));
+            d_remaining = chunk_size;
+          }
+          void* node = d_cursor;
+          d_cursor += rounded;
+          d_remaining -= rounded;
+          return node;
+        }
+
+        void deallocate(void* node, std::size_t bytes) {
+          free_node*& head = d_free[size_class(bytes)];
+          head = ::new (node) free_node{head};
+        }
+      };
+    }  // namespace detail
+
+    /**
+     * Allocator serving single nodes from a pool local to the calling thread.
+     *
+     * Node-based containers allocate one node at a time, so under churn a cache frees and
+     * reallocates nodes of the same few sizes. Serving those from per-thread free lists turns each
+     * allocation into a pointer pop, without locking, and keeps the nodes of a cache packed into a
+     * few large chunks instead of spread over the heap. Arrays, such as hash table buckets, and
+     * nodes larger or more aligned than the pool serves go to the global operator new. Memory a
+     * pool has carved is reused but never returned to the system, so the pool holds on to the
+     * peak number of nodes in use.
+     *
+     * A node joins the free list of the thread which frees it, not of the one which allocated it,
+     * and stays there until that thread exits. When one thread allocates the nodes another frees,
+     * as with a cache filled by a producer and emptied by a consumer, the freed nodes pile up on
+     * the consumer's lists while the producer keeps carving new chunks, so memory grows with the
+     * number of nodes passed between them.
+     *
+     * @tparam VALUE The type allocated.
+     */
+    template <typename VALUE> class pool_allocator {
+      static constexpr bool is_pooled = sizeof(VALUE) <= detail::node_pool::max_node_size
+                                        && alignof(VALUE) <= detail::node_pool::granularity;
+
+    public:
+      using value_type = VALUE;
+      using is_always_equal = std::true_type;
+
+      pool_allocator() noexcept = default;
+      template <typename OTHER> pool_allocator(const pool_allocator<OTHER>&) noexcept {}
+
+      VALUE* allocate(std::size_t count) {
+        if (is_pooled && count == 1) {
+          return static_cast<VALUE*>(detail::node_pool::acquire(sizeof(VALUE)));
+        }
+        return std::allocator<VALUE>{}.allocate(count);
+      }
+
+      void deallocate(VALUE* pointer, std::size_t count) noexcept {
+        if (is_pooled && count == 1) {
+          detail::node_pool::release(pointer, sizeof(VALUE));
+          return;
+        }
+        std::allocator<VALUE>{}.deallocate(pointer, count);
+      }
+
+      template <typename OTHER> bool operator==(const pool_allocator<OTHER>&) const noexcept {
+        return true;
+      }
+      template <typename OTHER> bool operator!=(const pool_allocator<OTHER>&) const noexcept {
+        return false;
+      }
+    };
+  }  // namespace functools
+}  // namespace hh
+#endif
@@ -0,0 +1,595 @@
+#ifndef INCLUDED_HH_RAND_HPP
+#define INCLUDED_HH_RAND_HPP
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+/**
+ * Fast random number generators and the key distributions of cache workloads.
+ *
+ * The generators satisfy UniformRandomBitGenerator, so they also drive the standard
+ * distributions, but hold a few words of state against the 2.5KB of std::mt19937 and produce a
+ * value in a handful of instructions. Each can be split into independent streams for threads.
+ * The distributions draw a key in constant time however many keys there are, for generating
+ * traces at the rate a cache serves them.
+ */
+namespace hh {
+  namespace rand {
+    namespace detail {
+      template <typename T> struct dependent_false : std::false_type {};
+
+      constexpr std::uint64_t rotl(std::uint64_t value, int shift) {
+        return (value << shift) | (value >> (64 - shift));
+      }
+
+      /** The high word of the 128 bit product, setting low to the low word. */
+      inline std::uint64_t multiply_high(std::uint64_t left, std::uint64_t right,
+                                         std::uint64_t& low) {
+#if defined(__SIZEOF_INT128__)
+        const unsigned __int128 product = static_cast<unsigned __int128>(left) * right;
+        low = static_cast<std::uint64_t>(product);
+        return static_cast<std::uint64_t>(product >> 64);
+#else
+        const std::uint64_t left_low = left & 0xffffffffu;
+        const std::uint64_t left_high = left >> 32;
+        const std::uint64_t right_low = right & 0xffffffffu;
+        const std::uint64_t right_high = right >> 32;
+        const std::uint64_t low_low = left_low * right_low;
+        const std::uint64_t high_low = left_high * right_low;
+        const std::uint64_t low_high = left_low * right_high;
+        const std::uint64_t middle = (low_low >> 32) + (high_low & 0xffffffffu) + low_high;
+        low = left * right;
+        return left_high * right_high + (high_low >> 32) + (middle >> 32);
+#endif
+      }
+    }  // namespace detail
+
+    /**
+     * SplitMix64, a generator of one word of state which turns any seed, zero included, into
+     * well mixed words. Used to seed the other generators.
+     */
+    class splitmix64 {
+      std::uint64_t d_state;
+
+    public:
+      using result_type = std::uint64_t;
+
+      explicit constexpr splitmix64(std::uint64_t seed) : d_state{seed} {}
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      constexpr result_type operator()() {
+        std::uint64_t mixed = (d_state += 0x9e3779b97f4a7c15ull);
+        mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+        mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+        return mixed ^ (mixed >> 31);
+      }
+    };
+
+    /**
+     * xoshiro256**, Blackman and Vigna's all-purpose 64 bit generator of 256 bits of state.
+     *
+     * jump() advances the generator by 2^128 values and long_jump() by 2^192, so streams taken by
+     * split() never overlap in practice: the parent keeps drawing where the child's stream ends.
+     *
+     * @see xoshiro256ss_lanes
+     */
+    class xoshiro256ss {
+    public:
+      using result_type = std::uint64_t;
+      using state_type = std::array<std::uint64_t, 4>;
+
+    private:
+      state_type d_state;
+
+      void jump_by(const state_type& polynomial) {
+        state_type jumped{};
+        for (const std::uint64_t word : polynomial) {
+          for (int bit = 0; bit < 64; ++bit) {
+            if (word & (std::uint64_t{1} << bit)) {
+              for (std::size_t index = 0; index < jumped.size(); ++index) {
+                jumped[index] ^= d_state[index];
+              }
+            }
+            (*this)();
+          }
+        }
+        d_state = jumped;
+      }
+
+    public:
+      /** @param seed Any seed, expanded to the full state by splitmix64. */
+      explicit xoshiro256ss(std::uint64_t seed = 0) {
+        splitmix64 seeder{seed};
+        for (auto& word : d_state) {
+          word = seeder();
+        }
+      }
+
+      /** @param state The full state, which must not be all zero. */
+      explicit constexpr xoshiro256ss(const state_type& state) : d_state{state} {}
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      constexpr result_type operator()() {
+        const std::uint64_t result = detail::rotl(d_state[1] * 5, 7) * 9;
+        const std::uint64_t shifted = d_state[1] << 17;
+        d_state[2] ^= d_state[0];
+        d_state[3] ^= d_state[1];
+        d_state[1] ^= d_state[2];
+        d_state[0] ^= d_state[3];
+        d_state[2] ^= shifted;
+        d_state[3] = detail::rotl(d_state[3], 45);
+        return result;
+      }
+
+      /** Writes the next values to [first, last), the same values as calling the generator. */
+      template <typename OUTPUT_ITERATOR> void fill(OUTPUT_ITERATOR first, OUTPUT_ITERATOR last) {
+        for (; first != last; ++first) {
+          *first = (*this)();
+        }
+      }
+
+      /** Advances the generator by count values. */
+      constexpr void discard(unsigned long long count) {
+        for (; count > 0; --count) {
+          (*this)();
+        }
+      }
+
+      /** Advances the generator by 2^128 values. */
+      void jump() {
+        jump_by({0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull,
+                 0x39abdc4529b1661cull});
+      }
+
+      /** Advances the generator by 2^192 values. */
+      void long_jump() {
+        jump_by({0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull, 0x77710069854ee241ull,
+                 0x39109bb02acbe635ull});
+      }
+
+      /** A generator continuing this one's stream, this one jumping 2^128 values ahead. */
+      xoshiro256ss split() {
+        xoshiro256ss child{*this};
+        jump();
+        return child;
+      }
+
+      const state_type& state() const { return d_state; }
+
+      friend bool operator==(const xoshiro256ss& left, const xoshiro256ss& right) {
+        return left.d_state == right.d_state;
+      }
+      friend bool operator!=(const xoshiro256ss& left, const xoshiro256ss& right) {
+        return !(left == right);
+      }
+    };
+
+    /**
+     * LANES xoshiro256** generators stepped together, for filling buffers.
+     *
+     * The states are stored lane by lane, so stepping every lane is the same few shifts, xors and
+     * multiplications by constants over each array, which the compiler turns into vector
+     * instructions. Lane i starts i jumps after the seed's xoshiro256** stream, so the lanes never
+     * overlap, and values are produced round-robin over the lanes: the first value of every lane,
+     * then the second of every lane, and so on.
+     *
+     * @tparam LANES The number of interleaved generators.
+     */
+    template <std::size_t LANES = 4> class xoshiro256ss_lanes {
+      static_assert(LANES > 0, "At least one lane is needed.");
+
+    public:
+      using result_type = std::uint64_t;
+
+    private:
+      alignas(64) std::array<std::uint64_t, LANES> d_s0;
+      alignas(64) std::array<std::uint64_t, LANES> d_s1;
+      alignas(64) std::array<std::uint64_t, LANES> d_s2;
+      alignas(64) std::array<std::uint64_t, LANES> d_s3;
+      std::array<std::uint64_t, LANES> d_buffer;
+      std::size_t d_next = LANES;
+
+      /** Writes the next value of every lane to out. */
+      void step(std::uint64_t* out) {
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+          out[lane] = detail::rotl(d_s1[lane] * 5, 7) * 9;
+          const std::uint64_t shifted = d_s1[lane] << 17;
+          d_s2[lane] ^= d_s0[lane];
+          d_s3[lane] ^= d_s1[lane];
+          d_s1[lane] ^= d_s2[lane];
+          d_s0[lane] ^= d_s3[lane];
+          d_s2[lane] ^= shifted;
+          d_s3[lane] = detail::rotl(d_s3[lane], 45);
+        }
+      }
+
+    public:
+      /** @param seed Any seed, expanded as xoshiro256ss expands it. */
+      explicit xoshiro256ss_lanes(std::uint64_t seed = 0)
+          : xoshiro256ss_lanes(xoshiro256ss{seed}) {}
+
+      /** @param base The generator whose stream the first lane continues. */
+      explicit xoshiro256ss_lanes(xoshiro256ss base) {
+        for (std::size_t lane = 0; lane < LANES; ++lane) {
+          d_s0[lane] = base.state()[0];
+          d_s1[lane] = base.state()[1];
+          d_s2[lane] = base.state()[2];
+          d_s3[lane] = base.state()[3];
+          base.jump();
+        }
+      }
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      result_type operator()() {
+        if (d_next == LANES) {
+          step(d_buffer.data());
+          d_next = 0;
+        }
+        return d_buffer[d_next++];
+      }
+
+      /** Writes the next values to [first, last), the same values as calling the generator. */
+      void fill(std::uint64_t* first, std::uint64_t* last) {
+        while (first != last && d_next != LANES) {
+          *first++ = d_buffer[d_next++];
+        }
+        for (; static_cast<std::size_t>(last - first) >= LANES; first += LANES) {
+          step(first);
+        }
+        while (first != last) {
+          *first++ = (*this)();
+        }
+      }
+    };
+
+    /**
+     * PCG32, O'Neill's permuted congruential generator of 32 bit values from 64 bits of state,
+     * the XSH-RR variant.
+     *
+     * Every odd increment selects a different stream, and advance() jumps any distance in
+     * logarithmic time, so streams can be both separated and skipped ahead.
+     */
+    class pcg32 {
+      static constexpr std::uint64_t multiplier = 6364136223846793005ull;
+
+      std::uint64_t d_state;
+      std::uint64_t d_increment;
+
+    public:
+      using result_type = std::uint32_t;
+
+      /**
+       * @param seed The starting point within the stream.
+       * @param stream The stream, any value selecting a distinct sequence.
+       */
+      explicit constexpr pcg32(std::uint64_t seed = 0x853c49e6748fea9bull,
+                               std::uint64_t stream = 0xda3e39cb94b95bdbull)
+          : d_state{0}, d_increment{(stream << 1) | 1} {
+        (*this)();
+        d_state += seed;
+        (*this)();
+      }
+
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+      constexpr result_type operator()() {
+        const std::uint64_t old = d_state;
+        d_state = old * multiplier + d_increment;
+        const auto shifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+        const auto rotation = static_cast<std::uint32_t>(old >> 59);
+        return (shifted >> rotation) | (shifted << ((32 - rotation) & 31));
+      }
+
+      /** Writes the next values to [first, last), the same values as calling the generator. */
+      template <typename OUTPUT_ITERATOR> void fill(OUTPUT_ITERATOR first, OUTPUT_ITERATOR last) {
+        for (; first != last; ++first) {
+          *first = (*this)();
+        }
+      }
+
+      /** Advances the generator by count values, in time logarithmic in count. */
+      constexpr void advance(std::uint64_t count) {
+        std::uint64_t step_multiplier = multiplier;
+        std::uint64_t step_increment = d_increment;
+        std::uint64_t total_multiplier = 1;
+        std::uint64_t total_increment = 0;
+        for (; count > 0; count >>= 1) {
+          if (count & 1) {
+            total_multiplier *= step_multiplier;
+            total_increment = total_increment * step_multiplier + step_increment;
+          }
+          step_increment = (step_multiplier + 1) * step_increment;
+          step_multiplier *= step_multiplier;
+        }
+        d_state = total_multiplier * d_state + total_increment;
+      }
+
+      constexpr void discard(unsigned long long count) { advance(count); }
+
+      /** A generator on a stream chosen by this one's next values. */
+      pcg32 split() {
+        const std::uint64_t seed = (std::uint64_t{(*this)()} << 32) | (*this)();
+        const std::uint64_t stream = (std::uint64_t{(*this)()} << 32) | (*this)();
+        return pcg32{seed, stream};
+      }
+
+      friend bool operator==(const pcg32& left, const pcg32& right) {
+        return left.d_state == right.d_state && left.d_increment == right.d_increment;
+      }
+      friend bool operator!=(const pcg32& left, const pcg32& right) { return !(left == right); }
+    };
+
+    /** The next 64 random bits of a generator of 32 or 64 bit values. */
+    template <typename GENERATOR> std::uint64_t next_word(GENERATOR& generator) {
+      constexpr auto range = GENERATOR::max() - GENERATOR::min();
+      if constexpr (range == std::numeric_limits<std::uint64_t>::max()) {
+        return static_cast<std::uint64_t>(generator() - GENERATOR::min());
+      } else if constexpr (range == std::numeric_limits<std::uint32_t>::max()) {
+        const auto high = static_cast<std::uint64_t>(generator() - GENERATOR::min());
+        return (high << 32) | static_cast<std::uint64_t>(generator() - GENERATOR::min());
+      } else {
+        static_assert(detail::dependent_false<GENERATOR>::value,
+                      "Generators must produce every 32 or 64 bit value.");
+      }
+    }
+
+    /**
+     * A uniform integer in [0, bound), using Lemire's multiply and shift which only divides in
+     * the rare case that the value must be redrawn to stay unbiased.
+     */
+    template <typename GENERATOR>
+    std::uint64_t uniform_below(GENERATOR& generator, std::uint64_t bound) {
+      std::uint64_t low;
+      std::uint64_t high = detail::multiply_high(next_word(generator), bound, low);
+      if (low < bound) {
+        const std::uint64_t threshold = (0 - bound) % bound;
+        while (low < threshold) {
+          high = detail::multiply_high(next_word(generator), bound, low);
+        }
+      }
+      return high;
+    }
+
+    /** A uniform double in [0, 1) with 53 random bits. */
+    template <typename GENERATOR> double uniform_unit(GENERATOR& generator) {
+      return static_cast<double>(next_word(generator) >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * Zipf distribution over the keys [0, keys), key k drawn with probability proportional to
+     * 1 / (k + 1)^exponent.
+     *
+     * Samples by Hörmann and Derflinger's rejection-inversion, which inverts the integral of a
+     * continuous hat over the key density and accepts more than nine draws in ten. Construction and
+     * every sample take constant time and memory whatever the number of keys, unlike inverting
+     * the cumulative distribution, which needs a table of every key.
+     */
+    class zipf_distribution {
+    public:
+      using result_type = std::uint64_t;
+
+    private:
+      std::uint64_t d_keys;
+      double d_exponent;
+      double d_integral_first;
+      double d_integral_last;
+      double d_squeeze;
+
+      /** (e^x - 1) / x, accurate near zero. */
+      static double expm1_ratio(double x) {
+        return std::abs(x) > 1e-8 ? std::expm1(x) / x : 1.0 + x / 2.0 * (1.0 + x / 3.0);
+      }
+
+      /** ln(1 + x) / x, accurate near zero. */
+      static double log1p_ratio(double x) {
+        return std::abs(x) > 1e-8 ? std::log1p(x) / x : 1.0 - x * (0.5 - x / 3.0);
+      }
+
+      double density(double x) const { return std::exp(-d_exponent * std::log(x)); }
+
+      double integral(double x) const {
+        const double log_x = std::log(x);
+        return expm1_ratio((1.0 - d_exponent) * log_x) * log_x;
+      }
+
+      double inverse_integral(double x) const {
+        const double scaled = std::max(x * (1.0 - d_exponent), -1.0);
+        return std::exp(log1p_ratio(scaled) * x);
+      }
+
+    public:
+      zipf_distribution() = delete;
+      /**
+       * @param keys The number of keys, at least one.
+       * @param exponent The skew, greater than zero. Cache traces are typically between 0.6 and
+       * 1.2.
+       */
+      zipf_distribution(std::uint64_t keys, double exponent)
+          : d_keys{std::max<std::uint64_t>(keys, 1)},
+            d_exponent{exponent},
+            d_integral_first{integral(1.5) - 1.0},
+            d_integral_last{integral(static_cast<double>(d_keys) + 0.5)},
+            d_squeeze{2.0 - inverse_integral(integral(2.5) - density(2.0))} {}
+
+      result_type min() const { return 0; }
+      result_type max() const { return d_keys - 1; }
+      std::uint64_t keys() const { return d_keys; }
+      double exponent() const { return d_exponent; }
+
+      template <typename GENERATOR> result_type operator()(GENERATOR& generator) const {
+        while (true) {
+          const double u = d_integral_last
+                           + uniform_unit(generator) * (d_integral_first - d_integral_last);
+          const double x = inverse_integral(u);
+          const double rank = std::clamp(std::floor(x + 0.5), 1.0, static_cast<double>(d_keys));
+          if (rank - x <= d_squeeze || u >= integral(rank + 0.5) - density(rank)) {
+            return static_cast<result_type>(rank) - 1;
+          }
+        }
+      }
+
+      /** Writes a sample to every element of [first, last). */
+      template <typename GENERATOR, typename OUTPUT_ITERATOR>
+      void fill(GENERATOR& generator, OUTPUT_ITERATOR first, OUTPUT_ITERATOR last) const {
+        for (; first != last; ++first) {
+          *first = (*this)(generator);
+        }
+      }
+    };
+
+    /**
+     * A seeded bijection of [0, size), spreading neighbouring values over the whole range.
+     *
+     * Alternates multiplications by odd constants and xor-shifts, each a bijection of the
+     * smallest power of two range holding size, and walks the cycle until the value falls back
+     * within size, which takes fewer than two rounds on average.
+     */
+    class permutation {
+      std::uint64_t d_size;
+      std::uint64_t d_mask;
+      int d_shift;
+      std::uint64_t d_key;
+
+      std::uint64_t round(std::uint64_t value) const {
+        value = ((value ^ d_key) * 0x9e3779b97f4a7c15ull) & d_mask;
+        value ^= value >> d_shift;
+        value = (value * 0xbf58476d1ce4e5b9ull) & d_mask;
+        return value ^ (value >> d_shift);
+      }
+
+    public:
+      permutation() = delete;
+      /**
+       * @param size The size of the permuted range, at least one.
+       * @param seed The seed selecting the permutation.
+       */
+      permutation(std::uint64_t size, std::uint64_t seed)
+          : d_size{std::max<std::uint64_t>(size, 1)}, d_mask{0}, d_shift{1}, d_key{0} {
+        int bits = 0;
+        while (bits < 64 && (std::uint64_t{1} << bits) < d_size) {
+          ++bits;
+        }
+        d_mask = bits == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+        d_shift = std::max(bits / 2, 1);
+        d_key = splitmix64{seed}() & d_mask;
+      }
+
+      std::uint64_t size() const { return d_size; }
+
+      /** The image of a value in [0, size()). */
+      std::uint64_t operator()(std::uint64_t value) const {
+        do {
+          value = round(value);
+        } while (value >= d_size);
+        return value;
+      }
+    };
+
+    /**
+     * Zipf distribution whose popular keys are scattered over the key space instead of being the
+     * smallest keys, as in YCSB, so the hottest keys do not share hash buckets, shards or pages.
+     * The popularity of each key is that of zipf_distribution, permuted by a seeded bijection.
+     */
+    class scrambled_zipf_distribution {
+      zipf_distribution d_zipf;
+      permutation d_permutation;
+
+    public:
+      using result_type = std::uint64_t;
+
+      scrambled_zipf_distribution() = delete;
+      /**
+       * @param keys The number of keys, at least one.
+       * @param exponent The skew, greater than zero.
+       * @param seed The seed selecting where each popularity rank lands.
+       */
+      scrambled_zipf_distribution(std::uint64_t keys, double exponent, std::uint64_t seed = 0)
+          : d_zipf{keys, exponent}, d_permutation{d_zipf.keys(), seed} {}
+
+      result_type min() const { return 0; }
+      result_type max() const { return d_zipf.max(); }
+      std::uint64_t keys() const { return d_zipf.keys(); }
+      double exponent() const { return d_zipf.exponent(); }
+
+      /** The key drawn with the given popularity rank, zero being the most popular. */
+      std::uint64_t key_of_rank(std::uint64_t rank) const { return d_permutation(rank); }
+
+      template <typename GENERATOR> result_type operator()(GENERATOR& generator) const {
+        return d_permutation(d_zipf(generator));
+      }
+
+      /** Writes a sample to every element of [first, last). */
+      template <typename GENERATOR, typename OUTPUT_ITERATOR>
+      void fill(GENERATOR& generator, OUTPUT_ITERATOR first, OUTPUT_ITERATOR last) const {
+        for (; first != last; ++first) {
+          *first = (*this)(generator);
+        }
+      }
+    };
+
+    /**
+     * Hot-set distribution: a fraction of the keys, the smallest ones, receives a fixed share of
+     * the draws, uniformly among themselves, and the remaining keys share the rest uniformly.
+     * Models a working set, such as the 20% of keys receiving 80% of requests.
+     */
+    class hotset_distribution {
+      std::uint64_t d_keys;
+      std::uint64_t d_hot_keys;
+      std::uint64_t d_hot_threshold;
+
+    public:
+      using result_type = std::uint64_t;
+
+      hotset_distribution() = delete;
+      /**
+       * @param keys The number of keys, at least one.
+       * @param hot_fraction The fraction of the keys in the hot set, between zero and one.
+       * @param hot_probability The probability that a draw falls in the hot set, between zero and
+       * one.
+       */
+      hotset_distribution(std::uint64_t keys, double hot_fraction, double hot_probability)
+          : d_keys{std::max<std::uint64_t>(keys, 1)},
+            d_hot_keys{std::clamp<std::uint64_t>(
+                static_cast<std::uint64_t>(std::ceil(static_cast<double>(d_keys)
+                                                     * std::clamp(hot_fraction, 0.0, 1.0))),
+                1, d_keys)},
+            d_hot_threshold{static_cast<std::uint64_t>(std::clamp(hot_probability, 0.0, 1.0)
+                                                       * 0x1.0p53)} {}
+
+      result_type min() const { return 0; }
+      result_type max() const { return d_keys - 1; }
+      std::uint64_t keys() const { return d_keys; }
+      /** The number of keys in the hot set, [0, hot_keys()). */
+      std::uint64_t hot_keys() const { return d_hot_keys; }
+
+      template <typename GENERATOR> result_type operator()(GENERATOR& generator) const {
+        const bool hot = (next_word(generator) >> 11) < d_hot_threshold;
+        if (hot || d_hot_keys == d_keys) {
+          return uniform_below(generator, d_hot_keys);
+        }
+        return d_hot_keys + uniform_below(generator, d_keys - d_hot_keys);
+      }
+
+      /** Writes a sample to every element of [first, last). */
+      template <typename GENERATOR, typename OUTPUT_ITERATOR>
+      void fill(GENERATOR& generator, OUTPUT_ITERATOR first, OUTPUT_ITERATOR last) const {
+        for (; first != last; ++first) {
+          *first = (*this)(generator);
+        }
+      }
+    };
+  }  // namespace rand
+}  // namespace hh
+
+#endif
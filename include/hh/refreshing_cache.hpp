@@ -0,0 +1,339 @@
+#ifndef INCLUDED_HH_REFRESHING_CACHE_HPP
+#define INCLUDED_HH_REFRESHING_CACHE_HPP
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <hh/executor.hpp>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/typetraits.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace hh {
+  namespace functools {
+
+    template <typename SIGNATURE, typename CLOCK = std::chrono::steady_clock,
+              typename EXECUTOR = thread_pool_executor,
+              typename FUNCTION = std::function<SIGNATURE>>
+    class basic_refreshing_cache;
+
+    /**
+     * Thread-safe lru-cache whose entries go stale after a soft expiry and are refreshed in the
+     * background, serving the stale value meanwhile.
+     *
+     * Every entry carries two deadlines measured from when its value was computed. Before the
+     * soft one, refresh_after, a hit is an ordinary hit. Between the two a hit returns the stale
+     * value at once and schedules the underlying function to recompute it on the executor, so a
+     * key which stays hot never pays the function's latency on the calling thread. After the hard
+     * one, expire_after, the entry is treated as missing and the caller computes it, as with
+     * ttl_cache. A duration of zero disables either deadline.
+     *
+     * A key is refreshed at most once at a time, however many stale hits it receives, and no more
+     * than max_refreshes refreshes run at once; a stale hit beyond that limit schedules nothing and
+     * the next one tries again. A refresh which throws leaves the stale value in place until it is
+     * retried or hard-expires. A refresh which finishes after its entry was recomputed by a caller
+     * or evicted is discarded, so it never replaces a newer value; only if the recomputed entry
+     * goes stale again while that refresh is still running can it overlap the entry's next one.
+     * Misses call the function on the calling thread without holding the cache's lock, so
+     * concurrent misses on one key each compute it and the last result stored wins.
+     *
+     * Refreshes call the function concurrently with callers and with each other, so it must be
+     * safe to call concurrently. They hold shared ownership of the entries, so the cache can be
+     * destroyed with refreshes still running. The clock is a constructor argument so tests can
+     * inject a hh::helpers::manual_clock.
+     *
+     * @see ttl_cache
+     * @see executor.hpp
+     * @see make_refreshing_cache
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam CLOCK The clock used to timestamp entries, providing now() and a duration type.
+     * @tparam EXECUTOR The executor refreshes run on.
+     * @tparam FUNCTION The type of the stored underlying function.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename CLOCK, typename EXECUTOR,
+              typename FUNCTION>
+    class basic_refreshing_cache<RETURN_TYPE(ARGUMENTS...), CLOCK, EXECUTOR, FUNCTION> {
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using clock_type = CLOCK;
+      using duration = typename CLOCK::duration;
+      using time_point = typename CLOCK::time_point;
+      using executor_type = EXECUTOR;
+      using function_type = FUNCTION;
+
+    private:
+      struct cache_entry {
+        cache_key d_key;
+        decayed_return_type d_value;
+        time_point d_computed;
+        bool d_refreshing;
+        std::uint64_t d_ticket; /** Tells a refresh whether its entry was recomputed since. */
+      };
+
+      using entry_list = std::list<cache_entry>;
+
+      /** The state refreshes share with the cache, kept alive by whichever finishes last. */
+      struct shared_state {
+        shared_state(FUNCTION func, unsigned int cache_size, duration refresh_after,
+                     duration expire_after, std::size_t max_refreshes, CLOCK clock)
+            : d_func{std::move(func)},
+              d_max_size{cache_size},
+              d_refresh_after{refresh_after},
+              d_expire_after{expire_after},
+              d_max_refreshes{max_refreshes},
+              d_clock{std::move(clock)} {}
+
+        FUNCTION d_func;
+        unsigned int d_max_size;
+        duration d_refresh_after;
+        duration d_expire_after;
+        std::size_t d_max_refreshes;
+        CLOCK d_clock;
+        std::mutex d_mutex;
+        std::condition_variable d_idle;
+        std::size_t d_refreshing = 0;
+        std::uint64_t d_next_ticket = 0;
+        entry_list d_entries;
+        std::unordered_map<cache_key, typename entry_list::iterator, wy_key_hash<cache_key>>
+            d_entry_map;
+      };
+
+      std::shared_ptr<shared_state> d_state;
+      EXECUTOR d_executor;
+
+      static EXECUTOR make_executor(std::size_t max_refreshes) {
+        if constexpr (std::is_constructible_v<EXECUTOR, std::size_t>) {
+          return EXECUTOR{max_refreshes};
+        } else {
+          return EXECUTOR{};
+        }
+      }
+
+    public:
+      basic_refreshing_cache() = delete;
+      /**
+       * Constructs a cache with a given function, size and deadlines, refreshing on an executor
+       * of max_refreshes threads or, for executors without a thread count, a default one.
+       *
+       * @see make_refreshing_cache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       * @param refresh_after How long after being computed an entry is refreshed on a hit, zero
+       * meaning never.
+       * @param expire_after How long after being computed an entry is no longer returned, zero
+       * meaning never.
+       * @param max_refreshes The most refreshes which run at once, at least one.
+       * @param clock The clock used to timestamp entries.
+       */
+      basic_refreshing_cache(FUNCTION func, unsigned int cache_size, duration refresh_after,
+                             duration expire_after, std::size_t max_refreshes = 1,
+                             CLOCK clock = CLOCK{})
+          : basic_refreshing_cache(std::move(func), cache_size, refresh_after, expire_after,
+                                   max_refreshes, std::move(clock), make_executor(max_refreshes)) {}
+      /**
+       * Constructs a cache with a given function, size and deadlines, refreshing on the executor.
+       *
+       * @see make_refreshing_cache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       * @param refresh_after How long after being computed an entry is refreshed on a hit, zero
+       * meaning never.
+       * @param expire_after How long after being computed an entry is no longer returned, zero
+       * meaning never.
+       * @param max_refreshes The most refreshes which run at once, at least one.
+       * @param clock The clock used to timestamp entries.
+       * @param executor The executor refreshes run on.
+       */
+      basic_refreshing_cache(FUNCTION func, unsigned int cache_size, duration refresh_after,
+                             duration expire_after, std::size_t max_refreshes, CLOCK clock,
+                             EXECUTOR executor)
+          : d_state{std::make_shared<shared_state>(std::move(func), cache_size, refresh_after,
+                                                   expire_after,
+                                                   std::max<std::size_t>(max_refreshes, 1),
+                                                   std::move(clock))},
+            d_executor{std::move(executor)} {}
+      basic_refreshing_cache(const basic_refreshing_cache&) = delete;
+      basic_refreshing_cache& operator=(const basic_refreshing_cache&) = delete;
+
+      /**
+       * Calls the underlying function or returns a historic value which has not hard-expired,
+       * scheduling a refresh of the value if it is stale.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS>
+      decayed_return_type operator()(INPUT_ARGUMENTS&&... args) {
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        shared_state& state = *d_state;
+        {
+          std::unique_lock<std::mutex> lock{state.d_mutex};
+          const time_point now = state.d_clock.now();
+          const auto found = state.d_entry_map.find(key);
+          if (found != state.d_entry_map.end()) {
+            const auto entry_it = found->second;
+            if (!past(state.d_expire_after, entry_it->d_computed, now)) {
+              state.d_entries.splice(state.d_entries.end(), state.d_entries, entry_it);
+              decayed_return_type value = entry_it->d_value;
+              if (past(state.d_refresh_after, entry_it->d_computed, now) && !entry_it->d_refreshing
+                  && state.d_refreshing < state.d_max_refreshes) {
+                entry_it->d_refreshing = true;
+                ++state.d_refreshing;
+                const std::uint64_t ticket = entry_it->d_ticket;
+                lock.unlock();
+                schedule_refresh(std::move(key), ticket);
+              }
+              return value;
+            }
+            state.d_entries.erase(entry_it);
+            state.d_entry_map.erase(found);
+          }
+        }
+        decayed_return_type value = std::apply(state.d_func, key);
+        std::lock_guard<std::mutex> lock{state.d_mutex};
+        store(state, std::move(key), value, state.d_clock.now());
+        return value;
+      }
+
+      /** Blocks until no refresh is running. */
+      void wait_for_refreshes() const {
+        std::unique_lock<std::mutex> lock{d_state->d_mutex};
+        d_state->d_idle.wait(lock, [this] { return d_state->d_refreshing == 0; });
+      }
+
+      /** The number of refreshes running or waiting for the executor. */
+      std::size_t refreshing() const {
+        std::lock_guard<std::mutex> lock{d_state->d_mutex};
+        return d_state->d_refreshing;
+      }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      auto max_size() const { return d_state->d_max_size; }
+
+      /** How long after being computed an entry is refreshed on a hit, zero meaning never. */
+      duration refresh_after() const { return d_state->d_refresh_after; }
+
+      /** How long after being computed an entry is no longer returned, zero meaning never. */
+      duration expire_after() const { return d_state->d_expire_after; }
+
+      /** The most refreshes which run at once. */
+      std::size_t max_refreshes() const { return d_state->d_max_refreshes; }
+
+      /** The current number of retained historic values, including hard-expired ones. */
+      std::size_t size() const {
+        std::lock_guard<std::mutex> lock{d_state->d_mutex};
+        return d_state->d_entry_map.size();
+      }
+
+    private:
+      static bool past(duration deadline, time_point computed, time_point now) {
+        return deadline > duration::zero() && now - computed >= deadline;
+      }
+
+      static void store(shared_state& state, cache_key&& key, const decayed_return_type& value,
+                        time_point now) {
+        const auto found = state.d_entry_map.find(key);
+        if (found != state.d_entry_map.end()) {
+          found->second->d_value = value;
+          found->second->d_computed = now;
+          found->second->d_refreshing = false;
+          found->second->d_ticket = state.d_next_ticket++;
+          state.d_entries.splice(state.d_entries.end(), state.d_entries, found->second);
+          return;
+        }
+        state.d_entries.push_back(
+            cache_entry{std::move(key), value, now, false, state.d_next_ticket++});
+        state.d_entry_map.emplace(state.d_entries.back().d_key, std::prev(state.d_entries.end()));
+        if (state.d_max_size != 0 && state.d_entry_map.size() > state.d_max_size) {
+          state.d_entry_map.erase(state.d_entries.front().d_key);
+          state.d_entries.pop_front();
+        }
+      }
+
+      /**
+       * Ends a refresh, storing its value, if any, in the entry it was scheduled for unless that
+       * entry was recomputed or evicted since.
+       */
+      static void finish_refresh(shared_state& state, const cache_key& key, std::uint64_t ticket,
+                                 std::unique_ptr<decayed_return_type> value) {
+        {
+          std::lock_guard<std::mutex> lock{state.d_mutex};
+          const auto found = state.d_entry_map.find(key);
+          if (found != state.d_entry_map.end() && found->second->d_ticket == ticket) {
+            found->second->d_refreshing = false;
+            if (value) {
+              found->second->d_value = std::move(*value);
+              found->second->d_computed = state.d_clock.now();
+            }
+          }
+          --state.d_refreshing;
+        }
+        state.d_idle.notify_all();
+      }
+
+      void schedule_refresh(cache_key&& key, std::uint64_t ticket) {
+        // The executor takes its own copy of the key, so this one is left to roll back with.
+        try {
+          d_executor.execute([state = d_state, key, ticket]() noexcept {
+            std::unique_ptr<decayed_return_type> value;
+            try {
+              value = std::make_unique<decayed_return_type>(std::apply(state->d_func, key));
+            } catch (...) {
+              // The stale value is kept, and the next stale hit retries.
+            }
+            finish_refresh(*state, key, ticket, std::move(value));
+          });
+        } catch (...) {
+          finish_refresh(*d_state, key, ticket, nullptr);
+          throw;
+        }
+      }
+    };
+
+    /**
+     * The refreshing cache on the steady clock, keyed on a parameter pack.
+     *
+     * @see basic_refreshing_cache
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using refreshing_cache
+        = basic_refreshing_cache<RETURN_TYPE(ARGUMENTS...)>;
+
+    /**
+     * Makes a refreshing cache of the function on the steady clock, stored as its own type.
+     *
+     * @param func A function pointer, lambda, functor or member function pointer, or a
+     * std::function to opt in to type erasure.
+     * @param refresh_after How long after being computed an entry is refreshed on a hit.
+     * @param expire_after How long after being computed an entry is no longer returned, zero
+     * meaning never.
+     * @param size The maximum size of the cache.
+     * @param max_refreshes The most refreshes which run at once.
+     */
+    template <typename FUNCTION, typename REFRESH_REP, typename REFRESH_PERIOD, typename EXPIRE_REP,
+              typename EXPIRE_PERIOD>
+    auto make_refreshing_cache(FUNCTION func,
+                               std::chrono::duration<REFRESH_REP, REFRESH_PERIOD> refresh_after,
+                               std::chrono::duration<EXPIRE_REP, EXPIRE_PERIOD> expire_after,
+                               unsigned int size = DEFAULT_SIZE, std::size_t max_refreshes = 1) {
+      using steady_duration = std::chrono::steady_clock::duration;
+      return basic_refreshing_cache<callable_signature_t<FUNCTION>, std::chrono::steady_clock,
+                                    thread_pool_executor, FUNCTION>(
+          std::move(func), size, std::chrono::duration_cast<steady_duration>(refresh_after),
+          std::chrono::duration_cast<steady_duration>(expire_after), max_refreshes);
+    }
+  }  // namespace functools
+}  // namespace hh
+#endif
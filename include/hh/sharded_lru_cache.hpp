@@ -0,0 +1,252 @@
+#ifndef INCLUDED_HH_SHARDED_LRU_CACHE_HPP
+#define INCLUDED_HH_SHARDED_LRU_CACHE_HPP
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/optional.hpp>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace hh {
+  namespace functools {
+
+    /**
+     * How a sharded_lru_cache behaves when several threads miss on the same key at once.
+     */
+    enum class miss_strategy {
+      independent, /** Every missing caller calls the underlying function itself. */
+      coalesce     /** The first missing caller calls the function, the others wait for its
+                      result. */
+    };
+
+    /**
+     * Thread-safe variant of lru_cache which splits its keys over a number of independently locked
+     * shards.
+     *
+     * Each argument tuple is hashed with std::hash<cache_key> and the hash selects one of the
+     * shards, every shard being a small lru-cache guarded by its own mutex. Calls which land on
+     * different shards never contend with one another, so a single instance can be shared across
+     * worker threads. The underlying function is called without holding any lock, which means a
+     * slow function does not block hits on the same shard.
+     *
+     * The maximum size is split over the shards, the first maximum size modulo shard count shards
+     * holding one entry more than the rest, so the shards together never hold more than the
+     * maximum size. The least recently used entry is evicted per shard rather than across the
+     * whole cache. As with lru_cache a maximum size of zero makes the cache unbounded.
+     *
+     * With miss_strategy::coalesce concurrent misses on one key are single-flighted: the first
+     * caller computes the value while later callers wait on a shared future for that result. An
+     * exception thrown by the underlying function is rethrown to every waiter and nothing is cached.
+     *
+     * @see lru_cache
+     * @see make_sharded_lrucache
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparams ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> class sharded_lru_cache {
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using cache_entry = std::pair<cache_key, decayed_return_type>;
+      using function_signature = std::function<RETURN_TYPE(ARGUMENTS...)>;
+
+    private:
+      /** Shards are padded to a cache line so neighbouring locks do not share one. */
+      static constexpr std::size_t cache_line_size = 64;
+
+      struct alignas(cache_line_size) shard {
+        std::mutex d_mutex;
+        std::list<cache_entry> d_cache;
+        std::unordered_map<cache_key, typename std::list<cache_entry>::iterator> d_cache_map;
+        std::unordered_map<cache_key, std::shared_future<decayed_return_type>> d_in_flight;
+        unsigned int d_max_size = 0; /** This shard's part of the cache's maximum size. */
+      };
+
+      function_signature d_func;
+      miss_strategy d_miss_strategy;
+      unsigned int d_max_size;
+      unsigned int d_shard_bits;
+      std::unique_ptr<shard[]> d_shards;
+
+    public:
+      sharded_lru_cache() = delete;
+      /**
+       * Constructs a cache with a given function, size and number of shards.
+       *
+       * @see make_sharded_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the whole cache, split across the shards.
+       * @param shard_count The number of independently locked shards, rounded up to a power of two.
+       * @param strategy Whether concurrent misses on the same key are coalesced.
+       */
+      sharded_lru_cache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int cache_size,
+                        unsigned int shard_count,
+                        miss_strategy strategy = miss_strategy::independent)
+          : sharded_lru_cache(function_signature{func}, cache_size, shard_count, strategy) {}
+      /**
+       * Constructs a cache with a given function, size and number of shards.
+       *
+       * @see make_sharded_lrucache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the whole cache, split across the shards.
+       * @param shard_count The number of independently locked shards, rounded up to a power of two.
+       * @param strategy Whether concurrent misses on the same key are coalesced.
+       */
+      sharded_lru_cache(function_signature func, unsigned int cache_size, unsigned int shard_count,
+                        miss_strategy strategy = miss_strategy::independent)
+          : d_func{std::move(func)},
+            d_miss_strategy{strategy},
+            d_max_size{cache_size},
+            d_shard_bits{0},
+            d_shards{} {
+        while ((1u << d_shard_bits) < shard_count) {
+          ++d_shard_bits;
+        }
+        d_shards = std::make_unique<shard[]>(this->shard_count());
+        const unsigned int share = cache_size / this->shard_count();
+        const unsigned int remainder = cache_size % this->shard_count();
+        for (unsigned int i = 0; i < this->shard_count(); ++i) {
+          d_shards[i].d_max_size = share + (i < remainder ? 1 : 0);
+        }
+      }
+
+      /**
+       * Calls the underlying function or returns historic value.
+       *
+       * Only the shard owning the argument tuple is locked, and only while it is searched or
+       * updated. On a miss the lock is released while the underlying function runs. With
+       * miss_strategy::independent two threads missing on the same key will both call the function
+       * and the first result stored wins; with miss_strategy::coalesce the second thread waits for
+       * the first thread's result instead.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS>
+      decayed_return_type operator()(INPUT_ARGUMENTS&&... args) {
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        shard& owner = shard_for(key);
+        std::unique_lock<std::mutex> lock{owner.d_mutex};
+        auto found = get_entry_from_shard(owner, key);
+        if (found) {
+          return (*found)->second;
+        }
+        if (d_miss_strategy == miss_strategy::coalesce) {
+          return load_coalesced(owner, std::move(key), lock);
+        }
+        lock.unlock();
+        decayed_return_type value = std::apply(d_func, key);
+        lock.lock();
+        put_in_shard(owner, std::move(key), value);
+        return value;
+      }
+
+      /** How concurrent misses on the same key are handled. */
+      constexpr miss_strategy strategy() const { return d_miss_strategy; }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      constexpr auto max_size() const { return d_max_size; }
+
+      /** The number of independently locked shards. */
+      constexpr unsigned int shard_count() const { return 1u << d_shard_bits; }
+
+      /** The current number of retained historic values, locking each shard in turn. */
+      std::size_t size() const {
+        std::size_t total = 0;
+        for (unsigned int i = 0; i < shard_count(); ++i) {
+          std::lock_guard<std::mutex> lock{d_shards[i].d_mutex};
+          total += d_shards[i].d_cache_map.size();
+        }
+        return total;
+      }
+
+    private:
+      shard& shard_for(const cache_key& key) const {
+        if (d_shard_bits == 0) {
+          return d_shards[0];
+        }
+        // Fibonacci hashing spreads the top bits so weak hashes still use every shard.
+        const std::uint64_t mixed
+            = static_cast<std::uint64_t>(std::hash<cache_key>{}(key)) * 0x9E3779B97F4A7C15ull;
+        return d_shards[static_cast<std::size_t>(mixed >> (64u - d_shard_bits))];
+      }
+
+      static hh::optional<typename std::list<cache_entry>::iterator> get_entry_from_shard(
+          shard& owner, const cache_key& key) {
+        auto found_it = owner.d_cache_map.find(key);
+        if (found_it == owner.d_cache_map.end()) {
+          return hh::nullopt;
+        }
+        owner.d_cache.splice(owner.d_cache.end(), owner.d_cache, found_it->second);
+        return found_it->second;
+      }
+
+      decayed_return_type load_coalesced(shard& owner, cache_key&& key,
+                                         std::unique_lock<std::mutex>& lock) {
+        auto in_flight_it = owner.d_in_flight.find(key);
+        if (in_flight_it != owner.d_in_flight.end()) {
+          std::shared_future<decayed_return_type> pending = in_flight_it->second;
+          lock.unlock();
+          return pending.get();
+        }
+        std::promise<decayed_return_type> promise;
+        std::shared_future<decayed_return_type> result = promise.get_future().share();
+        owner.d_in_flight.emplace(key, result);
+        lock.unlock();
+        try {
+          promise.set_value(std::apply(d_func, key));
+        } catch (...) {
+          promise.set_exception(std::current_exception());
+        }
+        lock.lock();
+        owner.d_in_flight.erase(key);
+        // Rethrows for a failed call, in which case nothing is cached.
+        const decayed_return_type& value = result.get();
+        put_in_shard(owner, std::move(key), value);
+        return value;
+      }
+
+      void put_in_shard(shard& owner, cache_key&& key, const decayed_return_type& value) const {
+        if (owner.d_cache_map.find(key) != owner.d_cache_map.end()) {
+          return;
+        }
+        owner.d_cache.emplace_back(std::move(key), value);
+        owner.d_cache_map.emplace(owner.d_cache.back().first, std::prev(owner.d_cache.end()));
+        // A bounded cache smaller than its shard count leaves some shards no room at all.
+        if (d_max_size != 0 && owner.d_cache_map.size() > owner.d_max_size) {
+          owner.d_cache_map.erase(owner.d_cache.front().first);
+          owner.d_cache.pop_front();
+        }
+      }
+    };
+
+    constexpr static auto DEFAULT_SHARD_COUNT = 16u;
+
+    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_sharded_lrucache(std::function<RETURN_TYPE(ARGUMENTS...)> func,
+                               unsigned int size = DEFAULT_SIZE,
+                               unsigned int shard_count = DEFAULT_SHARD_COUNT,
+                               miss_strategy strategy = miss_strategy::independent) {
+      return sharded_lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size, shard_count, strategy);
+    }
+    template <typename RETURN_TYPE, typename... ARGUMENTS>
+    auto make_sharded_lrucache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int size = DEFAULT_SIZE,
+                               unsigned int shard_count = DEFAULT_SHARD_COUNT,
+                               miss_strategy strategy = miss_strategy::independent) {
+      return sharded_lru_cache<RETURN_TYPE, ARGUMENTS...>(func, size, shard_count, strategy);
+    }
+  }  // namespace functools
+
+}  // namespace hh
+#endif
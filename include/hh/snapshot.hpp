@@ -0,0 +1,425 @@
+#ifndef INCLUDED_HH_SNAPSHOT_HPP
+#define INCLUDED_HH_SNAPSHOT_HPP
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <hh/hash.hpp>
+#include <ios>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#  define HH_SNAPSHOT_MMAP 1
+#endif
+
+/**
+ * Binary snapshots of cache contents.
+ *
+ * A snapshot is a header followed by the entries of a cache, oldest first. When every key element
+ * and the value are bitwise serializable the entries are fixed-size records of their raw bytes,
+ * which are memory-mapped and copied straight out on load. Otherwise each key element and value is
+ * written through hh::functools::serializer, which can be specialised for user types.
+ *
+ * The header carries a fingerprint of the key element and value types, their names as the compiler
+ * reports them and their sizes and alignments, and a snapshot is only loaded into a cache with the
+ * same entry types. Bitwise snapshots hold native byte order and sizes, so they are meant for
+ * warm-starting the same build on the same platform rather than for exchange.
+ *
+ * This header is not included by lru_cache.hpp; include it where lru_cache::save() and
+ * lru_cache::load() are called.
+ */
+namespace hh {
+  namespace functools {
+
+    /**
+     * Whether values of a type can be saved and restored as their raw bytes. True for trivially
+     * copyable types other than pointers; specialise it to false for trivially copyable types which
+     * hold handles or addresses meaningless to another process.
+     */
+    template <typename T> struct is_bitwise_serializable
+        : std::bool_constant<std::is_trivially_copyable_v<T> && !std::is_pointer_v<T>> {};
+
+    /**
+     * Customisation point for writing a type to and reading it from a snapshot stream. The
+     * primary template handles bitwise serializable, default constructible types; specialisations
+     * are provided for strings, vectors, shared values, pairs and tuples. A specialisation
+     * provides:
+     *
+     *  - `static void save(std::ostream&, const T&)`
+     *  - `static T load(std::istream&)`
+     *
+     * @tparam T The type to serialize.
+     */
+    template <typename T, typename = void> struct serializer {
+      static_assert(is_bitwise_serializable<T>::value,
+                    "Specialise hh::functools::serializer for types which cannot be saved as their "
+                    "raw bytes.");
+
+      static void save(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+      }
+
+      static T load(std::istream& in) {
+        T value;
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        return value;
+      }
+    };
+
+    template <typename CHAR, typename TRAITS, typename ALLOCATOR>
+    struct serializer<std::basic_string<CHAR, TRAITS, ALLOCATOR>> {
+      static void save(std::ostream& out, const std::basic_string<CHAR, TRAITS, ALLOCATOR>& value) {
+        serializer<std::uint64_t>::save(out, value.size());
+        out.write(reinterpret_cast<const char*>(value.data()),
+                  static_cast<std::streamsize>(value.size() * sizeof(CHAR)));
+      }
+
+      static std::basic_string<CHAR, TRAITS, ALLOCATOR> load(std::istream& in) {
+        // Grown a chunk at a time, so a corrupt length runs out of stream before it runs out of
+        // memory.
+        constexpr std::uint64_t chunk_size = 4096;
+        const auto size = serializer<std::uint64_t>::load(in);
+        std::basic_string<CHAR, TRAITS, ALLOCATOR> value;
+        while (in && value.size() < size) {
+          const std::size_t offset = value.size();
+          const auto count = static_cast<std::size_t>(std::min(chunk_size, size - offset));
+          value.resize(offset + count);
+          in.read(reinterpret_cast<char*>(&value[offset]),
+                  static_cast<std::streamsize>(count * sizeof(CHAR)));
+        }
+        return value;
+      }
+    };
+
+    template <typename T, typename ALLOCATOR> struct serializer<std::vector<T, ALLOCATOR>> {
+      static void save(std::ostream& out, const std::vector<T, ALLOCATOR>& value) {
+        serializer<std::uint64_t>::save(out, value.size());
+        for (const auto& element : value) {
+          serializer<T>::save(out, element);
+        }
+      }
+
+      static std::vector<T, ALLOCATOR> load(std::istream& in) {
+        const auto size = serializer<std::uint64_t>::load(in);
+        std::vector<T, ALLOCATOR> value;
+        for (std::uint64_t i = 0; i < size && in; ++i) {
+          value.push_back(serializer<T>::load(in));
+        }
+        return value;
+      }
+    };
+
+    template <typename T> struct serializer<std::shared_ptr<const T>> {
+      static void save(std::ostream& out, const std::shared_ptr<const T>& value) {
+        serializer<T>::save(out, *value);
+      }
+
+      static std::shared_ptr<const T> load(std::istream& in) {
+        return std::make_shared<const T>(serializer<T>::load(in));
+      }
+    };
+
+    template <typename FIRST, typename SECOND> struct serializer<std::pair<FIRST, SECOND>> {
+      static void save(std::ostream& out, const std::pair<FIRST, SECOND>& value) {
+        serializer<FIRST>::save(out, value.first);
+        serializer<SECOND>::save(out, value.second);
+      }
+
+      static std::pair<FIRST, SECOND> load(std::istream& in) {
+        FIRST first = serializer<FIRST>::load(in);
+        return {std::move(first), serializer<SECOND>::load(in)};
+      }
+    };
+
+    template <typename... ELEMENTS> struct serializer<std::tuple<ELEMENTS...>> {
+      static void save(std::ostream& out, const std::tuple<ELEMENTS...>& value) {
+        std::apply([&out](const auto&... elements) {
+          (serializer<std::decay_t<decltype(elements)>>::save(out, elements), ...);
+        }, value);
+      }
+
+      static std::tuple<ELEMENTS...> load(std::istream& in) {
+        // Braced initialisation evaluates the elements in order.
+        return std::tuple<ELEMENTS...>{serializer<ELEMENTS>::load(in)...};
+      }
+    };
+
+    namespace detail {
+      struct snapshot_header {
+        char d_magic[8];
+        std::uint32_t d_version;
+        std::uint32_t d_layout;
+        std::uint64_t d_count;
+        std::uint64_t d_record_size;
+        std::uint64_t d_fingerprint;
+      };
+
+      constexpr char snapshot_magic[8] = {'h', 'h', 's', 'n', 'a', 'p', '\0', '\0'};
+      constexpr std::uint32_t snapshot_version = 2;
+      constexpr std::uint32_t streamed_layout = 0;
+      constexpr std::uint32_t bitwise_layout = 1;
+
+      template <typename KEY, typename VALUE> struct bitwise_entry;
+      template <typename... ELEMENTS, typename VALUE>
+      struct bitwise_entry<std::tuple<ELEMENTS...>, VALUE> {
+        static constexpr bool value = (is_bitwise_serializable<ELEMENTS>::value && ...)
+                                      && is_bitwise_serializable<VALUE>::value;
+        static constexpr std::size_t record_size = (std::size_t{0} + ... + sizeof(ELEMENTS))
+                                                   + sizeof(VALUE);
+
+        static char* write(char* out, const std::tuple<ELEMENTS...>& key, const VALUE& value) {
+          std::apply([&out](const auto&... elements) {
+            ((std::memcpy(out, &elements, sizeof(elements)), out += sizeof(elements)), ...);
+          }, key);
+          std::memcpy(out, &value, sizeof(VALUE));
+          return out + sizeof(VALUE);
+        }
+
+        template <typename T> static T read_one(const char*& in) {
+          T value;
+          std::memcpy(&value, in, sizeof(T));
+          in += sizeof(T);
+          return value;
+        }
+
+        static std::pair<std::tuple<ELEMENTS...>, VALUE> read(const char* in) {
+          // Braced initialisation evaluates the elements in order.
+          std::tuple<ELEMENTS...> key{read_one<ELEMENTS>(in)...};
+          return {std::move(key), read_one<VALUE>(in)};
+        }
+      };
+
+      /** Mixes the name, size and alignment of a type into a fingerprint. */
+      template <typename T> std::uint64_t type_fingerprint(std::uint64_t seed) {
+        const char* name = typeid(T).name();
+        const std::uint64_t layout[2] = {sizeof(T), alignof(T)};
+        return wyhash(layout, sizeof(layout), wyhash(name, std::strlen(name), seed));
+      }
+
+      template <typename KEY, typename VALUE> struct entry_fingerprint;
+      template <typename... ELEMENTS, typename VALUE>
+      struct entry_fingerprint<std::tuple<ELEMENTS...>, VALUE> {
+        static std::uint64_t value() {
+          std::uint64_t seed = sizeof...(ELEMENTS);
+          ((seed = type_fingerprint<ELEMENTS>(seed)), ...);
+          return type_fingerprint<VALUE>(seed);
+        }
+      };
+
+      /** A read-only view of a whole file, memory-mapped where the platform allows. */
+      class mapped_file {
+        const char* d_data = nullptr;
+        std::size_t d_size = 0;
+#ifdef HH_SNAPSHOT_MMAP
+        void* d_mapping = nullptr;
+#else
+        std::vector<char> d_buffer;
+#endif
+
+      public:
+        explicit mapped_file(const std::string& path) {
+#ifdef HH_SNAPSHOT_MMAP
+          const int descriptor = ::open(path.c_str(), O_RDONLY);
+          if (descriptor < 0) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+          }
+          struct stat status;
+          if (::fstat(descriptor, &status) != 0) {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "Cannot stat " + path);
+          }
+          d_size = static_cast<std::size_t>(status.st_size);
+          if (d_size != 0) {
+            d_mapping = ::mmap(nullptr, d_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+          }
+          const int error = errno;
+          ::close(descriptor);
+          if (d_mapping == MAP_FAILED) {
+            d_mapping = nullptr;
+            throw std::system_error(error, std::generic_category(), "Cannot map " + path);
+          }
+          if (d_mapping != nullptr) {
+            ::madvise(d_mapping, d_size, MADV_SEQUENTIAL);
+          }
+          d_data = static_cast<const char*>(d_mapping);
+#else
+          std::ifstream in{path, std::ios::binary};
+          if (!in) {
+            throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+          }
+          d_buffer.assign(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+          d_data = d_buffer.data();
+          d_size = d_buffer.size();
+#endif
+        }
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+        ~mapped_file() {
+#ifdef HH_SNAPSHOT_MMAP
+          if (d_mapping != nullptr) {
+            ::munmap(d_mapping, d_size);
+          }
+#endif
+        }
+
+        const char* data() const { return d_data; }
+        std::size_t size() const { return d_size; }
+      };
+
+      inline std::ofstream open_snapshot(const std::string& path) {
+        std::ofstream out{path, std::ios::binary | std::ios::trunc};
+        if (!out) {
+          throw std::system_error(errno, std::generic_category(), "Cannot create " + path);
+        }
+        return out;
+      }
+
+      inline void check_header(const snapshot_header& header, std::uint32_t layout,
+                               std::uint64_t record_size, std::uint64_t fingerprint,
+                               const std::string& path) {
+        if (std::memcmp(header.d_magic, snapshot_magic, sizeof(snapshot_magic)) != 0
+            || header.d_version != snapshot_version) {
+          throw std::runtime_error(path + " is not a cache snapshot.");
+        }
+        if (header.d_layout != layout || header.d_record_size != record_size
+            || header.d_fingerprint != fingerprint) {
+          throw std::runtime_error(path + " was saved from a cache with different entry types.");
+        }
+      }
+    }  // namespace detail
+
+    /**
+     * Writes a snapshot of entries to a file, replacing it.
+     *
+     * @param path The file to write.
+     * @param count The number of entries for_each will visit.
+     * @param for_each Callable taking a visitor, which it calls as `visit(const KEY&, const VALUE&)`
+     * for every entry, oldest first.
+     * @tparam KEY The tuple type keying the entries.
+     * @tparam VALUE The type of the entries' values.
+     */
+    template <typename KEY, typename VALUE, typename FOR_EACH>
+    void save_snapshot(const std::string& path, std::uint64_t count, FOR_EACH&& for_each) {
+      using entry = detail::bitwise_entry<KEY, VALUE>;
+      std::ofstream out = detail::open_snapshot(path);
+      detail::snapshot_header header{};
+      std::memcpy(header.d_magic, detail::snapshot_magic, sizeof(header.d_magic));
+      header.d_version = detail::snapshot_version;
+      header.d_count = count;
+      header.d_fingerprint = detail::entry_fingerprint<KEY, VALUE>::value();
+      if constexpr (entry::value) {
+        header.d_layout = detail::bitwise_layout;
+        header.d_record_size = entry::record_size;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        // Records are gathered into a buffer so the stream sees a few large writes.
+        std::vector<char> buffer(std::max<std::size_t>(entry::record_size, 1u << 16));
+        char* position = buffer.data();
+        for_each([&](const KEY& key, const VALUE& value) {
+          if (position + entry::record_size > buffer.data() + buffer.size()) {
+            out.write(buffer.data(), position - buffer.data());
+            position = buffer.data();
+          }
+          position = entry::write(position, key, value);
+        });
+        out.write(buffer.data(), position - buffer.data());
+      } else {
+        header.d_layout = detail::streamed_layout;
+        header.d_record_size = 0;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for_each([&out](const KEY& key, const VALUE& value) {
+          serializer<KEY>::save(out, key);
+          serializer<VALUE>::save(out, value);
+        });
+      }
+      out.flush();
+      if (!out) {
+        throw std::system_error(errno, std::generic_category(), "Cannot write " + path);
+      }
+    }
+
+    /**
+     * Reads the entries of a snapshot file, oldest first.
+     *
+     * @param path The file to read.
+     * @param insert Callable taking `(KEY&&, VALUE&&)` for every entry.
+     * @tparam KEY The tuple type keying the entries.
+     * @tparam VALUE The type of the entries' values.
+     */
+    template <typename KEY, typename VALUE, typename INSERT>
+    void load_snapshot(const std::string& path, INSERT&& insert) {
+      using entry = detail::bitwise_entry<KEY, VALUE>;
+      detail::snapshot_header header{};
+      if constexpr (entry::value) {
+        const detail::mapped_file file{path};
+        if (file.size() < sizeof(header)) {
+          throw std::runtime_error(path + " is not a cache snapshot.");
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+        detail::check_header(header, detail::bitwise_layout, entry::record_size,
+                             detail::entry_fingerprint<KEY, VALUE>::value(), path);
+        if ((file.size() - sizeof(header)) / entry::record_size < header.d_count) {
+          throw std::runtime_error(path + " is truncated.");
+        }
+        const char* record = file.data() + sizeof(header);
+        for (std::uint64_t i = 0; i < header.d_count; ++i, record += entry::record_size) {
+          auto loaded = entry::read(record);
+          insert(std::move(loaded.first), std::move(loaded.second));
+        }
+      } else {
+        std::ifstream in{path, std::ios::binary};
+        if (!in) {
+          throw std::system_error(errno, std::generic_category(), "Cannot open " + path);
+        }
+        if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+          throw std::runtime_error(path + " is not a cache snapshot.");
+        }
+        detail::check_header(header, detail::streamed_layout, 0,
+                             detail::entry_fingerprint<KEY, VALUE>::value(), path);
+        for (std::uint64_t i = 0; i < header.d_count; ++i) {
+          KEY key = serializer<KEY>::load(in);
+          VALUE value = serializer<VALUE>::load(in);
+          if (!in) {
+            throw std::runtime_error(path + " is truncated.");
+          }
+          insert(std::move(key), std::move(value));
+        }
+      }
+    }
+
+    namespace detail {
+      template <typename DEFER> struct snapshot_io;
+
+      /** Gives lru_cache::save() and lru_cache::load() the snapshot functions once included. */
+      template <> struct snapshot_io<void> {
+        template <typename KEY, typename VALUE, typename FOR_EACH>
+        static void save(const std::string& path, std::uint64_t count, FOR_EACH&& for_each) {
+          save_snapshot<KEY, VALUE>(path, count, std::forward<FOR_EACH>(for_each));
+        }
+
+        template <typename KEY, typename VALUE, typename INSERT>
+        static void load(const std::string& path, INSERT&& insert) {
+          load_snapshot<KEY, VALUE>(path, std::forward<INSERT>(insert));
+        }
+      };
+    }  // namespace detail
+  }  // namespace functools
+}  // namespace hh
+
+#endif
@@ -0,0 +1,144 @@
+#ifndef INCLUDED_HH_SPACE_SAVING_HPP
+#define INCLUDED_HH_SPACE_SAVING_HPP
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace hh {
+  namespace collection {
+
+    /**
+     * Fixed-size summary of the most frequent keys of a stream, using the Space-Saving algorithm.
+     *
+     * At most capacity keys are monitored, each with a count and the largest amount that count may
+     * overestimate it by. A key which is not monitored replaces the one with the smallest count and
+     * inherits that count as its error. After N increments a monitored key's true count lies
+     * between count - error and count, and every key occurring more than N / capacity times is
+     * monitored. The monitored keys are kept in a min-heap on their counts, so an increment costs a
+     * hash lookup and O(log capacity) swaps.
+     *
+     * @tparam KEY The type of key counted.
+     * @tparam HASH The hash functor for keys.
+     */
+    template <typename KEY, typename HASH = std::hash<KEY>> class space_saving {
+    public:
+      /** A monitored key with its count and the most that count may overestimate it by. */
+      struct entry {
+        KEY d_key;
+        std::uint64_t d_count;
+        std::uint64_t d_error;
+      };
+
+    private:
+      std::size_t d_capacity;
+      std::vector<entry> d_heap;
+      std::unordered_map<KEY, std::size_t, HASH> d_positions;
+
+    public:
+      space_saving() = delete;
+      /** @param capacity The number of keys monitored, at least one. */
+      explicit space_saving(std::size_t capacity)
+          : d_capacity{std::max<std::size_t>(capacity, 1)}, d_heap{}, d_positions{} {
+        d_heap.reserve(d_capacity);
+        d_positions.reserve(d_capacity);
+      }
+
+      /** Adds count occurrences of the key. */
+      void increment(const KEY& key, std::uint64_t count = 1) {
+        const auto found = d_positions.find(key);
+        if (found != d_positions.end()) {
+          d_heap[found->second].d_count += count;
+          sift_down(found->second);
+        } else if (d_heap.size() < d_capacity) {
+          d_positions.emplace(key, d_heap.size());
+          d_heap.push_back(entry{key, count, 0});
+          sift_up(d_heap.size() - 1);
+        } else {
+          entry& smallest = d_heap.front();
+          // Reusing the smallest key's node keeps replacements from allocating.
+          auto node = d_positions.extract(smallest.d_key);
+          node.key() = key;
+          node.mapped() = 0;
+          d_positions.insert(std::move(node));
+          smallest.d_error = smallest.d_count;
+          smallest.d_count += count;
+          smallest.d_key = key;
+          sift_down(0);
+        }
+      }
+
+      /** The monitored entry for the key, or null when the key is not monitored. */
+      const entry* find(const KEY& key) const {
+        const auto found = d_positions.find(key);
+        return found == d_positions.end() ? nullptr : &d_heap[found->second];
+      }
+
+      /** Up to count monitored entries, the highest counts first. */
+      std::vector<entry> top(std::size_t count) const {
+        std::vector<entry> entries{d_heap};
+        count = std::min(count, entries.size());
+        std::partial_sort(entries.begin(), entries.begin() + count, entries.end(),
+                          [](const entry& left, const entry& right) {
+                            return left.d_count > right.d_count;
+                          });
+        entries.resize(count);
+        return entries;
+      }
+
+      /** Stops monitoring every key. */
+      void clear() {
+        d_heap.clear();
+        d_positions.clear();
+      }
+
+      /** The number of keys currently monitored. */
+      std::size_t size() const { return d_heap.size(); }
+
+      /** The largest number of keys monitored. */
+      std::size_t capacity() const { return d_capacity; }
+
+    private:
+      void swap_entries(std::size_t left, std::size_t right) {
+        std::swap(d_heap[left], d_heap[right]);
+        d_positions[d_heap[left].d_key] = left;
+        d_positions[d_heap[right].d_key] = right;
+      }
+
+      void sift_up(std::size_t index) {
+        while (index > 0) {
+          const std::size_t parent = (index - 1) / 2;
+          if (d_heap[parent].d_count <= d_heap[index].d_count) {
+            return;
+          }
+          swap_entries(parent, index);
+          index = parent;
+        }
+      }
+
+      void sift_down(std::size_t index) {
+        while (true) {
+          const std::size_t left = 2 * index + 1;
+          const std::size_t right = left + 1;
+          std::size_t smallest = index;
+          if (left < d_heap.size() && d_heap[left].d_count < d_heap[smallest].d_count) {
+            smallest = left;
+          }
+          if (right < d_heap.size() && d_heap[right].d_count < d_heap[smallest].d_count) {
+            smallest = right;
+          }
+          if (smallest == index) {
+            return;
+          }
+          swap_entries(smallest, index);
+          index = smallest;
+        }
+      }
+    };
+  }  // namespace collection
+}  // namespace hh
+
+#endif
@@ -0,0 +1,190 @@
+#ifndef INCLUDED_HH_TIMER_WHEEL_HPP
+#define INCLUDED_HH_TIMER_WHEEL_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace hh {
+  namespace collection {
+
+    /**
+     * Intrusive link embedded in anything scheduled on a timer_wheel.
+     *
+     * A hook can be scheduled on at most one wheel at a time and must outlive its scheduling, so
+     * owners should cancel the timer before destroying the hook.
+     */
+    struct timer_hook {
+      timer_hook* d_timer_prev = nullptr;
+      timer_hook* d_timer_next = nullptr;
+      std::uint64_t d_deadline = 0;
+      bool d_scheduled = false;
+
+      /** Whether the hook is currently waiting on a wheel. */
+      bool scheduled() const { return d_scheduled; }
+    };
+
+    /**
+     * Hierarchical timer wheel over integer ticks.
+     *
+     * Deadlines are bucketed into levels of 64 slots, each level covering 64 times the span of the
+     * one below it. A deadline is filed by the highest 6-bit digit in which it differs from the
+     * current tick, and as time reaches a slot of a higher level its timers cascade down until they
+     * fire from level zero. Scheduling and cancelling are O(1), and every timer is moved at most once
+     * per level, so advancing costs O(1) amortized per timer. Runs of ticks with no timers in the
+     * lower levels are skipped rather than stepped through.
+     */
+    class timer_wheel {
+      static constexpr unsigned int slot_bits = 6;
+      static constexpr std::size_t slot_count = std::size_t{1} << slot_bits;
+      static constexpr std::size_t level_count = (64 + slot_bits - 1) / slot_bits;
+      static constexpr std::uint64_t slot_mask = slot_count - 1;
+
+      std::array<std::array<timer_hook*, slot_count>, level_count> d_slots{};
+      std::array<std::size_t, level_count> d_level_sizes{};
+      std::uint64_t d_current;
+      std::size_t d_size = 0;
+
+    public:
+      /**
+       * Constructs an empty wheel.
+       *
+       * @param current The tick the wheel starts at; deadlines at or before it fire on the next
+       * advance.
+       */
+      explicit timer_wheel(std::uint64_t current = 0) : d_current{current} {}
+      timer_wheel(const timer_wheel&) = delete;
+      timer_wheel& operator=(const timer_wheel&) = delete;
+
+      /** The last tick the wheel has advanced to. */
+      std::uint64_t current() const { return d_current; }
+
+      /** The number of scheduled timers. */
+      std::size_t size() const { return d_size; }
+
+      /**
+       * Schedules the hook to fire once the wheel advances to the deadline, rescheduling it if it is
+       * already waiting.
+       */
+      void schedule(timer_hook& hook, std::uint64_t deadline) {
+        if (hook.d_scheduled) {
+          cancel(hook);
+        }
+        // Overdue timers fire on the next tick.
+        hook.d_deadline = deadline > d_current ? deadline : d_current + 1;
+        place(hook);
+      }
+
+      /** Removes the hook from the wheel without firing it; does nothing if it is not scheduled. */
+      void cancel(timer_hook& hook) {
+        if (!hook.d_scheduled) {
+          return;
+        }
+        const std::size_t level = level_of(hook.d_deadline);
+        timer_hook*& head = d_slots[level][slot_of(hook.d_deadline, level)];
+        if (hook.d_timer_prev != nullptr) {
+          hook.d_timer_prev->d_timer_next = hook.d_timer_next;
+        } else {
+          head = hook.d_timer_next;
+        }
+        if (hook.d_timer_next != nullptr) {
+          hook.d_timer_next->d_timer_prev = hook.d_timer_prev;
+        }
+        hook.d_timer_prev = hook.d_timer_next = nullptr;
+        hook.d_scheduled = false;
+        --d_level_sizes[level];
+        --d_size;
+      }
+
+      /**
+       * Advances the wheel to the given tick, calling on_expired(timer_hook&) for every timer whose
+       * deadline has been reached. Hooks are unlinked before their callback runs, so the callback
+       * may destroy or reschedule them.
+       */
+      template <typename ON_EXPIRED> void advance(std::uint64_t target, ON_EXPIRED&& on_expired) {
+        while (d_current < target) {
+          if (d_size == 0) {
+            d_current = target;
+            return;
+          }
+          std::size_t empty_levels = 0;
+          while (d_level_sizes[empty_levels] == 0) {
+            ++empty_levels;
+          }
+          // Nothing can fire before the next cascade of the lowest occupied level.
+          const unsigned int skip_bits = static_cast<unsigned int>(empty_levels) * slot_bits;
+          const std::uint64_t next = empty_levels == 0 ? d_current + 1
+                                                       : ((d_current >> skip_bits) + 1) << skip_bits;
+          if (next > target || next <= d_current) {
+            d_current = target;
+            return;
+          }
+          d_current = next;
+          for (std::size_t level = level_count - 1; level > 0; --level) {
+            if ((d_current & ((std::uint64_t{1} << (level * slot_bits)) - 1)) == 0) {
+              cascade(level);
+            }
+          }
+          timer_hook* expired = take(0, d_current & slot_mask);
+          while (expired != nullptr) {
+            timer_hook* next_expired = expired->d_timer_next;
+            expired->d_timer_prev = expired->d_timer_next = nullptr;
+            on_expired(*expired);
+            expired = next_expired;
+          }
+        }
+      }
+
+    private:
+      std::size_t level_of(std::uint64_t deadline) const {
+        std::uint64_t difference = deadline ^ d_current;
+        std::size_t level = 0;
+        while ((difference >>= slot_bits) != 0) {
+          ++level;
+        }
+        return level;
+      }
+
+      static std::size_t slot_of(std::uint64_t deadline, std::size_t level) {
+        return static_cast<std::size_t>((deadline >> (level * slot_bits)) & slot_mask);
+      }
+
+      void place(timer_hook& hook) {
+        const std::size_t level = level_of(hook.d_deadline);
+        timer_hook*& head = d_slots[level][slot_of(hook.d_deadline, level)];
+        hook.d_timer_prev = nullptr;
+        hook.d_timer_next = head;
+        if (head != nullptr) {
+          head->d_timer_prev = &hook;
+        }
+        head = &hook;
+        hook.d_scheduled = true;
+        ++d_level_sizes[level];
+        ++d_size;
+      }
+
+      /** Detaches and returns a whole slot, marking its hooks as no longer scheduled. */
+      timer_hook* take(std::size_t level, std::size_t slot) {
+        timer_hook* head = d_slots[level][slot];
+        d_slots[level][slot] = nullptr;
+        for (timer_hook* hook = head; hook != nullptr; hook = hook->d_timer_next) {
+          hook->d_scheduled = false;
+          --d_level_sizes[level];
+          --d_size;
+        }
+        return head;
+      }
+
+      void cascade(std::size_t level) {
+        // Timers due exactly now land in the level zero slot which is about to fire.
+        timer_hook* hook = take(level, slot_of(d_current, level));
+        while (hook != nullptr) {
+          timer_hook* next = hook->d_timer_next;
+          place(*hook);
+          hook = next;
+        }
+      }
+    };
+  }  // namespace collection
+}  // namespace hh
+
+#endif
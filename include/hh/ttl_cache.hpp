@@ -0,0 +1,232 @@
+#ifndef INCLUDED_HH_TTL_CACHE_HPP
+#define INCLUDED_HH_TTL_CACHE_HPP
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/optional.hpp>
+#include <hh/timer_wheel.hpp>
+#include <list>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace hh {
+  namespace functools {
+
+    template <typename SIGNATURE, typename CLOCK = std::chrono::steady_clock> class basic_ttl_cache;
+
+    /**
+     * Functional-style lru-cache whose entries also expire a fixed time after they were computed.
+     *
+     * Each entry is given a time-to-live when it is stored, either the cache-wide default or one
+     * passed to call_with_ttl(). A lookup which finds an entry past its expiry treats it as a miss
+     * and calls the underlying function again. Expired entries are also reclaimed proactively
+     * through a hierarchical timer wheel which is advanced on every call, so stale entries do not
+     * linger until capacity evicts them and reclaiming them never scans the cache. As with
+     * lru_cache the least recently used entry is evicted once the cache is full, and a maximum size
+     * of zero makes the cache unbounded. A time-to-live of zero means the entry never expires.
+     *
+     * The clock is a constructor argument so tests can inject a hh::helpers::manual_clock and move
+     * time forward deterministically.
+     *
+     * @see lru_cache
+     * @see make_ttl_cache
+     * @tparam RETURN_TYPE The return type of the function used to instantiate this cache.
+     * @tparam ARGUMENTS... Paramter Pack of types which this function declares in its signature.
+     * @tparam CLOCK The clock used to timestamp entries, providing now() and a duration type.
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename CLOCK>
+    class basic_ttl_cache<RETURN_TYPE(ARGUMENTS...), CLOCK> {
+    public:
+      static constexpr std::size_t key_size = sizeof...(ARGUMENTS);
+      using return_type = RETURN_TYPE;
+      using decayed_return_type = std::decay_t<RETURN_TYPE>;
+      using cache_key = std::tuple<std::decay_t<ARGUMENTS>...>;
+      using function_signature = std::function<RETURN_TYPE(ARGUMENTS...)>;
+      using clock_type = CLOCK;
+      using duration = typename CLOCK::duration;
+      using time_point = typename CLOCK::time_point;
+
+      /** The granularity of the timer wheel; lookups still compare exact expiry times. */
+      static constexpr std::chrono::milliseconds timer_resolution{1};
+
+    private:
+      struct cache_entry : hh::collection::timer_hook {
+        cache_entry(cache_key&& key, decayed_return_type&& value, time_point expiry)
+            : d_key{std::move(key)}, d_value{std::move(value)}, d_expiry{expiry} {}
+
+        cache_key d_key;
+        decayed_return_type d_value;
+        time_point d_expiry;
+      };
+      using entry_iterator = typename std::list<cache_entry>::iterator;
+
+      function_signature d_func;
+      unsigned int d_max_size;
+      duration d_ttl;
+      CLOCK d_clock;
+      std::list<cache_entry> d_cache;
+      std::unordered_map<cache_key, entry_iterator> d_cache_map;
+      hh::collection::timer_wheel d_timers;
+
+    public:
+      basic_ttl_cache() = delete;
+      /**
+       * Constructs a cache with a given function, size and default time-to-live.
+       *
+       * @see make_ttl_cache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       * @param ttl How long entries stay valid after being computed, zero meaning forever.
+       * @param clock The clock used to timestamp entries.
+       */
+      basic_ttl_cache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int cache_size, duration ttl,
+                      CLOCK clock = CLOCK{})
+          : basic_ttl_cache(function_signature{func}, cache_size, ttl, std::move(clock)) {}
+      /**
+       * Constructs a cache with a given function, size and default time-to-live.
+       *
+       * @see make_ttl_cache()
+       * @param func The underlying function which will be used to populate the cache on call.
+       * @param cache_size The maximum size of the underlying cache.
+       * @param ttl How long entries stay valid after being computed, zero meaning forever.
+       * @param clock The clock used to timestamp entries.
+       */
+      basic_ttl_cache(function_signature func, unsigned int cache_size, duration ttl,
+                      CLOCK clock = CLOCK{})
+          : d_func{std::move(func)},
+            d_max_size{cache_size},
+            d_ttl{ttl},
+            d_clock{std::move(clock)},
+            d_cache{},
+            d_cache_map{cache_size},
+            d_timers{tick_of(d_clock.now())} {}
+      basic_ttl_cache(const basic_ttl_cache&) = delete;
+      basic_ttl_cache& operator=(const basic_ttl_cache&) = delete;
+
+      /**
+       * Calls the underlying function or returns a historic value which has not yet expired. A
+       * newly computed value lives for the cache's default time-to-live.
+       *
+       * @see lru_cache::operator()()
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS> RETURN_TYPE operator()(INPUT_ARGUMENTS&&... args) {
+        return call_with_ttl(d_ttl, std::forward<INPUT_ARGUMENTS>(args)...);
+      }
+
+      /**
+       * Calls the underlying function or returns a historic value which has not yet expired. A
+       * newly computed value lives for the given time-to-live instead of the cache's default.
+       *
+       * @param ttl How long a newly computed value stays valid, zero meaning forever.
+       * @params args The arguments to call the function with, converted to the cache key.
+       */
+      template <typename... INPUT_ARGUMENTS>
+      RETURN_TYPE call_with_ttl(duration ttl, INPUT_ARGUMENTS&&... args) {
+        const time_point now = d_clock.now();
+        evict_expired(now);
+        cache_key key{std::forward<INPUT_ARGUMENTS>(args)...};
+        auto found = get_entry_from_cache(key, now);
+        if (found) {
+          d_cache.splice(d_cache.end(), d_cache, *found);
+          return d_cache.back().d_value;
+        }
+        decayed_return_type value = std::apply(d_func, key);
+        return put_in_cache(std::move(key), std::move(value), now, ttl)->d_value;
+      }
+
+      /**
+       * Reclaims every entry whose expiry has passed. Calls already do this, so it only needs to be
+       * called to release memory held by a cache which is not being used.
+       */
+      void evict_expired() { evict_expired(d_clock.now()); }
+
+      /** The maximum number of entries this cache can store. If 0 an infinite number of values can
+       * be stored. */
+      constexpr auto max_size() const { return d_max_size; }
+
+      /** The default time-to-live of entries, zero meaning they never expire. */
+      constexpr duration ttl() const { return d_ttl; }
+
+      /** The current number of retained historic values, including ones expired since the last
+       * call. */
+      auto size() const { return d_cache_map.size(); }
+
+    private:
+      static std::uint64_t tick_of(time_point when) {
+        const auto ticks
+            = std::chrono::duration_cast<std::chrono::milliseconds>(when.time_since_epoch()).count()
+              / timer_resolution.count();
+        return ticks < 0 ? 0 : static_cast<std::uint64_t>(ticks);
+      }
+
+      void evict_expired(time_point now) {
+        d_timers.advance(tick_of(now), [this](hh::collection::timer_hook& hook) {
+          auto found_it = d_cache_map.find(static_cast<cache_entry&>(hook).d_key);
+          entry_iterator entry_it = found_it->second;
+          d_cache_map.erase(found_it);
+          d_cache.erase(entry_it);
+        });
+      }
+
+      hh::optional<entry_iterator> get_entry_from_cache(const cache_key& key, time_point now) {
+        auto found_it = d_cache_map.find(key);
+        if (found_it == d_cache_map.end()) {
+          return hh::nullopt;
+        }
+        entry_iterator entry_it = found_it->second;
+        if (entry_it->scheduled() && entry_it->d_expiry <= now) {
+          d_timers.cancel(*entry_it);
+          d_cache_map.erase(found_it);
+          d_cache.erase(entry_it);
+          return hh::nullopt;
+        }
+        return entry_it;
+      }
+
+      entry_iterator put_in_cache(cache_key&& key, decayed_return_type&& value, time_point now,
+                                  duration ttl) {
+        d_cache.emplace_back(std::move(key), std::move(value), now + ttl);
+        entry_iterator entry_it = std::prev(d_cache.end());
+        d_cache_map.emplace(entry_it->d_key, entry_it);
+        if (ttl > duration::zero()) {
+          // Round up so the wheel never reclaims an entry before its exact expiry.
+          d_timers.schedule(*entry_it, tick_of(now + ttl) + 1);
+        }
+        if (max_size() != 0 && size() > max_size()) {
+          d_timers.cancel(d_cache.front());
+          d_cache_map.erase(d_cache.front().d_key);
+          d_cache.pop_front();
+        }
+        return entry_it;
+      }
+    };
+
+    /**
+     * The TTL cache on the steady clock, keyed on a parameter pack.
+     *
+     * @see basic_ttl_cache
+     */
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using ttl_cache
+        = basic_ttl_cache<RETURN_TYPE(ARGUMENTS...)>;
+
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename REP, typename PERIOD>
+    auto make_ttl_cache(std::function<RETURN_TYPE(ARGUMENTS...)> func,
+                        std::chrono::duration<REP, PERIOD> ttl, unsigned int size = DEFAULT_SIZE) {
+      return ttl_cache<RETURN_TYPE, ARGUMENTS...>(
+          func, size, std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl));
+    }
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename REP, typename PERIOD>
+    auto make_ttl_cache(RETURN_TYPE (*func)(ARGUMENTS...), std::chrono::duration<REP, PERIOD> ttl,
+                        unsigned int size = DEFAULT_SIZE) {
+      return ttl_cache<RETURN_TYPE, ARGUMENTS...>(
+          func, size, std::chrono::duration_cast<std::chrono::steady_clock::duration>(ttl));
+    }
+  }  // namespace functools
+
+}  // namespace hh
+#endif
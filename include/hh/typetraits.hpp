@@ -1,6 +1,86 @@
 #ifndef INCLUDED_HH_TYPETRAITS_HH
 #define INCLUDED_HH_TYPETRAITS_HH
+#include <type_traits>
 
-namespace hh {}
+namespace hh {
+  namespace detail {
+    template <typename MEMBER> struct member_call_signature;
+
+    template <typename RETURN_TYPE, typename CLASS, typename... ARGUMENTS>
+    struct member_call_signature<RETURN_TYPE (CLASS::*)(ARGUMENTS...)> {
+      using object_type = CLASS;
+      using type = RETURN_TYPE(ARGUMENTS...);
+    };
+    template <typename RETURN_TYPE, typename CLASS, typename... ARGUMENTS>
+    struct member_call_signature<RETURN_TYPE (CLASS::*)(ARGUMENTS...) const> {
+      using object_type = const CLASS;
+      using type = RETURN_TYPE(ARGUMENTS...);
+    };
+    template <typename RETURN_TYPE, typename CLASS, typename... ARGUMENTS>
+    struct member_call_signature<RETURN_TYPE (CLASS::*)(ARGUMENTS...) noexcept> {
+      using object_type = CLASS;
+      using type = RETURN_TYPE(ARGUMENTS...);
+    };
+    template <typename RETURN_TYPE, typename CLASS, typename... ARGUMENTS>
+    struct member_call_signature<RETURN_TYPE (CLASS::*)(ARGUMENTS...) const noexcept> {
+      using object_type = const CLASS;
+      using type = RETURN_TYPE(ARGUMENTS...);
+    };
+
+    template <typename SIGNATURE, typename OBJECT> struct prepend_object;
+
+    template <typename RETURN_TYPE, typename... ARGUMENTS, typename OBJECT>
+    struct prepend_object<RETURN_TYPE(ARGUMENTS...), OBJECT> {
+      using type = RETURN_TYPE(OBJECT*, ARGUMENTS...);
+    };
+
+    template <typename CALLABLE, typename = void> struct functor_signature {};
+
+    template <typename CALLABLE>
+    struct functor_signature<CALLABLE, std::void_t<decltype(&CALLABLE::operator())>> {
+      using type = typename member_call_signature<decltype(&CALLABLE::operator())>::type;
+    };
+  }  // namespace detail
+
+  /**
+   * The signature a callable is called with, as RETURN_TYPE(ARGUMENTS...).
+   *
+   * Function pointers and references give their own signature, and functors, lambdas and
+   * std::function the signature of their one operator(). Member function pointers are called with
+   * a pointer to the object first, as std::invoke calls them, so `int (widget::*)(int) const`
+   * gives `int(const widget*, int)`. Generic lambdas and functors with overloaded call operators
+   * have no single signature, and leave type undefined.
+   *
+   * @tparam CALLABLE The callable type, decayed.
+   */
+  template <typename CALLABLE> struct callable_signature : detail::functor_signature<CALLABLE> {};
+
+  template <typename RETURN_TYPE, typename... ARGUMENTS>
+  struct callable_signature<RETURN_TYPE(ARGUMENTS...)> {
+    using type = RETURN_TYPE(ARGUMENTS...);
+  };
+  template <typename RETURN_TYPE, typename... ARGUMENTS>
+  struct callable_signature<RETURN_TYPE(ARGUMENTS...) noexcept> {
+    using type = RETURN_TYPE(ARGUMENTS...);
+  };
+  template <typename RETURN_TYPE, typename... ARGUMENTS>
+  struct callable_signature<RETURN_TYPE (*)(ARGUMENTS...)> {
+    using type = RETURN_TYPE(ARGUMENTS...);
+  };
+  template <typename RETURN_TYPE, typename... ARGUMENTS>
+  struct callable_signature<RETURN_TYPE (*)(ARGUMENTS...) noexcept> {
+    using type = RETURN_TYPE(ARGUMENTS...);
+  };
+
+  template <typename RETURN_TYPE, typename CLASS>
+  struct callable_signature<RETURN_TYPE CLASS::*> {
+    using member_type = detail::member_call_signature<RETURN_TYPE CLASS::*>;
+    using type = typename detail::prepend_object<typename member_type::type,
+                                                 typename member_type::object_type>::type;
+  };
+
+  template <typename CALLABLE> using callable_signature_t =
+      typename callable_signature<std::decay_t<CALLABLE>>::type;
+}  // namespace hh
 
 #endif
@@ -0,0 +1,102 @@
+#ifndef INCLUDED_HH_WEIGHER_HPP
+#define INCLUDED_HH_WEIGHER_HPP
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/**
+ * Weighers for basic_lru_cache.
+ *
+ * A weigher is a callable `std::size_t(const KEY&, const VALUE&)` giving the weight of a cache
+ * entry, which the cache sums and keeps within its weight budget. A weigher must give the same
+ * weight every time it is called for the same entry, as it is consulted again when the entry is
+ * evicted.
+ */
+namespace hh {
+  namespace functools {
+    namespace detail {
+      template <typename T, typename = void> struct has_capacity : std::false_type {};
+      template <typename T>
+      struct has_capacity<T, std::void_t<decltype(std::declval<const T&>().capacity())>>
+          : std::true_type {};
+
+      template <typename T, typename = void> struct is_range : std::false_type {};
+      template <typename T> struct is_range<T, std::void_t<typename T::value_type,
+                                                           decltype(std::declval<const T&>().size()),
+                                                           decltype(std::begin(std::declval<const T&>()))>>
+          : std::true_type {};
+
+      template <typename T, typename = void> struct is_tuple_like : std::false_type {};
+      template <typename T>
+      struct is_tuple_like<T, std::void_t<decltype(std::tuple_size<T>::value)>> : std::true_type {};
+
+      template <typename T> struct is_shared_pointer : std::false_type {};
+      template <typename T> struct is_shared_pointer<std::shared_ptr<T>> : std::true_type {};
+
+      /**
+       * The bytes a value owns beyond its own sizeof, following containers, tuples and shared
+       * pointers.
+       */
+      template <typename T> std::size_t heap_bytes(const T& value);
+
+      template <typename TUPLE, std::size_t... INDICES>
+      std::size_t tuple_heap_bytes(const TUPLE& value, std::index_sequence<INDICES...>) {
+        return (std::size_t{0} + ... + heap_bytes(std::get<INDICES>(value)));
+      }
+
+      template <typename T> std::size_t heap_bytes(const T& value) {
+        if constexpr (is_range<T>::value) {
+          using element = typename T::value_type;
+          std::size_t bytes = 0;
+          if constexpr (has_capacity<T>::value) {
+            bytes = value.capacity() * sizeof(element);
+          } else {
+            bytes = value.size() * sizeof(element);
+          }
+          if constexpr (!std::is_trivially_copyable_v<element>) {
+            for (const auto& item : value) {
+              bytes += heap_bytes(item);
+            }
+          }
+          return bytes;
+        } else if constexpr (is_tuple_like<T>::value) {
+          return tuple_heap_bytes(value, std::make_index_sequence<std::tuple_size<T>::value>{});
+        } else if constexpr (is_shared_pointer<T>::value) {
+          using element = std::remove_cv_t<typename T::element_type>;
+          return value == nullptr ? 0 : sizeof(element) + heap_bytes<element>(*value);
+        } else {
+          return 0;
+        }
+      }
+    }  // namespace detail
+
+    /**
+     * Weighs every entry as one, so a weight budget is an entry count. The default weigher of
+     * basic_lru_cache, which then keeps its size() and weight() equal.
+     */
+    struct unit_weigher {
+      template <typename KEY, typename VALUE>
+      constexpr std::size_t operator()(const KEY&, const VALUE&) const {
+        return 1;
+      }
+    };
+
+    /**
+     * Estimates the bytes held by an entry: the sizeof of the key and value plus the heap storage
+     * of any containers within them, using capacity() where the container has one. Allocator
+     * bookkeeping and the cache's own nodes are not counted, while strings short enough to be
+     * stored inline are still counted at their capacity.
+     */
+    struct default_weigher {
+      template <typename KEY, typename VALUE>
+      std::size_t operator()(const KEY& key, const VALUE& value) const {
+        return sizeof(KEY) + sizeof(VALUE) + detail::heap_bytes(key) + detail::heap_bytes(value);
+      }
+    };
+  }  // namespace functools
+}  // namespace hh
+
+#endif
@@ -0,0 +1 @@
+#include <hh/async_lru_cache.hpp>
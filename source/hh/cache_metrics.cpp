@@ -0,0 +1 @@
+#include <hh/cache_metrics.hpp>
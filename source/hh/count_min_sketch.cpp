@@ -0,0 +1 @@
+#include <hh/count_min_sketch.hpp>
@@ -0,0 +1 @@
+#include <hh/counter.hpp>
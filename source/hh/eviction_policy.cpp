@@ -0,0 +1 @@
+#include <hh/eviction_policy.hpp>
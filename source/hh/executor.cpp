@@ -0,0 +1 @@
+#include <hh/executor.hpp>
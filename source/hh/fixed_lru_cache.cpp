@@ -0,0 +1 @@
+#include <hh/fixed_lru_cache.hpp>
@@ -0,0 +1 @@
+#include <hh/flat_lru_cache.hpp>
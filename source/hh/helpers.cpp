@@ -0,0 +1 @@
+#include <hh/helpers.hpp>
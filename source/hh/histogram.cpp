@@ -0,0 +1 @@
+#include <hh/histogram.hpp>
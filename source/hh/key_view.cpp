@@ -0,0 +1 @@
+#include <hh/key_view.hpp>
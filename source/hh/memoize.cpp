@@ -0,0 +1 @@
+#include <hh/memoize.hpp>
@@ -0,0 +1 @@
+#include <hh/pool_allocator.hpp>
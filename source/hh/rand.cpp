@@ -0,0 +1 @@
+#include <hh/rand.hpp>
@@ -0,0 +1 @@
+#include <hh/refreshing_cache.hpp>
@@ -0,0 +1 @@
+#include <hh/sharded_lru_cache.hpp>
@@ -0,0 +1 @@
+#include <hh/snapshot.hpp>
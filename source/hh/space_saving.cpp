@@ -0,0 +1 @@
+#include <hh/space_saving.hpp>
@@ -0,0 +1 @@
+#include <hh/timer_wheel.hpp>
@@ -0,0 +1 @@
+#include <hh/ttl_cache.hpp>
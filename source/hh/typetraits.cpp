@@ -0,0 +1 @@
+#include <hh/typetraits.hpp>
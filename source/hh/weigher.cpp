@@ -0,0 +1 @@
+#include <hh/weigher.hpp>
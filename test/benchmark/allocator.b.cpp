@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <hh/call_counter.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/pool_allocator.hpp>
+#include <memory_resource>
+#include <string>
+
+#include "memory.hpp"
+
+namespace {
+  std::size_t identity(std::size_t value) { return value; }
+
+  std::string label(std::size_t value) { return std::to_string(value); }
+
+  /** The allocators under comparison, each able to make a fresh allocator for one cache. */
+  struct std_allocator {
+    using type = std::allocator<std::byte>;
+    type make() { return type{}; }
+  };
+
+  struct pooled {
+    using type = hh::functools::pool_allocator<std::byte>;
+    type make() { return type{}; }
+  };
+
+  struct pmr_pool {
+    using type = std::pmr::polymorphic_allocator<std::byte>;
+    std::pmr::unsynchronized_pool_resource d_resource;
+    type make() { return type{&d_resource}; }
+  };
+
+  /** Reports allocations per operation and the growth of the resident set over the benchmark. */
+  class memory_report {
+    hh::benchmark::heap_tracking d_tracking;
+    hh::benchmark::heap_snapshot d_heap_before = hh::benchmark::heap_usage();
+    std::size_t d_resident_before = hh::benchmark::resident_bytes();
+
+  public:
+    memory_report() { hh::benchmark::reset_peak_resident_bytes(); }
+
+    void finish(::benchmark::State& state) const {
+      state.counters["allocations_per_op"] = ::benchmark::Counter(
+          static_cast<double>(hh::benchmark::heap_usage().allocations
+                              - d_heap_before.allocations),
+          ::benchmark::Counter::kAvgIterations);
+      state.counters["peak_rss_bytes"] = static_cast<double>(hh::benchmark::peak_resident_bytes())
+                                         - static_cast<double>(d_resident_before);
+    }
+  };
+
+  /**
+   * Cycles through twice the capacity of keys, so every call misses and evicts: the node of the
+   * evicted entry is freed and one of the same size allocated for the new entry.
+   */
+  template <typename ALLOCATOR, typename VALUE>
+  void benchmark_lru_churn(::benchmark::State& state, VALUE (*func)(std::size_t)) {
+    const auto capacity = static_cast<unsigned int>(state.range(0));
+    ALLOCATOR allocator;
+    const memory_report report;
+    {
+      auto cache = hh::functools::make_lrucache(func, capacity, allocator.make());
+      std::size_t key = 0;
+      for (const auto& _ : state) {
+        benchmark::DoNotOptimize(cache(key));
+        key = key + 1 == 2 * capacity ? 0 : key + 1;
+      }
+      report.finish(state);
+    }
+  }
+
+  template <typename ALLOCATOR> void benchmark_lru_churn_int(::benchmark::State& state) {
+    benchmark_lru_churn<ALLOCATOR>(state, identity);
+  }
+
+  template <typename ALLOCATOR> void benchmark_lru_churn_string(::benchmark::State& state) {
+    benchmark_lru_churn<ALLOCATOR>(state, label);
+  }
+
+  /** Counts calls over an ever growing set of keys, so every call inserts a counter node. */
+  template <typename ALLOCATOR> void benchmark_call_counter_distinct(::benchmark::State& state) {
+    ALLOCATOR allocator;
+    const memory_report report;
+    {
+      hh::functools::basic_call_counter<std::size_t(std::size_t), hh::functools::wy_hasher,
+                                        std::size_t (*)(std::size_t), typename ALLOCATOR::type>
+          counter{identity, 1, allocator.make()};
+      std::size_t key = 0;
+      for (const auto& _ : state) {
+        benchmark::DoNotOptimize(counter(key++));
+      }
+      report.finish(state);
+    }
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_lru_churn_int, std_allocator)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_lru_churn_int, pooled)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_lru_churn_int, pmr_pool)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_lru_churn_string, std_allocator)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_lru_churn_string, pooled)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_lru_churn_string, pmr_pool)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_call_counter_distinct, std_allocator);
+BENCHMARK_TEMPLATE(benchmark_call_counter_distinct, pooled);
+BENCHMARK_TEMPLATE(benchmark_call_counter_distinct, pmr_pool);
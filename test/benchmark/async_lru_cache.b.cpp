@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <future>
+#include <hh/async_lru_cache.hpp>
+#include <hh/helpers.hpp>
+#include <hh/lru_cache.hpp>
+#include <vector>
+
+namespace {
+  int add(int a, int b) { return a + b; }
+
+  /** A loader spending 100us waiting, as an I/O-bound function would. */
+  const auto slow_add = hh::helpers::make_delayed<100, std::chrono::microseconds>(add);
+
+  constexpr unsigned int CAPACITY = 1 << 16;
+
+  /** Misses on as many new keys as are outstanding, one call after another. */
+  void benchmark_blocking_cache_misses(::benchmark::State& state) {
+    const int outstanding = static_cast<int>(state.range(0));
+    auto cache = hh::functools::make_lrucache(slow_add, CAPACITY);
+    int next = 0;
+    for (const auto& _ : state) {
+      for (int i = 0; i < outstanding; ++i, ++next) {
+        benchmark::DoNotOptimize(cache(next, next));
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * outstanding);
+  }
+
+  /** Starts a miss on every outstanding key before waiting for any of them. */
+  void benchmark_async_cache_misses(::benchmark::State& state) {
+    const int outstanding = static_cast<int>(state.range(0));
+    const hh::functools::thread_pool_executor executor{static_cast<std::size_t>(outstanding)};
+    auto cache = hh::functools::make_async_lrucache(slow_add, CAPACITY, executor);
+    std::vector<std::shared_future<int>> pending;
+    pending.reserve(outstanding);
+    int next = 0;
+    for (const auto& _ : state) {
+      pending.clear();
+      for (int i = 0; i < outstanding; ++i, ++next) {
+        pending.push_back(cache(next, next));
+      }
+      for (const auto& result : pending) {
+        benchmark::DoNotOptimize(result.get());
+      }
+    }
+    state.SetItemsProcessed(state.iterations() * outstanding);
+  }
+
+  /** Hits on a ready key, the cost of returning a stored future. */
+  void benchmark_async_cache_hits(::benchmark::State& state) {
+    auto cache
+        = hh::functools::make_async_lrucache(add, CAPACITY, hh::functools::inline_executor{});
+    cache(1, 2);
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(1, 2));
+    }
+  }
+}  // namespace
+
+BENCHMARK(benchmark_blocking_cache_misses)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+BENCHMARK(benchmark_async_cache_misses)->Arg(1)->Arg(8)->Arg(64)->UseRealTime();
+BENCHMARK(benchmark_async_cache_hits);
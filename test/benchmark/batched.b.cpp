@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <hh/executor.hpp>
+#include <hh/helpers.hpp>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace {
+  constexpr std::uint64_t KEYS = 4096;
+  constexpr std::size_t MAX_BATCH_SIZE = 64;
+  constexpr auto MAX_WAIT = std::chrono::microseconds(200);
+  constexpr std::size_t PIPELINE_DEPTH = 64;
+
+  std::uint64_t lookup(std::uint64_t key) { return key * 0x9E3779B97F4A7C15ull; }
+
+  std::vector<std::uint64_t> lookup_many(const std::vector<std::tuple<std::uint64_t>>& keys) {
+    std::vector<std::uint64_t> values;
+    values.reserve(keys.size());
+    for (const auto& [key] : keys) {
+      values.push_back(lookup(key));
+    }
+    return values;
+  }
+
+  /**
+   * A backend behind a single connection, paying a round trip of 100 microseconds per call however
+   * many keys it carries, so its throughput is bounded by calls rather than by keys.
+   */
+  std::mutex connection;
+  const auto ROUND_TRIP = hh::helpers::make_delayed<100, std::chrono::microseconds>(lookup);
+  const auto ROUND_TRIP_MANY
+      = hh::helpers::make_delayed<100, std::chrono::microseconds>(lookup_many);
+
+  std::uint64_t backend_lookup(std::uint64_t key) {
+    std::lock_guard<std::mutex> lock{connection};
+    return ROUND_TRIP(key);
+  }
+
+  std::vector<std::uint64_t> backend_lookup_many(
+      const std::vector<std::tuple<std::uint64_t>>& keys) {
+    std::lock_guard<std::mutex> lock{connection};
+    return ROUND_TRIP_MANY(keys);
+  }
+
+  using batched_lookup = decltype(hh::helpers::make_batched(backend_lookup_many, MAX_BATCH_SIZE,
+                                                            MAX_WAIT));
+
+  std::unique_ptr<batched_lookup> shared_batched;
+
+  void benchmark_per_item(::benchmark::State& state) {
+    std::uint64_t key = state.thread_index() * 97;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(backend_lookup(key));
+      key = (key + 1) % KEYS;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  /** Every thread makes blocking calls through one batching wrapper, as request handlers would. */
+  void benchmark_batched(::benchmark::State& state) {
+    if (state.thread_index() == 0) {
+      shared_batched = std::make_unique<batched_lookup>(backend_lookup_many, MAX_BATCH_SIZE,
+                                                        MAX_WAIT,
+                                                        hh::functools::thread_pool_executor{4});
+    }
+    std::uint64_t key = state.thread_index() * 97;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(shared_batched->operator()(key).get());
+      key = (key + 1) % KEYS;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+      state.counters["calls_per_batch"] = ::benchmark::Counter(
+          static_cast<double>(state.iterations()) * state.threads()
+          / static_cast<double>(shared_batched->batches()));
+      shared_batched.reset();
+    }
+  }
+
+  /** One thread keeps a window of calls in flight, waiting only for the oldest. */
+  void benchmark_batched_pipelined(::benchmark::State& state) {
+    auto batched = hh::helpers::make_batched(backend_lookup_many, MAX_BATCH_SIZE, MAX_WAIT,
+                                             hh::functools::thread_pool_executor{4});
+    std::deque<std::future<std::uint64_t>> in_flight;
+    std::uint64_t key = 0;
+    for (const auto& _ : state) {
+      in_flight.push_back(batched(key));
+      key = (key + 1) % KEYS;
+      if (in_flight.size() == PIPELINE_DEPTH) {
+        benchmark::DoNotOptimize(in_flight.front().get());
+        in_flight.pop_front();
+      }
+    }
+    for (auto& pending : in_flight) {
+      benchmark::DoNotOptimize(pending.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["calls_per_batch"] = ::benchmark::Counter(
+        static_cast<double>(state.iterations()) / static_cast<double>(batched.batches()));
+  }
+}  // namespace
+
+BENCHMARK(benchmark_per_item)->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(benchmark_batched)->Threads(1)->Threads(8)->Threads(32)->UseRealTime();
+BENCHMARK(benchmark_batched_pipelined)->UseRealTime();
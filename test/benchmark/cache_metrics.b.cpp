@@ -0,0 +1,40 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/cache_metrics.hpp>
+#include <hh/lru_cache.hpp>
+
+namespace {
+  constexpr static auto CAPACITY = 1024;
+
+  int multiply(int a, int b) { return a * b; }
+
+  template <typename METRICS> void benchmark_metrics_hits(::benchmark::State& state) {
+    hh::functools::basic_lru_cache<int(int, int), hh::functools::lru_eviction,
+                                   hh::functools::unit_weigher, METRICS>
+        cache{multiply, CAPACITY};
+    for (int i = 0; i < CAPACITY; ++i) {
+      cache(i, i);
+    }
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i, i));
+      i = (i + 1) % CAPACITY;
+    }
+  }
+
+  template <typename METRICS> void benchmark_metrics_misses(::benchmark::State& state) {
+    hh::functools::basic_lru_cache<int(int, int), hh::functools::lru_eviction,
+                                   hh::functools::unit_weigher, METRICS>
+        cache{multiply, CAPACITY};
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i, i));
+      ++i;
+    }
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_metrics_hits, hh::functools::no_metrics);
+BENCHMARK_TEMPLATE(benchmark_metrics_hits, hh::functools::atomic_metrics);
+BENCHMARK_TEMPLATE(benchmark_metrics_misses, hh::functools::no_metrics);
+BENCHMARK_TEMPLATE(benchmark_metrics_misses, hh::functools::atomic_metrics);
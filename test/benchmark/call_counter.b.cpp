@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/call_counter.hpp>
+#include <hh/hash.hpp>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr static auto KEYS = 1024;
+
+  int add(int a, int b) { return a + b; }
+
+  /** The single-lock counter every thread contends on, for comparison. */
+  class mutex_call_counter {
+    std::mutex d_mutex;
+    std::unordered_map<std::tuple<int, int>, unsigned long long> d_counts;
+    unsigned long long d_total_calls = 0;
+
+  public:
+    int operator()(int a, int b) {
+      {
+        std::lock_guard<std::mutex> lock{d_mutex};
+        ++d_counts[std::make_tuple(a, b)];
+        ++d_total_calls;
+      }
+      return add(a, b);
+    }
+  };
+
+  mutex_call_counter mutex_counter;
+  hh::functools::basic_call_counter striped_counter{add};
+
+  template <typename COUNTER> void benchmark_counted_calls(::benchmark::State& state,
+                                                           COUNTER& counter) {
+    int i = state.thread_index() * 97;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(counter(i, i));
+      i = (i + 1) % KEYS;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename COUNTER> void benchmark_counted_hot_key(::benchmark::State& state,
+                                                             COUNTER& counter) {
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(counter(1, 2));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_mutex_counter_calls(::benchmark::State& state) {
+    benchmark_counted_calls(state, mutex_counter);
+  }
+
+  void benchmark_striped_counter_calls(::benchmark::State& state) {
+    benchmark_counted_calls(state, striped_counter);
+  }
+
+  void benchmark_mutex_counter_hot_key(::benchmark::State& state) {
+    benchmark_counted_hot_key(state, mutex_counter);
+  }
+
+  void benchmark_striped_counter_hot_key(::benchmark::State& state) {
+    benchmark_counted_hot_key(state, striped_counter);
+  }
+
+  /** Counts calls over ever new arguments, reporting the heap the counter holds afterwards. */
+  template <typename COUNTER> void benchmark_distinct_calls(::benchmark::State& state,
+                                                            COUNTER& counter) {
+    const hh::benchmark::heap_tracking tracking;
+    const auto before = hh::benchmark::heap_usage();
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(counter(i, i));
+      ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.counters["heap_bytes"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().live_bytes - before.live_bytes));
+  }
+
+  void benchmark_exact_counter_distinct_calls(::benchmark::State& state) {
+    hh::functools::basic_call_counter counter{add, 1};
+    benchmark_distinct_calls(state, counter);
+  }
+
+  void benchmark_approximate_counter_distinct_calls(::benchmark::State& state) {
+    hh::functools::basic_approximate_call_counter counter{add, 4096, 4, 64, 1};
+    benchmark_distinct_calls(state, counter);
+  }
+}  // namespace
+
+BENCHMARK(benchmark_mutex_counter_calls)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_striped_counter_calls)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_mutex_counter_hot_key)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_striped_counter_hot_key)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_exact_counter_distinct_calls);
+BENCHMARK(benchmark_approximate_counter_distinct_calls);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <hh/call_counter.hpp>
+#include <hh/lru_cache.hpp>
+
+namespace {
+  int add(int a, int b) { return a + b; }
+
+  constexpr unsigned int MISS_CAPACITY = 1024;
+
+  /** Every call is with new arguments, so each one misses, calls add and evicts. */
+  template <typename CACHE> void cycle_misses(::benchmark::State& state, CACHE& cache) {
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i, i));
+      ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_function_pointer_cache_misses(::benchmark::State& state) {
+    auto cache = hh::functools::make_lrucache(add, MISS_CAPACITY);
+    cycle_misses(state, cache);
+  }
+
+  void benchmark_lambda_cache_misses(::benchmark::State& state) {
+    auto cache = hh::functools::make_lrucache([](int a, int b) { return a + b; }, MISS_CAPACITY);
+    cycle_misses(state, cache);
+  }
+
+  void benchmark_capturing_lambda_cache_misses(::benchmark::State& state) {
+    // Captures as much as make_delayed's lambdas do, more than std::function stores inline.
+    const auto first = add;
+    const auto second = add;
+    const auto third = add;
+    auto cache = hh::functools::make_lrucache(
+        [first, second, third](int a, int b) { return first(a, b) + second(0, 0) + third(0, 0); },
+        MISS_CAPACITY);
+    cycle_misses(state, cache);
+  }
+
+  void benchmark_std_function_cache_misses(::benchmark::State& state) {
+    auto cache = hh::functools::make_lrucache(std::function<int(int, int)>{add}, MISS_CAPACITY);
+    cycle_misses(state, cache);
+  }
+
+  /** Calls repeat a small set of arguments, so only the counting and the call itself are timed. */
+  template <typename COUNTER> void cycle_calls(::benchmark::State& state, COUNTER& counter) {
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(counter(i, i));
+      i = (i + 1) & 63;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_function_pointer_counter_calls(::benchmark::State& state) {
+    hh::functools::basic_call_counter counter{add, 1};
+    cycle_calls(state, counter);
+  }
+
+  void benchmark_std_function_counter_calls(::benchmark::State& state) {
+    hh::functools::basic_call_counter counter{std::function<int(int, int)>{add}, 1};
+    cycle_calls(state, counter);
+  }
+}  // namespace
+
+BENCHMARK(benchmark_function_pointer_cache_misses);
+BENCHMARK(benchmark_lambda_cache_misses);
+BENCHMARK(benchmark_capturing_lambda_cache_misses);
+BENCHMARK(benchmark_std_function_cache_misses);
+BENCHMARK(benchmark_function_pointer_counter_calls);
+BENCHMARK(benchmark_std_function_counter_calls);
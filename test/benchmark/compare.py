@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Compares google benchmark JSON results against a stored baseline.
+
+Benchmarks are matched by name and the median of their repetitions is compared. A benchmark
+regresses when it allocates more per operation or when its hit ratio drops by more than a
+percentage point; these counters are deterministic, so they are always gated. Timings are noisier:
+a single-threaded benchmark regresses when its time grows by more than the threshold, while the
+timings of multi-threaded benchmarks depend on what else the machine runs, so they are only
+reported unless a threaded threshold is given. Benchmarks missing from either file are listed but
+never fail the comparison, and a missing baseline only prints a note, so the first run on a
+machine passes.
+
+Exits with status 1 when any benchmark regressed.
+"""
+
+import argparse
+import json
+import os
+import statistics
+import sys
+
+NANOSECONDS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+HIT_RATIO_TOLERANCE = 0.01
+ALLOCATION_TOLERANCE = 0.01
+
+
+def load(path, metric):
+    """Maps each benchmark name to its median time in nanoseconds and its counters."""
+    with open(path) as results:
+        entries = json.load(results)["benchmarks"]
+    runs = {}
+    medians = {}
+    for entry in entries:
+        name = entry.get("run_name", entry["name"])
+        if entry.get("run_type") == "aggregate":
+            if entry.get("aggregate_name") == "median":
+                medians[name] = entry
+            continue
+        if "error_occurred" in entry:
+            continue
+        runs.setdefault(name, []).append(entry)
+    summaries = {}
+    for name, entries in runs.items():
+        summaries[name] = summarise(entries, metric)
+    for name, entry in medians.items():
+        summaries.setdefault(name, summarise([entry], metric))
+    return summaries
+
+
+def summarise(entries, metric):
+    def median(key):
+        values = [entry[key] for entry in entries if key in entry]
+        return statistics.median(values) if values else None
+
+    unit = NANOSECONDS[entries[0].get("time_unit", "ns")]
+    return {
+        "time": median(metric) * unit,
+        "threads": entries[0].get("threads", 1),
+        "hit_ratio": median("hit_ratio"),
+        "allocations_per_op": median("allocations_per_op"),
+    }
+
+
+def regressions(baseline, current, threshold):
+    """The reasons the current run is worse than the baseline, empty when it is not.
+
+    A threshold of None reports the time without gating it.
+    """
+    reasons = []
+    change = current["time"] / baseline["time"] - 1.0 if baseline["time"] else 0.0
+    if threshold is not None and change > threshold:
+        reasons.append("time {:+.1%}".format(change))
+    if baseline["hit_ratio"] is not None and current["hit_ratio"] is not None:
+        if current["hit_ratio"] < baseline["hit_ratio"] - HIT_RATIO_TOLERANCE:
+            reasons.append("hit ratio {:.3f} -> {:.3f}".format(baseline["hit_ratio"],
+                                                               current["hit_ratio"]))
+    if baseline["allocations_per_op"] is not None and current["allocations_per_op"] is not None:
+        if current["allocations_per_op"] > baseline["allocations_per_op"] + ALLOCATION_TOLERANCE:
+            reasons.append("allocations per op {:.2f} -> {:.2f}".format(
+                baseline["allocations_per_op"], current["allocations_per_op"]))
+    return reasons, change
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("baseline", help="The stored baseline results.")
+    parser.add_argument("current", help="The results to check.")
+    parser.add_argument("--threshold", type=float, default=0.10,
+                        help="The largest accepted relative slowdown of single-threaded "
+                             "benchmarks, 0.10 being 10%%.")
+    parser.add_argument("--threaded-threshold", type=float, default=None,
+                        help="The largest accepted relative slowdown of multi-threaded "
+                             "benchmarks. Their timings are only reported when not given.")
+    parser.add_argument("--metric", choices=["real_time", "cpu_time"], default="real_time",
+                        help="The time which is compared.")
+    arguments = parser.parse_args()
+
+    if not os.path.exists(arguments.baseline):
+        print("No baseline at {}, skipping the comparison.".format(arguments.baseline))
+        return 0
+    baseline = load(arguments.baseline, arguments.metric)
+    current = load(arguments.current, arguments.metric)
+
+    regressed = 0
+    width = max((len(name) for name in current), default=0)
+    for name, result in current.items():
+        if name not in baseline:
+            print("{:<{}}  new".format(name, width))
+            continue
+        threaded = result["threads"] > 1
+        threshold = arguments.threaded_threshold if threaded else arguments.threshold
+        reasons, change = regressions(baseline[name], result, threshold)
+        if reasons:
+            regressed += 1
+            print("{:<{}}  REGRESSED  {}".format(name, width, ", ".join(reasons)))
+        else:
+            gated = "" if threshold is not None else " (not gated)"
+            print("{:<{}}  ok  time {:+.1%}{}".format(name, width, change, gated))
+    for name in baseline:
+        if name not in current:
+            print("{:<{}}  missing".format(name, width))
+
+    if regressed:
+        print("{} of {} benchmarks regressed beyond the baseline.".format(regressed,
+                                                                        len(current)))
+        return 1
+    print("No benchmark regressed beyond the baseline.")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
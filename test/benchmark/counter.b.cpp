@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <hh/counter.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "traces.hpp"
+
+namespace {
+  /** Every benchmark counts this many elements per iteration, in passes over one trace. */
+  constexpr static std::size_t ELEMENTS = 100'000'000;
+  constexpr static std::size_t TRACE_LENGTH = std::size_t{1} << 22;
+  constexpr static std::size_t PASSES = ELEMENTS / TRACE_LENGTH;
+
+  template <typename KEY> const std::vector<KEY>& trace() {
+    static const std::vector<KEY> keys = [] {
+      const auto zipf = hh::benchmark::zipf_trace(TRACE_LENGTH, 1 << 20, 0.99);
+      return std::vector<KEY>(zipf.begin(), zipf.end());
+    }();
+    return keys;
+  }
+
+  template <typename KEY> void benchmark_counter(::benchmark::State& state) {
+    const auto& keys = trace<KEY>();
+    for (const auto& _ : state) {
+      hh::collection::counter<KEY> counted;
+      for (std::size_t pass = 0; pass < PASSES; ++pass) {
+        counted.update(keys.begin(), keys.end());
+      }
+      benchmark::DoNotOptimize(counted.size());
+    }
+    state.SetItemsProcessed(state.iterations() * PASSES * TRACE_LENGTH);
+  }
+
+  template <typename KEY> void benchmark_parallel_counter(::benchmark::State& state) {
+    const auto& keys = trace<KEY>();
+    const hh::collection::parallel_count parallel{static_cast<unsigned int>(state.range(0))};
+    for (const auto& _ : state) {
+      hh::collection::counter<KEY> counted;
+      for (std::size_t pass = 0; pass < PASSES; ++pass) {
+        counted.update(keys.begin(), keys.end(), parallel);
+      }
+      benchmark::DoNotOptimize(counted.size());
+    }
+    state.SetItemsProcessed(state.iterations() * PASSES * TRACE_LENGTH);
+  }
+
+  /** The unordered_map most code would count with, for comparison. */
+  template <typename KEY> void benchmark_unordered_map_count(::benchmark::State& state) {
+    const auto& keys = trace<KEY>();
+    for (const auto& _ : state) {
+      std::unordered_map<KEY, std::int64_t> counted;
+      for (std::size_t pass = 0; pass < PASSES; ++pass) {
+        for (const auto& key : keys) {
+          ++counted[key];
+        }
+      }
+      benchmark::DoNotOptimize(counted.size());
+    }
+    state.SetItemsProcessed(state.iterations() * PASSES * TRACE_LENGTH);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_counter, std::uint8_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_counter, std::uint16_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_counter, std::uint64_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_unordered_map_count, std::uint8_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_unordered_map_count, std::uint64_t)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_parallel_counter, std::uint8_t)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(benchmark_parallel_counter, std::uint64_t)
+    ->RangeMultiplier(2)
+    ->Range(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,61 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <hh/eviction_policy.hpp>
+#include <hh/lru_cache.hpp>
+#include <vector>
+
+#include "traces.hpp"
+
+namespace {
+  constexpr static auto TRACE_LENGTH = 200000;
+  constexpr static auto UNIVERSE = 100000;
+  constexpr static auto CAPACITY = 2000;
+
+  struct zipfian {
+    static const std::vector<std::uint64_t>& trace() {
+      static const auto keys = hh::benchmark::zipf_trace(TRACE_LENGTH, UNIVERSE, 0.9);
+      return keys;
+    }
+  };
+
+  struct scan_heavy {
+    static const std::vector<std::uint64_t>& trace() {
+      static const auto keys
+          = hh::benchmark::scan_trace(TRACE_LENGTH, UNIVERSE, 0.9, 5000, 2 * CAPACITY);
+      return keys;
+    }
+  };
+
+  template <typename EVICTION_POLICY, typename TRACE>
+  void benchmark_trace_replay(::benchmark::State& state) {
+    const auto& trace = TRACE::trace();
+    std::size_t misses = 0;
+    std::function<std::uint64_t(std::uint64_t)> backend = [&misses](std::uint64_t key) {
+      ++misses;
+      return key;
+    };
+    for (const auto& _ : state) {
+      hh::functools::basic_lru_cache<std::uint64_t(std::uint64_t), EVICTION_POLICY> cache{
+          backend, CAPACITY};
+      for (const auto key : trace) {
+        benchmark::DoNotOptimize(cache(key));
+      }
+    }
+    const auto requests = static_cast<double>(trace.size() * state.iterations());
+    state.SetItemsProcessed(static_cast<std::int64_t>(requests));
+    state.counters["hit_ratio"] = 1.0 - static_cast<double>(misses) / requests;
+    state.counters["time_per_op"]
+        = ::benchmark::Counter(requests, ::benchmark::Counter::kIsRate
+                                             | ::benchmark::Counter::kInvert);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::lru_eviction, zipfian);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::segmented_lru_eviction<>, zipfian);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::arc_eviction, zipfian);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::wtinylfu_eviction<>, zipfian);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::lru_eviction, scan_heavy);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::segmented_lru_eviction<>, scan_heavy);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::arc_eviction, scan_heavy);
+BENCHMARK_TEMPLATE(benchmark_trace_replay, hh::functools::wtinylfu_eviction<>, scan_heavy);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/fixed_lru_cache.hpp>
+#include <hh/lru_cache.hpp>
+
+namespace {
+  int multiply(int a, int b) { return a * b; }
+
+  template <std::size_t CAPACITY> void benchmark_fixed_cache_creation(::benchmark::State& state) {
+    for (const auto& _ : state) {
+      auto cache = hh::functools::make_fixed_lrucache<CAPACITY>(multiply);
+      benchmark::DoNotOptimize(cache);
+    }
+  }
+
+  template <std::size_t CAPACITY>
+  void benchmark_dynamic_cache_creation(::benchmark::State& state) {
+    for (const auto& _ : state) {
+      auto cache = hh::functools::make_lrucache(multiply, CAPACITY);
+      benchmark::DoNotOptimize(cache);
+    }
+  }
+
+  template <typename CACHE> void cycle_hits(::benchmark::State& state, CACHE& cache,
+                                            int capacity) {
+    for (int i = 0; i < capacity; ++i) {
+      cache(i, i);
+    }
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i, i));
+      i = i + 1 == capacity ? 0 : i + 1;
+    }
+  }
+
+  template <std::size_t CAPACITY> void benchmark_fixed_cache_hits(::benchmark::State& state) {
+    auto cache = hh::functools::make_fixed_lrucache<CAPACITY>(multiply);
+    cycle_hits(state, cache, CAPACITY);
+  }
+
+  template <std::size_t CAPACITY> void benchmark_dynamic_cache_hits(::benchmark::State& state) {
+    auto cache = hh::functools::make_lrucache(multiply, CAPACITY);
+    cycle_hits(state, cache, CAPACITY);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_creation, 4);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_creation, 16);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_creation, 64);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_creation, 256);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_creation, 4);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_creation, 16);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_creation, 64);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_creation, 256);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_hits, 4);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_hits, 16);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_hits, 64);
+BENCHMARK_TEMPLATE(benchmark_fixed_cache_hits, 256);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_hits, 4);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_hits, 16);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_hits, 64);
+BENCHMARK_TEMPLATE(benchmark_dynamic_cache_hits, 256);
@@ -0,0 +1,111 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/flat_lru_cache.hpp>
+#include <hh/lru_cache.hpp>
+#include <string>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr static auto CAPACITY = 4096;
+
+  int multiply(int a, int b) { return a * b; }
+
+  std::size_t length(const std::string& value) { return value.size(); }
+
+  struct list_engine {
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using cache
+        = hh::functools::lru_cache<RETURN_TYPE, ARGUMENTS...>;
+  };
+
+  struct flat_engine {
+    template <typename RETURN_TYPE, typename... ARGUMENTS> using cache
+        = hh::functools::flat_lru_cache<RETURN_TYPE, ARGUMENTS...>;
+  };
+
+  struct int_tuple_keys {
+    using function_type = int (*)(int, int);
+    static constexpr function_type function = multiply;
+    std::vector<std::pair<int, int>> d_keys;
+
+    explicit int_tuple_keys(int count) {
+      for (int i = 0; i < count; ++i) {
+        d_keys.emplace_back(i, i * 31);
+      }
+    }
+    template <typename CACHE> auto call(CACHE& cache, std::size_t i) const {
+      return cache(d_keys[i].first, d_keys[i].second);
+    }
+  };
+
+  struct string_keys {
+    using function_type = std::size_t (*)(const std::string&);
+    static constexpr function_type function = length;
+    std::vector<std::string> d_keys;
+
+    explicit string_keys(int count) {
+      for (int i = 0; i < count; ++i) {
+        d_keys.emplace_back("a cache key long enough to live on the heap #" + std::to_string(i));
+      }
+    }
+    template <typename CACHE> auto call(CACHE& cache, std::size_t i) const {
+      return cache(d_keys[i]);
+    }
+  };
+
+  template <typename ENGINE, typename RETURN_TYPE, typename... ARGUMENTS>
+  auto make_cache(RETURN_TYPE (*func)(ARGUMENTS...), unsigned int size) {
+    return typename ENGINE::template cache<RETURN_TYPE, ARGUMENTS...>(func, size);
+  }
+
+  template <typename ENGINE, typename KEYS> void benchmark_engine_hits(::benchmark::State& state) {
+    const KEYS keys{CAPACITY};
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    const auto resident_before = hh::benchmark::resident_bytes();
+    auto cache = make_cache<ENGINE>(KEYS::function, CAPACITY);
+    for (std::size_t i = 0; i < CAPACITY; ++i) {
+      keys.call(cache, i);
+    }
+    const auto heap_filled = hh::benchmark::heap_usage();
+    state.counters["heap_bytes"] = static_cast<double>(heap_filled.live_bytes
+                                                       - heap_before.live_bytes);
+    state.counters["rss_bytes"] = static_cast<double>(hh::benchmark::resident_bytes())
+                                  - static_cast<double>(resident_before);
+    std::size_t i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(keys.call(cache, i));
+      i = (i + 1) % CAPACITY;
+    }
+    state.counters["allocations_per_op"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().allocations - heap_filled.allocations),
+        ::benchmark::Counter::kAvgIterations);
+  }
+
+  template <typename ENGINE, typename KEYS>
+  void benchmark_engine_misses(::benchmark::State& state) {
+    // Cycling over twice the capacity makes every call evict the least recently used entry.
+    const KEYS keys{2 * CAPACITY};
+    auto cache = make_cache<ENGINE>(KEYS::function, CAPACITY);
+    std::size_t i = 0;
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(keys.call(cache, i));
+      i = (i + 1) % (2 * CAPACITY);
+    }
+    state.counters["allocations_per_op"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().allocations - heap_before.allocations),
+        ::benchmark::Counter::kAvgIterations);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_engine_hits, list_engine, int_tuple_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_hits, flat_engine, int_tuple_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_hits, list_engine, string_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_hits, flat_engine, string_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_misses, list_engine, int_tuple_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_misses, flat_engine, int_tuple_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_misses, list_engine, string_keys);
+BENCHMARK_TEMPLATE(benchmark_engine_misses, flat_engine, string_keys);
@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <hh/lru_cache.hpp>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+#include "traces.hpp"
+
+namespace {
+  // Large enough that the index and entries spill out of the CPU caches.
+  constexpr static auto CAPACITY = 1u << 20;
+
+  std::uint64_t scramble(std::uint64_t value) { return value * 0x9E3779B97F4A7C15ull; }
+
+  using cache_type = hh::functools::lru_cache<std::uint64_t, std::uint64_t>;
+
+  /** A full cache shared by every run, as filling it dominates the cost of a single run. */
+  cache_type& warm_cache() {
+    static cache_type cache{scramble, CAPACITY};
+    for (std::uint64_t key = cache.size(); key < CAPACITY; ++key) {
+      cache(key);
+    }
+    return cache;
+  }
+
+  /**
+   * Batches of uniformly drawn keys, enough of them that each run cycles through a working set
+   * far larger than the CPU caches, as successive requests would.
+   */
+  std::vector<std::vector<std::tuple<std::uint64_t>>> uniform_batches(std::size_t batch_size) {
+    const std::size_t batch_count = std::max<std::size_t>(CAPACITY / batch_size, 1);
+    const auto trace = hh::benchmark::zipf_trace(batch_count * batch_size, CAPACITY, 0.0, 7);
+    std::vector<std::vector<std::tuple<std::uint64_t>>> batches(batch_count);
+    for (std::size_t i = 0; i < trace.size(); ++i) {
+      batches[i / batch_size].emplace_back(trace[i]);
+    }
+    return batches;
+  }
+
+  void benchmark_single_call_batch(::benchmark::State& state) {
+    auto& cache = warm_cache();
+    const auto batches = uniform_batches(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::uint64_t> results(batches.front().size());
+    std::size_t batch = 0;
+    for (const auto& _ : state) {
+      auto out = results.begin();
+      for (const auto& call : batches[batch]) {
+        *out++ = cache(std::get<0>(call));
+      }
+      batch = (batch + 1) % batches.size();
+      benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void benchmark_get_many_batch(::benchmark::State& state) {
+    auto& cache = warm_cache();
+    const auto batches = uniform_batches(static_cast<std::size_t>(state.range(0)));
+    std::vector<std::uint64_t> results(batches.front().size());
+    std::size_t batch = 0;
+    for (const auto& _ : state) {
+      cache.get_many(batches[batch], results.begin());
+      batch = (batch + 1) % batches.size();
+      benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+}  // namespace
+
+BENCHMARK(benchmark_single_call_batch)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(benchmark_get_many_batch)->Arg(1 << 10)->Arg(1 << 16);
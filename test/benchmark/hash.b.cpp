@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+  constexpr static auto CAPACITY = 1 << 16;
+
+  int multiply(int a, int b) { return a * b; }
+
+  template <typename HASHER, typename KEY> auto key_hash() {
+    return typename HASHER::template hash<KEY>{};
+  }
+
+  template <typename HASHER> void benchmark_hash_int_pair(::benchmark::State& state) {
+    const auto hash = key_hash<HASHER, std::tuple<int, int>>();
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(hash(std::make_tuple(i, i + 1)));
+      ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename HASHER> void benchmark_hash_wide_tuple(::benchmark::State& state) {
+    using key = std::tuple<std::uint64_t, std::uint64_t, std::uint64_t, std::uint32_t>;
+    const auto hash = key_hash<HASHER, key>();
+    std::uint64_t i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(hash(key{i, i + 1, i + 2, static_cast<std::uint32_t>(i)}));
+      ++i;
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename HASHER> void benchmark_hash_string_key(::benchmark::State& state) {
+    using key = std::tuple<std::string, int>;
+    const auto hash = key_hash<HASHER, key>();
+    const key value{std::string(static_cast<std::size_t>(state.range(0)), 'x'), 7};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(hash(value));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+  }
+
+  /**
+   * Hashes a grid of integer pairs into power-of-two buckets by their low bits and reports the
+   * chi-square statistic divided by its degrees of freedom, which is close to 1 for a uniform hash.
+   */
+  template <typename HASHER> void benchmark_hash_chi_square(::benchmark::State& state) {
+    const auto hash = key_hash<HASHER, std::tuple<int, int>>();
+    const auto buckets = static_cast<std::size_t>(state.range(0));
+    constexpr int side = 1024;
+    double statistic = 0.0;
+    for (const auto& _ : state) {
+      std::vector<double> observed(buckets);
+      for (int first = 0; first < side; ++first) {
+        for (int second = 0; second < side; ++second) {
+          ++observed[hash(std::make_tuple(first, second)) & (buckets - 1)];
+        }
+      }
+      const double expected = static_cast<double>(side) * side / static_cast<double>(buckets);
+      statistic = 0.0;
+      for (auto count : observed) {
+        statistic += (count - expected) * (count - expected) / expected;
+      }
+    }
+    state.counters["chi_square_per_dof"] = statistic / static_cast<double>(buckets - 1);
+  }
+
+  template <typename HASHER> void benchmark_hasher_cache_hits(::benchmark::State& state) {
+    hh::functools::basic_lru_cache<int(int, int), hh::functools::lru_eviction,
+                                   hh::functools::unit_weigher, hh::functools::no_metrics, HASHER>
+        cache{multiply, CAPACITY};
+    for (int i = 0; i < CAPACITY; ++i) {
+      cache(i >> 8, i & 255);
+    }
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i >> 8, i & 255));
+      i = (i + 7919) % CAPACITY;
+    }
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_hash_int_pair, hh::functools::combining_hasher);
+BENCHMARK_TEMPLATE(benchmark_hash_int_pair, hh::functools::wy_hasher);
+BENCHMARK_TEMPLATE(benchmark_hash_wide_tuple, hh::functools::combining_hasher);
+BENCHMARK_TEMPLATE(benchmark_hash_wide_tuple, hh::functools::wy_hasher);
+BENCHMARK_TEMPLATE(benchmark_hash_string_key, hh::functools::combining_hasher)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(benchmark_hash_string_key, hh::functools::wy_hasher)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(benchmark_hash_chi_square, hh::functools::combining_hasher)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_hash_chi_square, hh::functools::wy_hasher)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(benchmark_hasher_cache_hits, hh::functools::combining_hasher);
+BENCHMARK_TEMPLATE(benchmark_hasher_cache_hits, hh::functools::wy_hasher);
@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/lru_cache.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr static auto CAPACITY = 1024;
+
+  std::size_t length(const std::string& value) { return value.size(); }
+
+  struct string_arguments {
+    static const std::string& argument(const std::string& key) { return key; }
+  };
+
+  struct string_view_arguments {
+    static std::string_view argument(const std::string& key) { return key; }
+  };
+
+  struct pointer_arguments {
+    static const char* argument(const std::string& key) { return key.c_str(); }
+  };
+
+  template <typename ARGUMENTS> void benchmark_string_key_hits(::benchmark::State& state) {
+    std::vector<std::string> keys;
+    for (int i = 0; i < CAPACITY; ++i) {
+      keys.push_back("a cache key long enough to live on the heap #" + std::to_string(i));
+    }
+    auto cache = hh::functools::make_lrucache(length, CAPACITY);
+    for (const auto& key : keys) {
+      cache(key);
+    }
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    std::size_t i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(ARGUMENTS::argument(keys[i])));
+      i = (i + 1) % CAPACITY;
+    }
+    state.counters["allocations_per_op"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().allocations - heap_before.allocations),
+        ::benchmark::Counter::kAvgIterations);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_string_key_hits, string_arguments);
+BENCHMARK_TEMPLATE(benchmark_string_key_hits, string_view_arguments);
+BENCHMARK_TEMPLATE(benchmark_string_key_hits, pointer_arguments);
@@ -1,7 +1,12 @@
 #include <benchmark/benchmark.h>
 
+#include <hh/call_counter.hpp>
 #include <hh/helpers.hpp>
 #include <hh/lru_cache.hpp>
+#include <hh/sharded_lru_cache.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 int add(int a, int b) { return a + b; }
 
@@ -25,6 +30,78 @@ void benchmark_cache_usage_1ms(::benchmark::State& state) {
   }
 }
 
+constexpr static auto CONCURRENT_KEYS = 4096;
+
+void benchmark_mutex_cache_hits(::benchmark::State& state) {
+  static std::mutex mutex;
+  static auto cached_add = [] {
+    auto cache = hh::functools::make_lrucache(add, CONCURRENT_KEYS);
+    for (int i = 0; i < CONCURRENT_KEYS; ++i) {
+      cache(i, i);
+    }
+    return cache;
+  }();
+  int i = state.thread_index() * 97;
+  for (const auto& _ : state) {
+    std::lock_guard<std::mutex> lock{mutex};
+    benchmark::DoNotOptimize(cached_add(i % CONCURRENT_KEYS, i % CONCURRENT_KEYS));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void benchmark_sharded_cache_hits(::benchmark::State& state) {
+  static auto cached_add = [] {
+    // Capacity is split per shard, so leave headroom for uneven key distribution.
+    auto cache = hh::functools::make_sharded_lrucache(add, 2 * CONCURRENT_KEYS, 64);
+    for (int i = 0; i < CONCURRENT_KEYS; ++i) {
+      cache(i, i);
+    }
+    return cache;
+  }();
+  int i = state.thread_index() * 97;
+  for (const auto& _ : state) {
+    benchmark::DoNotOptimize(cached_add(i % CONCURRENT_KEYS, i % CONCURRENT_KEYS));
+    ++i;
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void benchmark_sharded_cache_cold_start(::benchmark::State& state) {
+  constexpr static auto CALLERS = 16;
+  constexpr static auto COLD_KEYS = 32;
+  const auto strategy = static_cast<hh::functools::miss_strategy>(state.range(0));
+  std::mutex counter_mutex;
+  hh::functools::call_counter counter{add};
+  std::function<int(int, int)> backend = [&](int a, int b) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::lock_guard<std::mutex> lock{counter_mutex};
+    return counter(a, b);
+  };
+  for (const auto& _ : state) {
+    auto cached_add = hh::functools::make_sharded_lrucache(backend, 2 * COLD_KEYS, 16, strategy);
+    std::vector<std::thread> callers;
+    for (int t = 0; t < CALLERS; ++t) {
+      callers.emplace_back([&cached_add]() {
+        for (int i = 0; i < COLD_KEYS; ++i) {
+          benchmark::DoNotOptimize(cached_add(i, i));
+        }
+      });
+    }
+    for (auto& caller : callers) {
+      caller.join();
+    }
+  }
+  state.counters["invocations_per_cold_start"] = ::benchmark::Counter(
+      static_cast<double>(counter.total_calls()), ::benchmark::Counter::kAvgIterations);
+}
+
 BENCHMARK(benchmark_cache_creation);
 BENCHMARK(benchmark_cache_usage_1ms);
+BENCHMARK(benchmark_mutex_cache_hits)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_sharded_cache_hits)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(benchmark_sharded_cache_cold_start)
+    ->Arg(static_cast<int>(hh::functools::miss_strategy::independent))
+    ->Arg(static_cast<int>(hh::functools::miss_strategy::coalesce))
+    ->UseRealTime();
 BENCHMARK_MAIN();
@@ -0,0 +1,193 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <hh/memoize.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr int FIBONACCI_N = 90;
+  constexpr std::size_t TEXT_LENGTH = 128;
+  constexpr std::size_t ITEMS = 64;
+  constexpr std::size_t KNAPSACK_CAPACITY = 512;
+
+  std::string random_text(std::uint32_t seed) {
+    std::mt19937 engine{seed};
+    std::uniform_int_distribution<int> letter{'a', 'd'};
+    std::string text(TEXT_LENGTH, ' ');
+    for (auto& character : text) {
+      character = static_cast<char>(letter(engine));
+    }
+    return text;
+  }
+
+  const std::string FROM = random_text(1);
+  const std::string TO = random_text(2);
+
+  struct item {
+    std::size_t d_weight;
+    std::uint64_t d_value;
+  };
+
+  const std::vector<item> ITEM_SET = [] {
+    std::mt19937 engine{3};
+    std::uniform_int_distribution<std::size_t> weight{1, 64};
+    std::uniform_int_distribution<std::uint64_t> value{1, 100};
+    std::vector<item> items(ITEMS);
+    for (auto& chosen : items) {
+      chosen = item{weight(engine), value(engine)};
+    }
+    return items;
+  }();
+
+  struct fibonacci {
+    template <typename SELF> std::uint64_t operator()(SELF& self, int n) const {
+      return n < 2 ? n : self(n - 1) + self(n - 2);
+    }
+  };
+
+  struct edit_distance {
+    template <typename SELF>
+    std::size_t operator()(SELF& self, std::size_t i, std::size_t j) const {
+      if (i == 0 || j == 0) {
+        return i + j;
+      }
+      const std::size_t substitute = self(i - 1, j - 1) + (FROM[i - 1] != TO[j - 1]);
+      return std::min({substitute, self(i - 1, j) + 1, self(i, j - 1) + 1});
+    }
+  };
+
+  struct knapsack {
+    template <typename SELF>
+    std::uint64_t operator()(SELF& self, std::size_t index, std::size_t capacity) const {
+      if (index == ITEM_SET.size()) {
+        return 0;
+      }
+      const std::uint64_t skipped = self(index + 1, capacity);
+      const item& chosen = ITEM_SET[index];
+      if (chosen.d_weight > capacity) {
+        return skipped;
+      }
+      return std::max(skipped, chosen.d_value + self(index + 1, capacity - chosen.d_weight));
+    }
+  };
+
+  /** Times solving the problem with a fresh memo each iteration, reporting its allocations. */
+  template <typename MAKE_MEMO, typename SOLVE>
+  void solve_fresh(::benchmark::State& state, MAKE_MEMO&& make_memo, SOLVE&& solve) {
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    for (const auto& _ : state) {
+      auto memo = make_memo();
+      benchmark::DoNotOptimize(solve(memo));
+    }
+    state.counters["allocations_per_solve"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().allocations - heap_before.allocations),
+        ::benchmark::Counter::kAvgIterations);
+  }
+
+  void benchmark_fibonacci_lru(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] { return hh::functools::memoize_recursive<std::uint64_t(int)>(fibonacci{}, 128); },
+        [](auto& memo) { return memo(FIBONACCI_N); });
+  }
+
+  void benchmark_fibonacci_unbounded(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] {
+          return hh::functools::memoize_recursive_unbounded<std::uint64_t(int)>(fibonacci{},
+                                                                                FIBONACCI_N + 1);
+        },
+        [](auto& memo) { return memo(FIBONACCI_N); });
+  }
+
+  void benchmark_fibonacci_bottom_up(::benchmark::State& state) {
+    for (const auto& _ : state) {
+      std::uint64_t previous = 0;
+      std::uint64_t current = 1;
+      for (int n = 1; n < FIBONACCI_N; ++n) {
+        previous = std::exchange(current, current + previous);
+        benchmark::DoNotOptimize(current);
+      }
+      benchmark::DoNotOptimize(current);
+    }
+  }
+
+  constexpr std::size_t EDIT_KEYS = (TEXT_LENGTH + 1) * (TEXT_LENGTH + 1);
+
+  void benchmark_edit_distance_lru(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] {
+          return hh::functools::memoize_recursive<std::size_t(std::size_t, std::size_t)>(
+              edit_distance{}, 0);
+        },
+        [](auto& memo) { return memo(TEXT_LENGTH, TEXT_LENGTH); });
+  }
+
+  void benchmark_edit_distance_unbounded(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] {
+          return hh::functools::memoize_recursive_unbounded<std::size_t(std::size_t, std::size_t)>(
+              edit_distance{}, EDIT_KEYS);
+        },
+        [](auto& memo) { return memo(TEXT_LENGTH, TEXT_LENGTH); });
+  }
+
+  void benchmark_edit_distance_bottom_up(::benchmark::State& state) {
+    for (const auto& _ : state) {
+      std::vector<std::size_t> row(TEXT_LENGTH + 1);
+      for (std::size_t j = 0; j <= TEXT_LENGTH; ++j) {
+        row[j] = j;
+      }
+      for (std::size_t i = 1; i <= TEXT_LENGTH; ++i) {
+        std::size_t diagonal = row[0];
+        row[0] = i;
+        for (std::size_t j = 1; j <= TEXT_LENGTH; ++j) {
+          const std::size_t above = row[j];
+          row[j] = std::min({diagonal + (FROM[i - 1] != TO[j - 1]), above + 1, row[j - 1] + 1});
+          diagonal = above;
+        }
+      }
+      benchmark::DoNotOptimize(row[TEXT_LENGTH]);
+    }
+  }
+
+  constexpr std::size_t KNAPSACK_KEYS = (ITEMS + 1) * (KNAPSACK_CAPACITY + 1);
+
+  void benchmark_knapsack_lru(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] {
+          return hh::functools::memoize_recursive<std::uint64_t(std::size_t, std::size_t)>(
+              knapsack{}, 0);
+        },
+        [](auto& memo) { return memo(0, KNAPSACK_CAPACITY); });
+  }
+
+  void benchmark_knapsack_unbounded(::benchmark::State& state) {
+    solve_fresh(
+        state,
+        [] {
+          return hh::functools::memoize_recursive_unbounded<
+              std::uint64_t(std::size_t, std::size_t)>(knapsack{}, KNAPSACK_KEYS);
+        },
+        [](auto& memo) { return memo(0, KNAPSACK_CAPACITY); });
+  }
+}  // namespace
+
+BENCHMARK(benchmark_fibonacci_lru);
+BENCHMARK(benchmark_fibonacci_unbounded);
+BENCHMARK(benchmark_fibonacci_bottom_up);
+BENCHMARK(benchmark_edit_distance_lru);
+BENCHMARK(benchmark_edit_distance_unbounded);
+BENCHMARK(benchmark_edit_distance_bottom_up);
+BENCHMARK(benchmark_knapsack_lru);
+BENCHMARK(benchmark_knapsack_unbounded);
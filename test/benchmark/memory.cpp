@@ -0,0 +1,111 @@
+#include "memory.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+#include <unistd.h>
+
+namespace {
+  thread_local int t_trackers = 0;
+  std::atomic<std::size_t> g_allocations{0};
+  std::atomic<std::size_t> g_live_bytes{0};
+
+  // Blocks come straight from malloc, so frees need no header to be accounted for: the usable
+  // size malloc reports is counted on both sides. Only threads holding a heap_tracking count, and
+  // a block allocated untracked and freed tracked is subtracted without having been added, which
+  // the unsigned counters absorb as long as the measured difference is not negative.
+  void* tracked_allocate(std::size_t size, std::size_t alignment) {
+    const std::size_t requested = size == 0 ? 1 : size;
+    void* block = alignment == 0 ? std::malloc(requested)
+                                 : std::aligned_alloc(alignment, (requested + alignment - 1)
+                                                                     / alignment * alignment);
+    if (block == nullptr) {
+      throw std::bad_alloc{};
+    }
+    if (t_trackers != 0) {
+      g_allocations.fetch_add(1, std::memory_order_relaxed);
+      g_live_bytes.fetch_add(malloc_usable_size(block), std::memory_order_relaxed);
+    }
+    return block;
+  }
+
+  void tracked_free(void* pointer) noexcept {
+    if (pointer != nullptr && t_trackers != 0) {
+      g_live_bytes.fetch_sub(malloc_usable_size(pointer), std::memory_order_relaxed);
+    }
+    std::free(pointer);
+  }
+}  // namespace
+
+void* operator new(std::size_t size) { return tracked_allocate(size, 0); }
+void* operator new[](std::size_t size) { return tracked_allocate(size, 0); }
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return tracked_allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return tracked_allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* pointer) noexcept { tracked_free(pointer); }
+void operator delete[](void* pointer) noexcept { tracked_free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { tracked_free(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { tracked_free(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { tracked_free(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { tracked_free(pointer); }
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept {
+  tracked_free(pointer);
+}
+void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept {
+  tracked_free(pointer);
+}
+
+namespace hh::benchmark {
+
+  heap_tracking::heap_tracking() { ++t_trackers; }
+
+  heap_tracking::~heap_tracking() { --t_trackers; }
+
+  heap_snapshot heap_usage() {
+    return {g_allocations.load(std::memory_order_relaxed),
+            g_live_bytes.load(std::memory_order_relaxed)};
+  }
+
+  std::size_t resident_bytes() {
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+      return 0;
+    }
+    unsigned long total_pages = 0;
+    unsigned long resident_pages = 0;
+    const int read = std::fscanf(statm, "%lu %lu", &total_pages, &resident_pages);
+    std::fclose(statm);
+    return read == 2 ? resident_pages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE)) : 0;
+  }
+
+  std::size_t peak_resident_bytes() {
+    std::FILE* status = std::fopen("/proc/self/status", "r");
+    if (status == nullptr) {
+      return 0;
+    }
+    char line[256];
+    unsigned long peak_kilobytes = 0;
+    while (std::fgets(line, sizeof(line), status) != nullptr) {
+      if (std::sscanf(line, "VmHWM: %lu kB", &peak_kilobytes) == 1) {
+        break;
+      }
+    }
+    std::fclose(status);
+    return peak_kilobytes * 1024;
+  }
+
+  void reset_peak_resident_bytes() {
+    // Writing 5 to clear_refs resets VmHWM to the current resident set size.
+    std::FILE* clear_refs = std::fopen("/proc/self/clear_refs", "w");
+    if (clear_refs != nullptr) {
+      std::fputs("5", clear_refs);
+      std::fclose(clear_refs);
+    }
+  }
+
+}  // namespace hh::benchmark
@@ -0,0 +1,47 @@
+#ifndef INCLUDED_HH_BENCHMARK_MEMORY_HPP
+#define INCLUDED_HH_BENCHMARK_MEMORY_HPP
+#include <cstddef>
+
+namespace hh::benchmark {
+
+  /**
+   * Heap activity observed by the global operator new/delete replacements in memory.cpp on threads
+   * holding a heap_tracking.
+   *
+   * The counters are process wide, so callers should take a snapshot before and after the region
+   * they want to measure, with tracking on throughout, and report the difference.
+   */
+  struct heap_snapshot {
+    std::size_t allocations = 0; /** Number of tracked calls to any operator new. */
+    std::size_t live_bytes = 0;  /** Usable bytes of tracked allocations less tracked frees. */
+  };
+
+  /**
+   * Turns heap counting on for the calling thread for as long as it lives.
+   *
+   * Counting is off otherwise, so operator new and delete go straight to malloc and free, and
+   * benchmarks which do not report heap activity are timed without its cost.
+   */
+  class heap_tracking {
+  public:
+    heap_tracking();
+    ~heap_tracking();
+    heap_tracking(const heap_tracking&) = delete;
+    heap_tracking& operator=(const heap_tracking&) = delete;
+  };
+
+  /** The current heap counters. */
+  heap_snapshot heap_usage();
+
+  /** The resident set size of this process in bytes, or 0 where it cannot be read. */
+  std::size_t resident_bytes();
+
+  /** The peak resident set size of this process in bytes, or 0 where it cannot be read. */
+  std::size_t peak_resident_bytes();
+
+  /** Resets the peak resident set size to the current one, where the system allows it. */
+  void reset_peak_resident_bytes();
+
+}  // namespace hh::benchmark
+
+#endif
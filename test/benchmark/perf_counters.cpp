@@ -0,0 +1,121 @@
+#include "perf_counters.hpp"
+
+#if defined(__linux__)
+#  include <linux/perf_event.h>
+#  include <sys/ioctl.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+
+#  include <cstring>
+#endif
+
+namespace hh::benchmark {
+
+#if defined(__linux__)
+  namespace {
+    int open_event(perf_counters::event counted) {
+      perf_event_attr attributes;
+      std::memset(&attributes, 0, sizeof(attributes));
+      attributes.size = sizeof(attributes);
+      attributes.disabled = 1;
+      attributes.exclude_kernel = 1;
+      attributes.exclude_hv = 1;
+      attributes.type = PERF_TYPE_HARDWARE;
+      switch (counted) {
+        case perf_counters::instructions:
+          attributes.config = PERF_COUNT_HW_INSTRUCTIONS;
+          break;
+        case perf_counters::cycles:
+          attributes.config = PERF_COUNT_HW_CPU_CYCLES;
+          break;
+        case perf_counters::cache_misses:
+          attributes.config = PERF_COUNT_HW_CACHE_MISSES;
+          break;
+        case perf_counters::branch_misses:
+          attributes.config = PERF_COUNT_HW_BRANCH_MISSES;
+          break;
+        case perf_counters::page_faults:
+          attributes.type = PERF_TYPE_SOFTWARE;
+          attributes.config = PERF_COUNT_SW_PAGE_FAULTS;
+          break;
+        case perf_counters::event_count:
+          return -1;
+      }
+      return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+  }  // namespace
+
+  perf_counters::perf_counters() {
+    for (int counted = 0; counted < event_count; ++counted) {
+      d_descriptors[counted] = open_event(static_cast<event>(counted));
+    }
+  }
+
+  perf_counters::~perf_counters() {
+    for (const int descriptor : d_descriptors) {
+      if (descriptor >= 0) {
+        close(descriptor);
+      }
+    }
+  }
+
+  void perf_counters::start() {
+    for (const int descriptor : d_descriptors) {
+      if (descriptor >= 0) {
+        ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+        ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+  }
+
+  perf_counters::sample perf_counters::stop() {
+    sample totals;
+    for (int counted = 0; counted < event_count; ++counted) {
+      const int descriptor = d_descriptors[counted];
+      if (descriptor < 0) {
+        continue;
+      }
+      ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+      std::uint64_t value = 0;
+      if (read(descriptor, &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value))) {
+        totals.d_values[counted] = value;
+        totals.d_available[counted] = true;
+      }
+    }
+    return totals;
+  }
+#else
+  perf_counters::perf_counters() { d_descriptors.fill(-1); }
+  perf_counters::~perf_counters() = default;
+  void perf_counters::start() {}
+  perf_counters::sample perf_counters::stop() { return {}; }
+#endif
+
+  bool perf_counters::available() const {
+    for (const int descriptor : d_descriptors) {
+      if (descriptor >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  const char* perf_counters::name(event counted) {
+    switch (counted) {
+      case instructions:
+        return "instructions";
+      case cycles:
+        return "cycles";
+      case cache_misses:
+        return "cache_misses";
+      case branch_misses:
+        return "branch_misses";
+      case page_faults:
+        return "page_faults";
+      case event_count:
+        break;
+    }
+    return "unknown";
+  }
+
+}  // namespace hh::benchmark
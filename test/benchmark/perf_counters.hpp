@@ -0,0 +1,49 @@
+#ifndef INCLUDED_HH_BENCHMARK_PERF_COUNTERS_HPP
+#define INCLUDED_HH_BENCHMARK_PERF_COUNTERS_HPP
+#include <array>
+#include <cstdint>
+
+namespace hh::benchmark {
+
+  /**
+   * Hardware and kernel event counters of the calling thread, read through Linux perf events.
+   *
+   * Each event is opened on its own, so events the machine or its permissions do not offer, such
+   * as hardware counters inside most virtual machines, are skipped while the others are still
+   * counted. Everywhere but Linux no event is available. Only user-space events are counted.
+   */
+  class perf_counters {
+  public:
+    enum event { instructions, cycles, cache_misses, branch_misses, page_faults, event_count };
+
+    /** Event totals between start() and stop(), for the events which could be opened. */
+    struct sample {
+      std::array<std::uint64_t, event_count> d_values{};
+      std::array<bool, event_count> d_available{};
+    };
+
+    /** Opens every event available to this thread, without counting yet. */
+    perf_counters();
+    ~perf_counters();
+    perf_counters(const perf_counters&) = delete;
+    perf_counters& operator=(const perf_counters&) = delete;
+
+    /** Whether any event could be opened. */
+    bool available() const;
+
+    /** Resets and starts every open event. */
+    void start();
+
+    /** Stops every open event and returns their totals since start(). */
+    sample stop();
+
+    /** The counter name of an event, such as "instructions". */
+    static const char* name(event counted);
+
+  private:
+    std::array<int, event_count> d_descriptors;
+  };
+
+}  // namespace hh::benchmark
+
+#endif
@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <hh/rand.hpp>
+#include <random>
+#include <vector>
+
+namespace {
+  constexpr std::size_t BATCH = 4096;
+  constexpr std::uint64_t KEYS = 1 << 20;
+  constexpr double SKEW = 0.99;
+
+  template <typename GENERATOR> void benchmark_words(::benchmark::State& state) {
+    GENERATOR generator{42};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(generator());
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename GENERATOR> void benchmark_fill(::benchmark::State& state) {
+    GENERATOR generator{42};
+    std::vector<std::uint64_t> words(BATCH);
+    for (const auto& _ : state) {
+      generator.fill(words.data(), words.data() + words.size());
+      benchmark::DoNotOptimize(words.data());
+      benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * BATCH);
+  }
+
+  void benchmark_std_uniform_int(::benchmark::State& state) {
+    std::mt19937_64 generator{42};
+    std::uniform_int_distribution<std::uint64_t> uniform{0, KEYS - 1};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(uniform(generator));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_uniform_below(::benchmark::State& state) {
+    hh::rand::xoshiro256ss generator{42};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(hh::rand::uniform_below(generator, KEYS));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  /** Zipf by inverting a table of the cumulative distribution, the standard library way. */
+  void benchmark_std_zipf(::benchmark::State& state) {
+    std::vector<double> cumulative(KEYS);
+    double total = 0.0;
+    for (std::uint64_t rank = 0; rank < KEYS; ++rank) {
+      total += std::pow(static_cast<double>(rank + 1), -SKEW);
+      cumulative[rank] = total;
+    }
+    std::mt19937_64 generator{42};
+    std::uniform_real_distribution<double> uniform{0.0, total};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(
+          std::lower_bound(cumulative.begin(), cumulative.end(), uniform(generator))
+          - cumulative.begin());
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  template <typename DISTRIBUTION> void benchmark_distribution(::benchmark::State& state,
+                                                               const DISTRIBUTION& distribution) {
+    hh::rand::xoshiro256ss generator{42};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(distribution(generator));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_zipf(::benchmark::State& state) {
+    benchmark_distribution(state, hh::rand::zipf_distribution{KEYS, SKEW});
+  }
+
+  void benchmark_scrambled_zipf(::benchmark::State& state) {
+    benchmark_distribution(state, hh::rand::scrambled_zipf_distribution{KEYS, SKEW});
+  }
+
+  /** A hot set drawn with a bernoulli choice and two uniform distributions. */
+  void benchmark_std_hotset(::benchmark::State& state) {
+    std::mt19937_64 generator{42};
+    std::bernoulli_distribution is_hot{0.8};
+    std::uniform_int_distribution<std::uint64_t> hot{0, KEYS / 5 - 1};
+    std::uniform_int_distribution<std::uint64_t> cold{KEYS / 5, KEYS - 1};
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(is_hot(generator) ? hot(generator) : cold(generator));
+    }
+    state.SetItemsProcessed(state.iterations());
+  }
+
+  void benchmark_hotset(::benchmark::State& state) {
+    benchmark_distribution(state, hh::rand::hotset_distribution{KEYS, 0.2, 0.8});
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_words, std::mt19937_64);
+BENCHMARK_TEMPLATE(benchmark_words, hh::rand::xoshiro256ss);
+BENCHMARK_TEMPLATE(benchmark_words, hh::rand::pcg32);
+BENCHMARK_TEMPLATE(benchmark_fill, hh::rand::xoshiro256ss);
+BENCHMARK_TEMPLATE(benchmark_fill, hh::rand::xoshiro256ss_lanes<4>);
+BENCHMARK_TEMPLATE(benchmark_fill, hh::rand::xoshiro256ss_lanes<8>);
+BENCHMARK(benchmark_std_uniform_int);
+BENCHMARK(benchmark_uniform_below);
+BENCHMARK(benchmark_std_zipf);
+BENCHMARK(benchmark_zipf);
+BENCHMARK(benchmark_scrambled_zipf);
+BENCHMARK(benchmark_std_hotset);
+BENCHMARK(benchmark_hotset);
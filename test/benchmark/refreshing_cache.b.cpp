@@ -0,0 +1,47 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <hh/helpers.hpp>
+#include <hh/refreshing_cache.hpp>
+#include <hh/ttl_cache.hpp>
+
+namespace {
+  using namespace std::chrono_literals;
+  constexpr static auto HOT_KEYS = 64;
+
+  int square(int value) { return value * value; }
+
+  /** A loader taking 1ms, against which entries go stale every 100us of simulated time. */
+  const auto slow_square = hh::helpers::make_delayed<1>(square);
+
+  void benchmark_ttl_cache_hot_keys(::benchmark::State& state) {
+    hh::helpers::manual_clock clock;
+    hh::functools::basic_ttl_cache<int(int), hh::helpers::manual_clock> cache{
+        slow_square, HOT_KEYS, 5ms, clock};
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i));
+      i = (i + 1) % HOT_KEYS;
+      clock.advance(100us);
+    }
+  }
+
+  void benchmark_refreshing_cache_hot_keys(::benchmark::State& state) {
+    hh::helpers::manual_clock clock;
+    hh::functools::basic_refreshing_cache<int(int), hh::helpers::manual_clock> cache{
+        slow_square, HOT_KEYS, 5ms, 0ms, 4, clock};
+    for (int i = 0; i < HOT_KEYS; ++i) {
+      cache(i);
+    }
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i));
+      i = (i + 1) % HOT_KEYS;
+      clock.advance(100us);
+    }
+    cache.wait_for_refreshes();
+  }
+}  // namespace
+
+BENCHMARK(benchmark_ttl_cache_hot_keys)->UseRealTime();
+BENCHMARK(benchmark_refreshing_cache_hot_keys)->UseRealTime();
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <hh/lru_cache.hpp>
+#include <hh/snapshot.hpp>
+#include <string>
+
+namespace {
+  int square(int value) { return value * value; }
+
+  std::string snapshot_path(int entries) {
+    return "/tmp/hh_snapshot_benchmark_" + std::to_string(entries) + ".bin";
+  }
+
+  /** Fills a cache of the given size and saves it, as a deploy would before restarting. */
+  void save_full_cache(int entries) {
+    auto cache = hh::functools::make_lrucache(square, static_cast<unsigned int>(entries));
+    for (int value = 0; value < entries; ++value) {
+      cache(value);
+    }
+    cache.save(snapshot_path(entries));
+  }
+
+  void benchmark_cold_start(::benchmark::State& state) {
+    const auto entries = static_cast<int>(state.range(0));
+    for (const auto& _ : state) {
+      auto cache = hh::functools::make_lrucache(square, static_cast<unsigned int>(entries));
+      for (int value = 0; value < entries; ++value) {
+        cache(value);
+      }
+      benchmark::DoNotOptimize(cache.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+  }
+
+  void benchmark_warm_start(::benchmark::State& state) {
+    const auto entries = static_cast<int>(state.range(0));
+    save_full_cache(entries);
+    for (const auto& _ : state) {
+      auto cache = hh::functools::make_lrucache(square, static_cast<unsigned int>(entries));
+      cache.load(snapshot_path(entries));
+      benchmark::DoNotOptimize(cache.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(snapshot_path(entries).c_str());
+  }
+
+  void benchmark_save(::benchmark::State& state) {
+    const auto entries = static_cast<int>(state.range(0));
+    auto cache = hh::functools::make_lrucache(square, static_cast<unsigned int>(entries));
+    for (int value = 0; value < entries; ++value) {
+      cache(value);
+    }
+    for (const auto& _ : state) {
+      cache.save(snapshot_path(entries));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    std::remove(snapshot_path(entries).c_str());
+  }
+}  // namespace
+
+BENCHMARK(benchmark_cold_start)->Arg(1 << 20)->Arg(10000000)->Unit(::benchmark::kMillisecond);
+BENCHMARK(benchmark_warm_start)->Arg(1 << 20)->Arg(10000000)->Unit(::benchmark::kMillisecond);
+BENCHMARK(benchmark_save)->Arg(1 << 20)->Arg(10000000)->Unit(::benchmark::kMillisecond);
@@ -0,0 +1,135 @@
+#ifndef INCLUDED_HH_BENCHMARK_TRACES_HPP
+#define INCLUDED_HH_BENCHMARK_TRACES_HPP
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <hh/rand.hpp>
+#include <random>
+#include <vector>
+
+namespace hh::benchmark {
+
+  /**
+   * A key trace drawn from a Zipfian distribution over [0, universe), key 0 being the most popular.
+   *
+   * @param length The number of keys in the trace.
+   * @param universe The number of distinct keys which can be drawn.
+   * @param skew The Zipf exponent, larger values concentrating requests on fewer keys.
+   * @param seed The seed making the trace reproducible.
+   */
+  inline std::vector<std::uint64_t> zipf_trace(std::size_t length, std::size_t universe,
+                                               double skew, std::uint64_t seed = 42) {
+    std::vector<double> cumulative(universe);
+    double total = 0.0;
+    for (std::size_t rank = 0; rank < universe; ++rank) {
+      total += 1.0 / std::pow(static_cast<double>(rank + 1), skew);
+      cumulative[rank] = total;
+    }
+    std::mt19937_64 engine{seed};
+    std::uniform_real_distribution<double> uniform{0.0, total};
+    std::vector<std::uint64_t> trace(length);
+    for (auto& key : trace) {
+      key = static_cast<std::uint64_t>(
+          std::lower_bound(cumulative.begin(), cumulative.end(), uniform(engine))
+          - cumulative.begin());
+    }
+    return trace;
+  }
+
+  /**
+   * Interleaves a trace with sequential scans of keys from universe upwards, which are never
+   * requested again.
+   *
+   * @param base The trace the scans interrupt.
+   * @param universe The first scanned key, above every key of the base trace.
+   * @param scan_every The number of base requests between two scans.
+   * @param scan_length The number of one-off keys in each scan.
+   */
+  inline std::vector<std::uint64_t> interleave_scans(const std::vector<std::uint64_t>& base,
+                                                     std::size_t universe, std::size_t scan_every,
+                                                     std::size_t scan_length) {
+    std::vector<std::uint64_t> trace;
+    trace.reserve(base.size());
+    std::uint64_t next_scan_key = universe;
+    for (std::size_t i = 0; trace.size() < base.size(); ++i) {
+      trace.push_back(base[i]);
+      if ((i + 1) % scan_every == 0) {
+        for (std::size_t j = 0; j < scan_length && trace.size() < base.size(); ++j) {
+          trace.push_back(next_scan_key++);
+        }
+      }
+    }
+    return trace;
+  }
+
+  /**
+   * A Zipfian trace interrupted by sequential scans of keys which are never requested again, the
+   * access pattern of batch jobs running alongside interactive traffic.
+   *
+   * @param length The number of keys in the trace.
+   * @param universe The number of distinct keys in the Zipfian part of the trace.
+   * @param skew The Zipf exponent of the Zipfian part of the trace.
+   * @param scan_every The number of Zipfian requests between two scans.
+   * @param scan_length The number of one-off keys in each scan.
+   */
+  inline std::vector<std::uint64_t> scan_trace(std::size_t length, std::size_t universe,
+                                               double skew, std::size_t scan_every,
+                                               std::size_t scan_length) {
+    return interleave_scans(zipf_trace(length, universe, skew), universe, scan_every,
+                            scan_length);
+  }
+
+  /** The key traces of the workload suite. */
+  enum class trace_kind {
+    zipf,     /** Scrambled Zipfian popularity with exponent 0.9. */
+    uniform,  /** Every key equally likely. */
+    scan_mix  /** Scrambled Zipfian requests interrupted by one-off scans. */
+  };
+
+  /** The name of a trace kind, for benchmark labels. */
+  inline const char* trace_name(trace_kind kind) {
+    switch (kind) {
+      case trace_kind::zipf:
+        return "zipf";
+      case trace_kind::uniform:
+        return "uniform";
+      case trace_kind::scan_mix:
+        return "scan_mix";
+    }
+    return "unknown";
+  }
+
+  /**
+   * A trace of the given kind over [0, universe), scan keys lying above it.
+   *
+   * Unlike zipf_trace this samples in constant memory, so universes of tens of millions of keys
+   * are cheap, and scatters the popular keys over the key space as YCSB does.
+   *
+   * @param kind The popularity of the keys.
+   * @param length The number of keys in the trace.
+   * @param universe The number of distinct keys which can be drawn outside scans.
+   * @param seed The seed making the trace reproducible.
+   */
+  inline std::vector<std::uint64_t> make_trace(trace_kind kind, std::size_t length,
+                                               std::size_t universe, std::uint64_t seed = 42) {
+    hh::rand::xoshiro256ss generator{seed};
+    std::vector<std::uint64_t> trace(length);
+    if (kind == trace_kind::uniform) {
+      for (auto& key : trace) {
+        key = hh::rand::uniform_below(generator, universe);
+      }
+      return trace;
+    }
+    hh::rand::scrambled_zipf_distribution{universe, 0.9, seed}.fill(generator, trace.begin(),
+                                                                     trace.end());
+    if (kind == trace_kind::scan_mix) {
+      // One request in five belongs to a scan of an eighth of the universe.
+      const std::size_t scan_length = std::max<std::size_t>(universe / 8, 1);
+      return interleave_scans(trace, universe, 4 * scan_length, scan_length);
+    }
+    return trace;
+  }
+
+}  // namespace hh::benchmark
+
+#endif
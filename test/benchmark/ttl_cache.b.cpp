@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <hh/helpers.hpp>
+#include <hh/ttl_cache.hpp>
+
+namespace {
+  using namespace std::chrono_literals;
+  constexpr static auto CAPACITY = 4096;
+
+  int square(int value) { return value * value; }
+
+  void benchmark_ttl_cache_hits(::benchmark::State& state) {
+    auto cache = hh::functools::make_ttl_cache(square, 1h, CAPACITY);
+    for (int i = 0; i < CAPACITY; ++i) {
+      cache(i);
+    }
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i));
+      i = (i + 1) % CAPACITY;
+    }
+  }
+
+  void benchmark_ttl_cache_expiry_churn(::benchmark::State& state) {
+    // Every entry expires a few ticks after it is written, so the wheel reclaims as fast as the
+    // cache fills and capacity eviction never runs.
+    hh::helpers::manual_clock clock;
+    hh::functools::basic_ttl_cache<int(int), hh::helpers::manual_clock> cache{square, CAPACITY,
+                                                                               5ms, clock};
+    int i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i++));
+      clock.advance(100us);
+    }
+    state.counters["retained"] = static_cast<double>(cache.size());
+  }
+}  // namespace
+
+BENCHMARK(benchmark_ttl_cache_hits);
+BENCHMARK(benchmark_ttl_cache_expiry_churn);
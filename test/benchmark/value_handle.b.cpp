@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+
+#include <cstddef>
+#include <hh/lru_cache.hpp>
+#include <vector>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr int KEYS = 16;
+
+  std::vector<char> payload(int key, std::size_t bytes) {
+    return std::vector<char>(bytes, static_cast<char>(key));
+  }
+
+  /** Times hits on a warm cache of KEYS values of the benchmark's size in bytes. */
+  template <typename CACHE> void time_hits(::benchmark::State& state, CACHE& cache) {
+    for (int key = 0; key < KEYS; ++key) {
+      cache(key);
+    }
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    int key = 0;
+    for (const auto& _ : state) {
+      auto value = cache(key);
+      benchmark::DoNotOptimize(value);
+      key = (key + 1) % KEYS;
+    }
+    state.counters["allocations_per_op"] = ::benchmark::Counter(
+        static_cast<double>(hh::benchmark::heap_usage().allocations - heap_before.allocations),
+        ::benchmark::Counter::kAvgIterations);
+  }
+
+  void benchmark_copy_out_hit(::benchmark::State& state) {
+    const auto bytes = static_cast<std::size_t>(state.range(0));
+    auto cache = hh::functools::make_lrucache([bytes](int key) { return payload(key, bytes); },
+                                              KEYS);
+    time_hits(state, cache);
+  }
+
+  void benchmark_handle_hit(::benchmark::State& state) {
+    const auto bytes = static_cast<std::size_t>(state.range(0));
+    auto cache = hh::functools::make_shared_lrucache(
+        [bytes](int key) { return payload(key, bytes); }, KEYS);
+    time_hits(state, cache);
+  }
+}  // namespace
+
+BENCHMARK(benchmark_copy_out_hit)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
+BENCHMARK(benchmark_handle_hit)->Arg(1 << 10)->Arg(64 << 10)->Arg(1 << 20);
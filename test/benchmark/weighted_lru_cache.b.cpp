@@ -0,0 +1,44 @@
+#include <benchmark/benchmark.h>
+
+#include <hh/lru_cache.hpp>
+#include <string>
+
+#include "memory.hpp"
+
+namespace {
+  constexpr static std::size_t BUDGET = 16 * 1024 * 1024;
+
+  constexpr static std::size_t KEYS = 4096;
+
+  std::string payload(std::size_t id, std::size_t size) {
+    return std::string(size, static_cast<char>('a' + id % 26));
+  }
+
+  void benchmark_weighted_cache_churn(::benchmark::State& state) {
+    // Value sizes range from 8 bytes to 64KiB, so the number of entries within budget varies.
+    const hh::benchmark::heap_tracking tracking;
+    const auto heap_before = hh::benchmark::heap_usage();
+    auto cache = hh::functools::make_weighted_lrucache(payload, BUDGET);
+    std::size_t i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i % KEYS, std::size_t{8} << (i % KEYS % 14)));
+      i = i * 2862933555777941757ull + 3037000493ull;
+    }
+    state.counters["weight"] = static_cast<double>(cache.weight());
+    state.counters["heap_bytes"] = static_cast<double>(hh::benchmark::heap_usage().live_bytes
+                                                       - heap_before.live_bytes);
+    state.counters["entries"] = static_cast<double>(cache.size());
+  }
+
+  void benchmark_unweighted_cache_churn(::benchmark::State& state) {
+    auto cache = hh::functools::make_lrucache(payload, 1700);
+    std::size_t i = 0;
+    for (const auto& _ : state) {
+      benchmark::DoNotOptimize(cache(i % KEYS, std::size_t{8} << (i % KEYS % 14)));
+      i = i * 2862933555777941757ull + 3037000493ull;
+    }
+  }
+}  // namespace
+
+BENCHMARK(benchmark_weighted_cache_churn);
+BENCHMARK(benchmark_unweighted_cache_churn);
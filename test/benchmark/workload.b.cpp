@@ -0,0 +1,451 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <hh/call_counter.hpp>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/sharded_lru_cache.hpp>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "memory.hpp"
+#include "perf_counters.hpp"
+#include "traces.hpp"
+
+/*
+ * Replays realistic key traces against lru_cache, call_counter and the key hashes, reporting the
+ * hit ratio, heap allocations and, where the machine offers them, perf events per operation. Heap
+ * allocations are counted over a short replay after the timed loop, which they would slow.
+ *
+ * Each trace draws from a universe twice the capacity of the cache and is sixteen times as long
+ * as the capacity, so hit ratios reflect the trace more than its replay in a loop. Traces are
+ * capped at 2^24 keys, so from a few million entries the cache holds most keys the trace repeats
+ * and those capacities measure lookups in a cache far larger than the CPU caches rather than a
+ * realistic hit ratio. Keys are built before timing, and caches are warmed by one
+ * replay of the trace, so the timed loop measures the steady state. Building a trace and warming
+ * a large cache is slow, so both are kept between the runs google benchmark makes to size the
+ * iteration count, and dropped when the next benchmark starts.
+ */
+
+namespace {
+  using hh::benchmark::trace_kind;
+
+  constexpr std::size_t MIN_TRACE_LENGTH = 1 << 16;
+  constexpr std::size_t MAX_TRACE_LENGTH = 1 << 24;
+  constexpr std::size_t CONCURRENT_CAPACITY = 1 << 16;
+  constexpr std::size_t HASHED_KEYS = 1 << 20;
+  constexpr std::size_t ALLOCATION_SAMPLE = 1 << 12;
+
+  const int MAX_THREADS = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  /** Misses of the calling thread, counted by the backends of every key type. */
+  thread_local std::uint64_t t_misses = 0;
+
+  struct int_keys {
+    using key = std::tuple<int>;
+    static key make(std::uint64_t id) { return key{static_cast<int>(id)}; }
+    static std::uint64_t compute(int id) {
+      ++t_misses;
+      return static_cast<std::uint64_t>(id) * 31;
+    }
+  };
+
+  struct pair_keys {
+    using key = std::tuple<int, int>;
+    static key make(std::uint64_t id) {
+      return key{static_cast<int>(id >> 10), static_cast<int>(id & 1023)};
+    }
+    static std::uint64_t compute(int high, int low) {
+      ++t_misses;
+      return (static_cast<std::uint64_t>(high) << 10) | static_cast<std::uint64_t>(low);
+    }
+  };
+
+  /** Keys like "session:00000000001234567", too long for the small string buffer. */
+  struct string_keys {
+    using key = std::tuple<std::string>;
+    static key make(std::uint64_t id) {
+      char buffer[32];
+      std::snprintf(buffer, sizeof(buffer), "session:%017llu",
+                    static_cast<unsigned long long>(id));
+      return key{std::string{buffer}};
+    }
+    static std::uint64_t compute(const std::string& id) {
+      ++t_misses;
+      return id.size();
+    }
+  };
+
+  std::size_t trace_length(std::size_t capacity) {
+    return std::clamp(16 * capacity, MIN_TRACE_LENGTH, MAX_TRACE_LENGTH);
+  }
+
+  template <typename KEYS>
+  std::vector<typename KEYS::key> make_keys(trace_kind kind, std::size_t length,
+                                            std::size_t universe) {
+    const auto trace = hh::benchmark::make_trace(kind, length, universe);
+    std::vector<typename KEYS::key> keys;
+    keys.reserve(trace.size());
+    for (const auto id : trace) {
+      keys.push_back(KEYS::make(id));
+    }
+    return keys;
+  }
+
+  struct fixture_base {
+    virtual ~fixture_base() = default;
+  };
+
+  std::unique_ptr<fixture_base> g_fixture;
+  std::string g_fixture_id;
+
+  /**
+   * The fixture of the running benchmark, built by the first run with these arguments and
+   * replacing the fixture of any other benchmark. Only one thread may call this.
+   *
+   * @param kind The trace the fixture replays.
+   * @param size The capacity or universe the fixture was built for.
+   * @param args The arguments building the fixture.
+   */
+  template <typename FIXTURE, typename... ARGUMENTS>
+  FIXTURE& shared_fixture(trace_kind kind, std::size_t size, ARGUMENTS&&... args) {
+    std::string id = std::string{typeid(FIXTURE).name()} + '/'
+                     + hh::benchmark::trace_name(kind) + '/' + std::to_string(size);
+    if (id != g_fixture_id) {
+      g_fixture.reset();
+      g_fixture = std::make_unique<FIXTURE>(std::forward<ARGUMENTS>(args)...);
+      g_fixture_id = std::move(id);
+    }
+    return static_cast<FIXTURE&>(*g_fixture);
+  }
+
+  /**
+   * Measures the hit ratio and perf events of a timed loop, every thread probing its own.
+   */
+  class loop_probe {
+    hh::benchmark::perf_counters d_perf;
+    std::uint64_t d_misses = 0;
+
+  public:
+    loop_probe() {
+      d_perf.start();
+      d_misses = t_misses;
+    }
+
+    /** Reports per-operation counters, with the hit ratio when the loop called a cache. */
+    void report(::benchmark::State& state, bool cached) {
+      const auto events = d_perf.stop();
+      const auto iterations = static_cast<double>(state.iterations());
+      state.SetItemsProcessed(state.iterations());
+      if (cached) {
+        state.counters["hit_ratio"] = ::benchmark::Counter(
+            iterations - static_cast<double>(t_misses - d_misses),
+            ::benchmark::Counter::kAvgIterations);
+      }
+      for (int counted = 0; counted < hh::benchmark::perf_counters::event_count; ++counted) {
+        if (events.d_available[counted]) {
+          const auto event = static_cast<hh::benchmark::perf_counters::event>(counted);
+          state.counters[std::string{hh::benchmark::perf_counters::name(event)} + "_per_op"]
+              = ::benchmark::Counter(static_cast<double>(events.d_values[counted]),
+                                     ::benchmark::Counter::kAvgIterations);
+        }
+      }
+    }
+  };
+
+  /**
+   * Reports the heap allocations per operation of ALLOCATION_SAMPLE further operations after the
+   * timed loop, so counting allocations does not slow the loop. Only the first thread samples.
+   */
+  template <typename OPERATION>
+  void sample_allocations(::benchmark::State& state, OPERATION&& operation) {
+    if (state.thread_index() != 0) {
+      return;
+    }
+    std::size_t allocations = 0;
+    {
+      const hh::benchmark::heap_tracking tracking;
+      const auto before = hh::benchmark::heap_usage();
+      for (std::size_t sampled = 0; sampled < ALLOCATION_SAMPLE; ++sampled) {
+        operation();
+      }
+      allocations = hh::benchmark::heap_usage().allocations - before.allocations;
+    }
+    state.counters["allocations_per_op"]
+        = static_cast<double>(allocations) / static_cast<double>(ALLOCATION_SAMPLE);
+  }
+
+  /** A trace's keys and a cache warmed on them. */
+  template <typename KEYS, typename CACHE> struct cache_fixture : fixture_base {
+    std::vector<typename KEYS::key> d_keys;
+    CACHE d_cache;
+
+    template <typename MAKE_CACHE>
+    cache_fixture(trace_kind kind, std::size_t capacity, MAKE_CACHE&& make_cache)
+        : d_keys{make_keys<KEYS>(kind, trace_length(capacity), 2 * capacity)},
+          d_cache{make_cache(capacity)} {
+      for (const auto& key : d_keys) {
+        benchmark::DoNotOptimize(std::apply(d_cache, key));
+      }
+    }
+  };
+
+  template <typename KEYS> auto make_lru(std::size_t capacity) {
+    return hh::functools::make_lrucache(&KEYS::compute, static_cast<unsigned int>(capacity));
+  }
+
+  template <typename KEYS> using lru_fixture
+      = cache_fixture<KEYS, decltype(make_lru<KEYS>(std::size_t{}))>;
+
+  /** Replays a trace of the kind in range(0) against an lru_cache of capacity range(1). */
+  template <typename KEYS> void benchmark_lru_trace(::benchmark::State& state) {
+    const auto kind = static_cast<trace_kind>(state.range(0));
+    const auto capacity = static_cast<std::size_t>(state.range(1));
+    auto& fixture = shared_fixture<lru_fixture<KEYS>>(kind, capacity, kind, capacity,
+                                                      make_lru<KEYS>);
+    state.SetLabel(hh::benchmark::trace_name(kind));
+    const auto& keys = fixture.d_keys;
+    std::size_t index = 0;
+    const auto replay = [&] {
+      benchmark::DoNotOptimize(std::apply(fixture.d_cache, keys[index]));
+      index = index + 1 == keys.size() ? 0 : index + 1;
+    };
+    loop_probe probe;
+    for (const auto& _ : state) {
+      replay();
+    }
+    probe.report(state, true);
+    sample_allocations(state, replay);
+  }
+
+  /** An lru_cache every thread shares behind one mutex. */
+  template <typename KEYS> class locked_lru {
+    std::mutex d_mutex;
+    decltype(make_lru<KEYS>(std::size_t{})) d_cache;
+
+  public:
+    explicit locked_lru(std::size_t capacity) : d_cache{make_lru<KEYS>(capacity)} {}
+
+    template <typename... ARGUMENTS> std::uint64_t operator()(const ARGUMENTS&... args) {
+      std::lock_guard<std::mutex> lock{d_mutex};
+      return d_cache(args...);
+    }
+  };
+
+  template <typename KEYS> struct locked_fixture : fixture_base {
+    std::vector<typename KEYS::key> d_keys;
+    std::unique_ptr<locked_lru<KEYS>> d_cache;
+
+    locked_fixture(trace_kind kind, std::size_t capacity)
+        : d_keys{make_keys<KEYS>(kind, trace_length(capacity), 2 * capacity)},
+          d_cache{std::make_unique<locked_lru<KEYS>>(capacity)} {
+      for (const auto& key : d_keys) {
+        benchmark::DoNotOptimize(std::apply(*d_cache, key));
+      }
+    }
+
+    std::uint64_t operator()(const typename KEYS::key& key) { return std::apply(*d_cache, key); }
+  };
+
+  template <typename KEYS> struct sharded_fixture : fixture_base {
+    using cache_type = decltype(hh::functools::make_sharded_lrucache(&KEYS::compute, 0, 1));
+
+    std::vector<typename KEYS::key> d_keys;
+    std::unique_ptr<cache_type> d_cache;
+
+    sharded_fixture(trace_kind kind, std::size_t capacity)
+        : d_keys{make_keys<KEYS>(kind, trace_length(capacity), 2 * capacity)},
+          d_cache{std::make_unique<cache_type>(&KEYS::compute,
+                                               static_cast<unsigned int>(capacity), 64)} {
+      for (const auto& key : d_keys) {
+        benchmark::DoNotOptimize(std::apply(*d_cache, key));
+      }
+    }
+
+    std::uint64_t operator()(const typename KEYS::key& key) { return std::apply(*d_cache, key); }
+  };
+
+  /**
+   * Replays a trace of the kind in range(0) from every thread against one shared cache of
+   * capacity range(1), each thread starting at its own offset in the trace.
+   */
+  template <typename FIXTURE> void benchmark_shared_trace(::benchmark::State& state) {
+    static FIXTURE* fixture = nullptr;
+    const auto kind = static_cast<trace_kind>(state.range(0));
+    if (state.thread_index() == 0) {
+      const auto capacity = static_cast<std::size_t>(state.range(1));
+      fixture = &shared_fixture<FIXTURE>(kind, capacity, kind, capacity);
+      state.SetLabel(hh::benchmark::trace_name(kind));
+    }
+    std::size_t index = 0;
+    std::size_t size = 0;
+    const auto replay = [&] {
+      // Other threads may only read the fixture once the loop's start barrier is passed.
+      if (size == 0) {
+        size = fixture->d_keys.size();
+        index = size / state.threads() * state.thread_index();
+      }
+      benchmark::DoNotOptimize((*fixture)(fixture->d_keys[index]));
+      index = index + 1 == size ? 0 : index + 1;
+    };
+    loop_probe probe;
+    for (const auto& _ : state) {
+      replay();
+    }
+    probe.report(state, true);
+    sample_allocations(state, replay);
+  }
+
+  template <typename KEYS> struct counted_fixture : fixture_base {
+    using counter_type = decltype(hh::functools::basic_call_counter{&KEYS::compute});
+
+    std::vector<typename KEYS::key> d_keys;
+    std::unique_ptr<counter_type> d_counter;
+
+    counted_fixture(trace_kind kind, std::size_t universe)
+        : d_keys{make_keys<KEYS>(kind, trace_length(universe), universe)},
+          d_counter{std::make_unique<counter_type>(&KEYS::compute)} {}
+
+    std::uint64_t operator()(const typename KEYS::key& key) {
+      return std::apply(*d_counter, key);
+    }
+  };
+
+  /** Counts calls over a trace of the kind in range(0) and universe range(1) from every thread. */
+  template <typename KEYS> void benchmark_call_counter_trace(::benchmark::State& state) {
+    static counted_fixture<KEYS>* fixture = nullptr;
+    const auto kind = static_cast<trace_kind>(state.range(0));
+    if (state.thread_index() == 0) {
+      const auto universe = static_cast<std::size_t>(state.range(1));
+      fixture = &shared_fixture<counted_fixture<KEYS>>(kind, universe, kind, universe);
+      state.SetLabel(hh::benchmark::trace_name(kind));
+    }
+    std::size_t index = 0;
+    std::size_t size = 0;
+    const auto count = [&] {
+      if (size == 0) {
+        size = fixture->d_keys.size();
+        index = size / state.threads() * state.thread_index();
+      }
+      benchmark::DoNotOptimize((*fixture)(fixture->d_keys[index]));
+      index = index + 1 == size ? 0 : index + 1;
+    };
+    loop_probe probe;
+    for (const auto& _ : state) {
+      count();
+    }
+    probe.report(state, false);
+    sample_allocations(state, count);
+  }
+
+  template <typename KEYS> struct hashed_fixture : fixture_base {
+    std::vector<typename KEYS::key> d_keys;
+
+    explicit hashed_fixture(trace_kind kind)
+        : d_keys{make_keys<KEYS>(kind, HASHED_KEYS, HASHED_KEYS)} {}
+  };
+
+  /** Hashes the keys of a trace of the kind in range(0) as the cache would key them. */
+  template <typename HASHER, typename KEYS>
+  void benchmark_key_hash_trace(::benchmark::State& state) {
+    const auto kind = static_cast<trace_kind>(state.range(0));
+    const auto& keys = shared_fixture<hashed_fixture<KEYS>>(kind, HASHED_KEYS, kind).d_keys;
+    const typename HASHER::template hash<typename KEYS::key> hash{};
+    state.SetLabel(hh::benchmark::trace_name(kind));
+    std::size_t index = 0;
+    const auto hash_next = [&] {
+      benchmark::DoNotOptimize(hash(keys[index]));
+      index = index + 1 == keys.size() ? 0 : index + 1;
+    };
+    loop_probe probe;
+    for (const auto& _ : state) {
+      hash_next();
+    }
+    probe.report(state, false);
+    sample_allocations(state, hash_next);
+  }
+
+  constexpr auto ZIPF = static_cast<std::int64_t>(trace_kind::zipf);
+  constexpr auto UNIFORM = static_cast<std::int64_t>(trace_kind::uniform);
+  constexpr auto SCAN_MIX = static_cast<std::int64_t>(trace_kind::scan_mix);
+
+  /** Every trace at capacities from 16 up to max_capacity, growing 64 times at each step. */
+  void trace_capacities(::benchmark::internal::Benchmark* benchmark,
+                        std::int64_t max_capacity) {
+    for (const auto kind : {ZIPF, UNIFORM, SCAN_MIX}) {
+      for (std::int64_t capacity = 16; capacity < max_capacity; capacity *= 64) {
+        benchmark->Args({kind, capacity});
+      }
+      benchmark->Args({kind, max_capacity});
+    }
+  }
+
+  void small_capacities(::benchmark::internal::Benchmark* benchmark) {
+    trace_capacities(benchmark, 1 << 18);
+  }
+
+  void all_capacities(::benchmark::internal::Benchmark* benchmark) {
+    trace_capacities(benchmark, 10'000'000);
+  }
+}  // namespace
+
+BENCHMARK_TEMPLATE(benchmark_lru_trace, int_keys)->Apply(all_capacities);
+BENCHMARK_TEMPLATE(benchmark_lru_trace, pair_keys)->Apply(small_capacities);
+BENCHMARK_TEMPLATE(benchmark_lru_trace, string_keys)->Apply(small_capacities);
+
+BENCHMARK_TEMPLATE(benchmark_shared_trace, locked_fixture<int_keys>)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_shared_trace, sharded_fixture<int_keys>)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_shared_trace, locked_fixture<string_keys>)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_shared_trace, sharded_fixture<string_keys>)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(benchmark_call_counter_trace, int_keys)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_call_counter_trace, pair_keys)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_call_counter_trace, string_keys)
+    ->Args({ZIPF, CONCURRENT_CAPACITY})
+    ->ThreadRange(1, MAX_THREADS)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::wy_hasher, int_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::wy_hasher, pair_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::wy_hasher, string_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::combining_hasher, int_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::combining_hasher, pair_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
+BENCHMARK_TEMPLATE(benchmark_key_hash_trace, hh::functools::combining_hasher, string_keys)
+    ->Arg(ZIPF)
+    ->Arg(UNIFORM);
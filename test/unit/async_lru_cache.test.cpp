@@ -0,0 +1,144 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <hh/async_lru_cache.hpp>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+
+    /** Runs tasks inline, or refuses them by throwing while refuse is set. */
+    struct refusing_executor {
+      const bool* d_refuse;
+
+      template <typename TASK> void execute(TASK&& task) const {
+        if (*d_refuse) {
+          throw std::runtime_error("executor refused the task");
+        }
+        std::forward<TASK>(task)();
+      }
+    };
+  }  // namespace
+
+  TEST(async_lru_cache, futures_resolve_to_the_underlying_result) {
+    auto cached_add = make_async_lrucache(add, 16, thread_pool_executor{2});
+    EXPECT_EQ(cached_add(1, 2).get(), 3) << "Future did not resolve to the function's result.";
+  }
+
+  TEST(async_lru_cache, inline_executor_computes_before_returning) {
+    auto cached_add = make_async_lrucache(add, 16, inline_executor{});
+    const auto result = cached_add(2, 2);
+    EXPECT_EQ(result.wait_for(std::chrono::seconds{0}), std::future_status::ready)
+        << "Inline executor did not compute the value before the call returned.";
+    EXPECT_EQ(result.get(), 4) << "Future did not resolve to the function's result.";
+  }
+
+  TEST(async_lru_cache, calls_return_before_the_function_finishes) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto cached = make_async_lrucache(
+        [released](int value) {
+          released.wait();
+          return value;
+        },
+        16, thread_pool_executor{1});
+    const auto result = cached(5);
+    EXPECT_EQ(result.wait_for(std::chrono::milliseconds{10}), std::future_status::timeout)
+        << "Call waited for the underlying function.";
+    release.set_value();
+    EXPECT_EQ(result.get(), 5) << "Pending future did not resolve once the function finished.";
+  }
+
+  TEST(async_lru_cache, concurrent_callers_share_the_in_flight_result) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<int> calls{0};
+    auto cached = make_async_lrucache(
+        [released, &calls](int value) {
+          ++calls;
+          released.wait();
+          return value * 2;
+        },
+        16, thread_pool_executor{4});
+    std::vector<std::shared_future<int>> results;
+    for (int i = 0; i < 8; ++i) {
+      results.push_back(cached(21));
+    }
+    release.set_value();
+    for (const auto& result : results) {
+      EXPECT_EQ(result.get(), 42) << "Waiter did not receive the in-flight result.";
+    }
+    EXPECT_EQ(calls.load(), 1) << "Concurrent callers did not share one computation.";
+  }
+
+  TEST(async_lru_cache, failed_results_are_evicted) {
+    int calls = 0;
+    auto cached = make_async_lrucache(
+        [&calls](int value) {
+          if (++calls == 1) {
+            throw std::runtime_error("first call fails");
+          }
+          return value;
+        },
+        16, inline_executor{});
+    EXPECT_THROW(cached(7).get(), std::runtime_error) << "Failure was not passed to the caller.";
+    EXPECT_EQ(cached.size(), 0u) << "Failed result was kept in the cache.";
+    EXPECT_EQ(cached(7).get(), 7) << "Call after a failure did not try again.";
+    EXPECT_EQ(cached(7).get(), 7) << "Successful retry was not cached.";
+    EXPECT_EQ(calls, 2) << "Successful retry was not reused.";
+  }
+
+  TEST(async_lru_cache, refused_computations_are_not_cached) {
+    bool refuse = true;
+    auto cached_add = make_async_lrucache(add, 16, refusing_executor{&refuse});
+    EXPECT_THROW(cached_add(1, 2), std::runtime_error) << "The executor's refusal was swallowed.";
+    EXPECT_EQ(cached_add.size(), 0u) << "A refused computation was left pending in the cache.";
+    refuse = false;
+    EXPECT_EQ(cached_add(1, 2).get(), 3) << "Call after a refusal did not compute again.";
+    EXPECT_EQ(cached_add.size(), 1u) << "Successful retry was not cached.";
+  }
+
+  TEST(async_lru_cache, least_recently_used_entries_are_evicted) {
+    int calls = 0;
+    auto cached = make_async_lrucache(
+        [&calls](int value) {
+          ++calls;
+          return value;
+        },
+        2, inline_executor{});
+    cached(1);
+    cached(2);
+    cached(1);
+    cached(3);
+    EXPECT_EQ(cached.size(), 2u) << "Cache grew beyond its maximum size.";
+    cached(1);
+    EXPECT_EQ(calls, 3) << "Recently used entry was evicted.";
+    cached(2);
+    EXPECT_EQ(calls, 4) << "Least recently used entry was not evicted.";
+  }
+
+  TEST(async_lru_cache, pending_computations_outlive_the_cache) {
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    thread_pool_executor executor{1};
+    std::shared_future<int> result;
+    {
+      auto cached = make_async_lrucache(
+          [released](int value) {
+            released.wait();
+            return value;
+          },
+          16, executor);
+      result = cached(9);
+    }
+    release.set_value();
+    EXPECT_EQ(result.get(), 9) << "Destroying the cache abandoned its pending computation.";
+  }
+}  // namespace hh::functools
@@ -0,0 +1,76 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <hh/cache_metrics.hpp>
+#include <hh/helpers.hpp>
+#include <hh/lru_cache.hpp>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+  }  // namespace
+
+  TEST(cache_metrics, hits_misses_and_insertions_are_counted) {
+    auto cached_add = make_instrumented_lrucache(add, 2);
+    cached_add(1, 1);
+    cached_add(1, 1);
+    cached_add(1, 2);
+    cached_add(1, 3);
+    const auto stats = cached_add.stats();
+    EXPECT_EQ(stats.d_hits, 1u) << "Hits were not counted.";
+    EXPECT_EQ(stats.d_misses, 3u) << "Misses were not counted.";
+    EXPECT_EQ(stats.d_insertions, 3u) << "Insertions were not counted.";
+    EXPECT_EQ(stats.d_evictions, 1u) << "Evictions were not counted.";
+    EXPECT_DOUBLE_EQ(stats.hit_ratio(), 0.25) << "Hit ratio did not follow the counters.";
+  }
+
+  TEST(cache_metrics, load_latency_is_recorded_for_every_miss) {
+    auto slow_add = hh::helpers::make_delayed<1>(add);
+    auto cached_add = make_instrumented_lrucache(slow_add);
+    cached_add(1, 1);
+    cached_add(2, 2);
+    cached_add(2, 2);
+    const auto stats = cached_add.stats();
+    EXPECT_EQ(stats.d_load_latency.count(), 2u) << "Not every load was timed.";
+    EXPECT_GE(stats.d_load_time, std::chrono::milliseconds{2}) << "Load time was under-reported.";
+    EXPECT_GE(stats.d_load_latency.percentile(50), 1000000u)
+        << "Load latency histogram did not reflect the delayed function.";
+  }
+
+  TEST(cache_metrics, get_many_counts_each_call) {
+    auto cached_add = make_instrumented_lrucache(add);
+    cached_add(1, 1);
+    const std::vector<std::tuple<int, int>> calls{{1, 1}, {2, 2}, {2, 2}};
+    std::vector<int> results;
+    cached_add.get_many(calls, std::back_inserter(results));
+    const auto stats = cached_add.stats();
+    EXPECT_EQ(stats.d_hits, 1u) << "Batched hits were not counted.";
+    EXPECT_EQ(stats.d_misses, 3u) << "Batched misses were not counted per call.";
+    EXPECT_EQ(stats.d_insertions, 2u) << "Each distinct batched miss should be inserted once.";
+  }
+
+  TEST(cache_metrics, failed_loads_are_timed_but_not_inserted) {
+    auto cached = make_instrumented_lrucache(std::function<int(int)>{[](int value) -> int {
+      throw std::runtime_error{"load failed for " + std::to_string(value)};
+    }});
+    EXPECT_THROW(cached(1), std::runtime_error) << "Load failure was not propagated.";
+    const auto stats = cached.stats();
+    EXPECT_EQ(stats.d_load_latency.count(), 1u) << "Failed load was not timed.";
+    EXPECT_EQ(stats.d_insertions, 0u) << "Failed load was inserted.";
+  }
+
+  TEST(cache_metrics, uninstrumented_caches_report_nothing) {
+    auto cached_add = make_lrucache(add);
+    cached_add(1, 1);
+    cached_add(1, 1);
+    const auto stats = cached_add.stats();
+    EXPECT_EQ(stats.d_hits + stats.d_misses, 0u) << "no_metrics recorded lookups.";
+    EXPECT_EQ(stats.d_load_latency.count(), 0u) << "no_metrics recorded loads.";
+  }
+}  // namespace hh::functools
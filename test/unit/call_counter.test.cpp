@@ -19,12 +19,21 @@
 #include <gtest/gtest.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <functional>
 #include <hh/call_counter.hpp>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 namespace hh::functools {
 
   namespace {
     int add(int a, int b) { return a + b; }
+    std::size_t length(const std::string& text) { return text.size(); }
   }  // namespace
 
   TEST(call_counter, empty_on_initial_construction) {
@@ -60,4 +69,150 @@ namespace hh::functools {
     counter(1, 2);
     EXPECT_EQ(counter.unique_entries(), 1) << "Call counter did not increment call count.";
   }
+
+  TEST(call_counter, querying_an_entry_does_not_add_it) {
+    call_counter counter{add};
+    counter.call_count(1, 2);
+    EXPECT_EQ(counter.unique_entries(), 0) << "Querying a call count added an entry.";
+  }
+
+  TEST(call_counter, counts_calls_made_with_reference_arguments_by_value) {
+    call_counter counter{length};
+    std::string text = "abc";
+    counter(text);
+    text = "abcd";
+    EXPECT_EQ(counter.call_count(std::string{"abc"}), 1)
+        << "Call counter did not keep a copy of the arguments.";
+  }
+
+  TEST(call_counter, counts_every_call_made_from_concurrent_threads) {
+    constexpr int thread_count = 8;
+    constexpr int calls_per_thread = 10000;
+    call_counter counter{add, 4};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+      threads.emplace_back([&counter, thread] {
+        for (int call = 0; call < calls_per_thread; ++call) {
+          counter(call % 10, thread % 2);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(counter.total_calls(), thread_count * calls_per_thread)
+        << "Concurrent calls were lost from the total.";
+    EXPECT_EQ(counter.unique_entries(), 20) << "Entries counted on several stripes were duplicated.";
+    EXPECT_EQ(counter.call_count(3, 1), thread_count / 2 * calls_per_thread / 10)
+        << "Counts of one entry were not summed over the stripes.";
+  }
+
+  TEST(approximate_call_counter, unseen_entries_return_zero) {
+    approximate_call_counter counter{add, 64, 4, 8};
+    EXPECT_EQ(counter.call_count(1, 2), 0) << "Empty approximate counter reported calls.";
+    EXPECT_EQ(counter.total_calls(), 0) << "Empty approximate counter reported calls.";
+    EXPECT_TRUE(counter.top_k(4).empty()) << "Empty approximate counter reported heavy hitters.";
+  }
+
+  TEST(approximate_call_counter, estimates_stay_within_the_documented_error_bound) {
+    constexpr int hot_keys = 10;
+    constexpr int keys = 20000;
+    std::vector<int> calls;
+    for (int key = 0; key < keys; ++key) {
+      const int repeats = key < hot_keys ? 2000 - 100 * key : key % 3 + 1;
+      calls.insert(calls.end(), repeats, key);
+    }
+    std::shuffle(calls.begin(), calls.end(), std::mt19937{42});
+
+    call_counter exact{add, 1};
+    approximate_call_counter approximate{add, 1024, 5, 64, 1};
+    for (auto key : calls) {
+      exact(key, 0);
+      approximate(key, 0);
+    }
+
+    EXPECT_EQ(approximate.total_calls(), exact.total_calls())
+        << "Approximate counter lost calls from its total.";
+    const auto bound = approximate.error_bound();
+    int outside_bound = 0;
+    for (int key = 0; key < keys; ++key) {
+      const auto estimate = approximate.call_count(key, 0);
+      const auto count = exact.call_count(key, 0);
+      ASSERT_GE(estimate, count) << "Approximate counter undercounted key " << key;
+      outside_bound += estimate - count > bound ? 1 : 0;
+    }
+    // Each estimate may exceed the bound with a probability of at most exp(-5), under 0.7%.
+    EXPECT_LE(outside_bound, keys / 100) << "Too many estimates exceeded the error bound.";
+
+    std::set<int> hottest;
+    for (const auto& [key, count] : approximate.top_k(hot_keys)) {
+      hottest.insert(std::get<0>(key));
+      EXPECT_GE(count, exact.call_count(key)) << "Heavy hitter count undercounted.";
+    }
+    std::set<int> expected;
+    for (int key = 0; key < hot_keys; ++key) {
+      expected.insert(key);
+    }
+    EXPECT_EQ(hottest, expected) << "Top k did not return the most frequently called entries.";
+  }
+
+  TEST(approximate_call_counter, sums_calls_counted_on_concurrent_threads) {
+    constexpr int thread_count = 4;
+    constexpr int calls_per_thread = 5000;
+    approximate_call_counter counter{add, 256, 4, 16, 4};
+    std::vector<std::thread> threads;
+    for (int thread = 0; thread < thread_count; ++thread) {
+      threads.emplace_back([&counter] {
+        for (int call = 0; call < calls_per_thread; ++call) {
+          counter(call % 10, 0);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    EXPECT_EQ(counter.total_calls(), thread_count * calls_per_thread)
+        << "Concurrent calls were lost from the total.";
+    EXPECT_EQ(counter.call_count(3, 0), thread_count * calls_per_thread / 10)
+        << "Counts of one entry were not summed over the stripes.";
+  }
+
+  TEST(call_counter, naming_the_signature_erases_the_function_type) {
+    call_counter<int, int, int> counter{add};
+    static_assert(
+        std::is_same_v<decltype(counter)::function_type, std::function<int(int, int)>>,
+        "Naming the signature did not erase the function type.");
+    EXPECT_EQ(counter(1, 2), 3) << "Counted function returned the wrong value.";
+    EXPECT_EQ(counter.call_count(1, 2), 1) << "Call to the function was not counted.";
+    approximate_call_counter<int, int, int> approximate{add, 64, 4, 8};
+    EXPECT_EQ(approximate(1, 2), 3) << "Counted function returned the wrong value.";
+    EXPECT_EQ(approximate.call_count(1, 2), 1) << "Call to the function was not counted.";
+  }
+
+  TEST(basic_call_counter, lambdas_are_counted_without_type_erasure) {
+    auto multiply = [](int a, int b) { return a * b; };
+    basic_call_counter counter{multiply};
+    static_assert(std::is_same_v<decltype(counter)::function_type, decltype(multiply)>,
+                  "The lambda was not stored as its own type.");
+    EXPECT_EQ(counter(3, 4), 12) << "Counted lambda returned the wrong value.";
+    EXPECT_EQ(counter.call_count(3, 4), 1) << "Call to the lambda was not counted.";
+  }
+
+  TEST(basic_call_counter, std_function_opts_in_to_type_erasure) {
+    basic_call_counter counter{std::function<int(int, int)>{add}};
+    static_assert(
+        std::is_same_v<decltype(counter)::function_type, std::function<int(int, int)>>,
+        "A std::function was not stored as given.");
+    EXPECT_EQ(counter(1, 2), 3) << "Counted std::function returned the wrong value.";
+    EXPECT_EQ(counter.total_calls(), 1) << "Call to the std::function was not counted.";
+  }
+
+  TEST(basic_approximate_call_counter, lambdas_are_counted_without_type_erasure) {
+    auto multiply = [](int a, int b) { return a * b; };
+    basic_approximate_call_counter counter{multiply, 64, 4, 8, 1};
+    static_assert(std::is_same_v<decltype(counter)::function_type, decltype(multiply)>,
+                  "The lambda was not stored as its own type.");
+    EXPECT_EQ(counter(3, 4), 12) << "Counted lambda returned the wrong value.";
+    EXPECT_EQ(counter.call_count(3, 4), 1) << "Call to the lambda was not counted.";
+  }
 }  // namespace hh::functools
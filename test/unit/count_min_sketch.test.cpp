@@ -0,0 +1,45 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hh/count_min_sketch.hpp>
+
+namespace hh::collection {
+
+  TEST(count_min_sketch, width_is_rounded_up_to_a_power_of_two) {
+    count_min_sketch<> sketch{100, 4};
+    EXPECT_EQ(sketch.width(), 128u) << "Sketch width was not rounded to a power of two.";
+    EXPECT_EQ(sketch.depth(), 4u) << "Sketch depth was not retained.";
+  }
+
+  TEST(count_min_sketch, unseen_keys_estimate_zero) {
+    count_min_sketch<> sketch{64, 4};
+    EXPECT_EQ(sketch.estimate(12345), 0u) << "Empty sketch reported occurrences.";
+  }
+
+  TEST(count_min_sketch, estimates_never_undercount) {
+    count_min_sketch<> sketch{64, 4};
+    for (std::size_t key = 0; key < 500; ++key) {
+      sketch.increment(key, static_cast<std::uint32_t>(key % 7 + 1));
+    }
+    for (std::size_t key = 0; key < 500; ++key) {
+      EXPECT_GE(sketch.estimate(key), key % 7 + 1) << "Sketch undercounted key " << key;
+    }
+  }
+
+  TEST(count_min_sketch, narrow_counters_saturate) {
+    count_min_sketch<std::uint8_t> sketch{16, 2};
+    sketch.increment(1, 200);
+    sketch.increment(1, 200);
+    EXPECT_EQ(sketch.estimate(1), 255u) << "Counter wrapped instead of saturating.";
+  }
+
+  TEST(count_min_sketch, halving_ages_every_counter) {
+    count_min_sketch<> sketch{16, 2};
+    sketch.increment(7, 10);
+    sketch.halve();
+    EXPECT_EQ(sketch.estimate(7), 5u) << "Halving did not age the counter.";
+    sketch.clear();
+    EXPECT_EQ(sketch.estimate(7), 0u) << "Clearing did not reset the counter.";
+  }
+}  // namespace hh::collection
@@ -0,0 +1,156 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hh/counter.hpp>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+  enum class colour { red, green, blue, count };
+}  // namespace
+
+template <> struct hh::collection::counter_domain<colour> {
+  static constexpr std::size_t size = static_cast<std::size_t>(colour::count);
+};
+
+namespace hh::collection {
+
+  namespace {
+    template <typename KEY> std::vector<KEY> random_keys(std::size_t length, int universe) {
+      std::mt19937 generator{7};
+      std::uniform_int_distribution<int> distribution{0, universe - 1};
+      std::vector<KEY> keys;
+      for (std::size_t index = 0; index < length; ++index) {
+        keys.push_back(static_cast<KEY>(distribution(generator)));
+      }
+      return keys;
+    }
+
+    /** Counts the range the obvious way for comparison. */
+    template <typename KEY> std::vector<std::pair<KEY, std::int64_t>> reference_counts(
+        const std::vector<KEY>& keys) {
+      std::vector<std::pair<KEY, std::int64_t>> counts;
+      for (const auto& key : keys) {
+        auto found = std::find_if(counts.begin(), counts.end(),
+                                  [&key](const auto& entry) { return entry.first == key; });
+        if (found == counts.end()) {
+          counts.emplace_back(key, 1);
+        } else {
+          ++found->second;
+        }
+      }
+      return counts;
+    }
+
+    template <typename KEY> void expect_counts(const counter<KEY>& counted,
+                                               const std::vector<KEY>& keys) {
+      const auto expected = reference_counts(keys);
+      EXPECT_EQ(counted.size(), expected.size()) << "Counter has the wrong number of keys.";
+      EXPECT_EQ(counted.total(), static_cast<std::int64_t>(keys.size()))
+          << "Counter total does not match the range length.";
+      for (const auto& [key, count] : expected) {
+        EXPECT_EQ(counted[key], count) << "Counter miscounted a key.";
+      }
+    }
+  }  // namespace
+
+  TEST(counter, counts_a_range_in_a_hash_table) {
+    const auto keys = random_keys<std::uint64_t>(5000, 300);
+    const counter counted(keys.begin(), keys.end());
+    EXPECT_FALSE(counted.is_dense) << "Wide integers were counted densely.";
+    expect_counts(counted, keys);
+  }
+
+  TEST(counter, counts_a_range_of_bytes) {
+    const auto keys = random_keys<char>(5003, 256);
+    const counter counted(keys.begin(), keys.end());
+    EXPECT_TRUE(counted.is_dense) << "Bytes were not counted densely.";
+    expect_counts(counted, keys);
+  }
+
+  TEST(counter, counts_a_range_of_short_integers_densely) {
+    const auto keys = random_keys<std::int16_t>(5000, 40000);
+    const counter counted(keys.begin(), keys.end());
+    EXPECT_TRUE(counted.is_dense) << "Short integers were not counted densely.";
+    expect_counts(counted, keys);
+  }
+
+  TEST(counter, counts_strings) {
+    const counter<std::string> counted{"a", "b", "a", "c", "a", "b"};
+    EXPECT_EQ(counted["a"], 3) << "Counter miscounted a string.";
+    EXPECT_EQ(counted["b"], 2) << "Counter miscounted a string.";
+    EXPECT_EQ(counted["z"], 0) << "Uncounted string has a count.";
+    EXPECT_EQ(counted.size(), 3u) << "Counter has the wrong number of keys.";
+  }
+
+  TEST(counter, counts_enumerations_with_a_declared_domain_densely) {
+    counter<colour> counted{colour::red, colour::blue, colour::blue};
+    EXPECT_TRUE(counted.is_dense) << "Enumeration with a domain was not counted densely.";
+    EXPECT_EQ(counted[colour::blue], 2) << "Counter miscounted an enumerator.";
+    EXPECT_EQ(counted[colour::green], 0) << "Uncounted enumerator has a count.";
+    EXPECT_THROW(counted.add(static_cast<colour>(7)), std::out_of_range)
+        << "Key outside the dense domain was accepted.";
+  }
+
+  TEST(counter, most_common_returns_the_highest_counts_first) {
+    const counter<char> counted{'a', 'b', 'b', 'c', 'c', 'c', 'd'};
+    const auto top = counted.most_common(2);
+    ASSERT_EQ(top.size(), 2u) << "most_common returned the wrong number of keys.";
+    EXPECT_EQ(top[0], std::make_pair('c', std::int64_t{3})) << "most_common is out of order.";
+    EXPECT_EQ(top[1], std::make_pair('b', std::int64_t{2})) << "most_common is out of order.";
+    EXPECT_EQ(counted.most_common().size(), 4u) << "most_common did not return every key.";
+  }
+
+  TEST(counter, merging_adds_counts) {
+    counter<std::string> left{"a", "b"};
+    const counter<std::string> right{"b", "c"};
+    left.update(right);
+    EXPECT_EQ(left, (counter<std::string>{"a", "b", "b", "c"})) << "Merge did not add counts.";
+    EXPECT_EQ(left + right, (counter<std::string>{"a", "b", "b", "b", "c", "c"}))
+        << "Addition did not add counts.";
+  }
+
+  TEST(counter, subtract_keeps_negative_counts_and_drops_zero_counts) {
+    counter<std::string> left{"a", "a", "b"};
+    left.subtract(counter<std::string>{"a", "b", "c"});
+    EXPECT_EQ(left["a"], 1) << "Subtract miscounted a key.";
+    EXPECT_EQ(left["c"], -1) << "Subtract dropped a negative count.";
+    EXPECT_EQ(left.size(), 2u) << "Subtract kept a zero count.";
+  }
+
+  TEST(counter, difference_keeps_only_positive_counts) {
+    const counter<int> left{1, 1, 2};
+    const counter<int> right{1, 2, 2, 3};
+    EXPECT_EQ(left - right, counter<int>{1}) << "Difference kept non-positive counts.";
+  }
+
+  TEST(counter, erasing_keeps_colliding_keys_reachable) {
+    counter<std::uint64_t> counted;
+    for (std::uint64_t key = 0; key < 1000; ++key) {
+      counted.add(key, static_cast<std::int64_t>(key + 1));
+    }
+    for (std::uint64_t key = 0; key < 1000; key += 2) {
+      counted.erase(key);
+    }
+    EXPECT_EQ(counted.size(), 500u) << "Erase removed the wrong number of keys.";
+    for (std::uint64_t key = 1; key < 1000; key += 2) {
+      ASSERT_EQ(counted[key], static_cast<std::int64_t>(key + 1))
+          << "Erase lost a key which probed past it.";
+    }
+  }
+
+  TEST(counter, parallel_build_matches_a_serial_build) {
+    const auto wide = random_keys<std::uint32_t>(1 << 19, 5000);
+    EXPECT_EQ(counter(wide.begin(), wide.end(), parallel_count{4}),
+              counter(wide.begin(), wide.end()))
+        << "Parallel hash table build differs from a serial one.";
+    const auto bytes = random_keys<std::uint8_t>(1 << 19, 256);
+    EXPECT_EQ(counter(bytes.begin(), bytes.end(), parallel_count{4}),
+              counter(bytes.begin(), bytes.end()))
+        << "Parallel byte histogram differs from a serial one.";
+  }
+}  // namespace hh::collection
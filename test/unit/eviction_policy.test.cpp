@@ -0,0 +1,188 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <hh/eviction_policy.hpp>
+#include <hh/lru_cache.hpp>
+#include <string>
+
+namespace hh::functools {
+
+  namespace {
+    template <typename EVICTION_POLICY> struct counted_cache {
+      int d_calls = 0;
+      basic_lru_cache<int(int), EVICTION_POLICY> d_cache;
+
+      explicit counted_cache(unsigned int size)
+          : d_cache{std::function<int(int)>{[this](int value) {
+                      ++d_calls;
+                      return value * 2;
+                    }},
+                    size} {}
+    };
+
+    /** Weighs an entry by the length of its string value. */
+    struct length_weigher {
+      template <typename KEY> std::size_t operator()(const KEY&, const std::string& value) const {
+        return value.size();
+      }
+    };
+
+    /** A key element without a std::hash specialisation, hashed by the cache from its bytes. */
+    struct cell {
+      int d_row;
+      int d_column;
+
+      bool operator==(const cell& other) const {
+        return d_row == other.d_row && d_column == other.d_column;
+      }
+    };
+
+    template <typename EVICTION_POLICY> class eviction_policy : public ::testing::Test {};
+
+    using policies = ::testing::Types<lru_eviction, segmented_lru_eviction<>, arc_eviction,
+                                      wtinylfu_eviction<>>;
+    using scan_resistant_policies
+        = ::testing::Types<segmented_lru_eviction<>, arc_eviction, wtinylfu_eviction<>>;
+
+    template <typename EVICTION_POLICY> class scan_resistant_eviction_policy
+        : public ::testing::Test {};
+  }  // namespace
+
+  TYPED_TEST_SUITE(eviction_policy, policies);
+  TYPED_TEST_SUITE(scan_resistant_eviction_policy, scan_resistant_policies);
+
+  TYPED_TEST(eviction_policy, cached_results_match_the_underlying_function) {
+    counted_cache<TypeParam> cache{32};
+    unsigned int state = 42u;
+    for (int i = 0; i < 5000; ++i) {
+      state = state * 1103515245u + 12345u;
+      const int key = static_cast<int>((state >> 16) % 96);
+      ASSERT_EQ(cache.d_cache(key), key * 2) << "Policy returned a stale or foreign entry.";
+      ASSERT_LE(cache.d_cache.size(), 32) << "Policy let the cache grow beyond its maximum size.";
+    }
+  }
+
+  TYPED_TEST(eviction_policy, repeated_calls_are_served_from_cache) {
+    counted_cache<TypeParam> cache{8};
+    cache.d_cache(1);
+    cache.d_cache(1);
+    cache.d_cache(1);
+    EXPECT_EQ(cache.d_calls, 1) << "Repeated calls were not served from the cache.";
+  }
+
+  TYPED_TEST(eviction_policy, unbounded_caches_never_evict) {
+    counted_cache<TypeParam> cache{0};
+    for (int i = 0; i < 1000; ++i) {
+      cache.d_cache(i);
+    }
+    for (int i = 0; i < 1000; ++i) {
+      cache.d_cache(i);
+    }
+    EXPECT_EQ(cache.d_calls, 1000) << "Unbounded cache evicted entries.";
+    EXPECT_EQ(cache.d_cache.size(), 1000) << "Unbounded cache evicted entries.";
+  }
+
+  TYPED_TEST(eviction_policy, single_entry_caches_keep_the_latest_value) {
+    counted_cache<TypeParam> cache{1};
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(cache.d_cache(i), i * 2) << "Single entry cache returned the wrong value.";
+    }
+    EXPECT_EQ(cache.d_cache.size(), 1) << "Single entry cache grew beyond one entry.";
+  }
+
+  TYPED_TEST(eviction_policy, weight_budgets_evict_in_policy_order) {
+    basic_lru_cache<int(int), TypeParam, default_weigher> cache{
+        std::function<int(int)>{[](int value) { return value; }}, 0, 10 * default_weigher{}(
+            std::tuple<int>{0}, 0)};
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_EQ(cache(i % 37), i % 37) << "Weighted cache returned a stale or foreign entry.";
+      ASSERT_LE(cache.weight(), cache.max_weight()) << "Weighted cache exceeded its budget.";
+    }
+    EXPECT_EQ(cache.size(), 10u) << "Weighted cache did not fill its budget.";
+  }
+
+  TYPED_TEST(eviction_policy, entries_heavier_than_the_budget_are_returned_and_kept) {
+    basic_lru_cache<std::string(std::size_t), TypeParam, length_weigher> cache{
+        std::function<std::string(std::size_t)>{
+            [](std::size_t length) { return std::string(length, 'x'); }},
+        0, 100, length_weigher{}};
+    for (int round = 0; round < 3; ++round) {
+      for (std::size_t length = 1; length <= 8; ++length) {
+        cache(length);
+      }
+    }
+    EXPECT_EQ(cache(500), std::string(500, 'x')) << "The heavy entry was evicted before returning.";
+    EXPECT_EQ(cache.size(), 1u) << "Lighter entries were kept beside an oversized one.";
+    EXPECT_EQ(cache.weight(), 500u) << "The heavy entry was not kept.";
+    EXPECT_EQ(cache(3), std::string(3, 'x')) << "The cache was corrupted by the heavy entry.";
+    EXPECT_LE(cache.weight(), cache.max_weight()) << "Cache exceeded its weight budget.";
+  }
+
+  TYPED_TEST(eviction_policy, keys_without_std_hash_are_cached) {
+    int calls = 0;
+    basic_lru_cache<int(cell, int), TypeParam> cache{std::function<int(cell, int)>{
+                                                         [&calls](const cell& at, int offset) {
+                                                           ++calls;
+                                                           return at.d_row * 8 + at.d_column
+                                                                  + offset;
+                                                         }},
+                                                     16};
+    for (int round = 0; round < 3; ++round) {
+      for (int row = 0; row < 4; ++row) {
+        EXPECT_EQ(cache(cell{row, row}, 1), row * 9 + 1) << "Policy returned a foreign entry.";
+      }
+    }
+    EXPECT_EQ(calls, 4) << "Repeated keys were not served from the cache.";
+  }
+
+  TYPED_TEST(scan_resistant_eviction_policy, frequently_used_entries_survive_a_scan) {
+    constexpr static auto HOT_KEYS = 20;
+    counted_cache<TypeParam> cache{100};
+    for (int round = 0; round < 5; ++round) {
+      for (int i = 0; i < HOT_KEYS; ++i) {
+        cache.d_cache(i);
+      }
+    }
+    for (int i = 1000; i < 1500; ++i) {
+      cache.d_cache(i);
+    }
+    const int calls_before = cache.d_calls;
+    for (int i = 0; i < HOT_KEYS; ++i) {
+      cache.d_cache(i);
+    }
+    EXPECT_EQ(cache.d_calls, calls_before) << "The scan flushed frequently used entries.";
+  }
+
+  TEST(lru_eviction, a_scan_flushes_frequently_used_entries) {
+    counted_cache<lru_eviction> cache{100};
+    for (int round = 0; round < 5; ++round) {
+      for (int i = 0; i < 20; ++i) {
+        cache.d_cache(i);
+      }
+    }
+    for (int i = 1000; i < 1500; ++i) {
+      cache.d_cache(i);
+    }
+    const int calls_before = cache.d_calls;
+    cache.d_cache(0);
+    EXPECT_EQ(cache.d_calls, calls_before + 1) << "Strict LRU retained an entry older than a scan.";
+  }
+
+  TEST(arc_eviction, ghost_hits_readmit_entries_as_frequent) {
+    counted_cache<arc_eviction> cache{4};
+    cache.d_cache(0);
+    cache.d_cache(0);
+    for (int i = 1; i < 5; ++i) {
+      cache.d_cache(i);
+    }
+    cache.d_cache(1);
+    const int calls_before = cache.d_calls;
+    for (int i = 100; i < 104; ++i) {
+      cache.d_cache(i);
+    }
+    cache.d_cache(0);
+    cache.d_cache(1);
+    EXPECT_EQ(cache.d_calls, calls_before + 4)
+        << "An entry readmitted from a ghost list was not protected from new entries.";
+  }
+}  // namespace hh::functools
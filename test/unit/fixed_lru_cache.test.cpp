@@ -0,0 +1,157 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <hh/fixed_lru_cache.hpp>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+
+    std::size_t length(const std::string& value) { return value.size(); }
+
+    /** A copy-only value which counts its instances and throws on a chosen copy. */
+    struct fragile {
+      static int s_live;
+      static int s_copies_until_throw;
+      int d_value;
+
+      explicit fragile(int value) : d_value{value} { ++s_live; }
+      fragile(const fragile& other) : d_value{other.d_value} {
+        if (s_copies_until_throw > 0 && --s_copies_until_throw == 0) {
+          throw std::runtime_error("copy failed");
+        }
+        ++s_live;
+      }
+      fragile& operator=(const fragile&) = delete;
+      ~fragile() { --s_live; }
+    };
+
+    int fragile::s_live = 0;
+    int fragile::s_copies_until_throw = 0;
+
+    fragile make_fragile(int value) { return fragile{value}; }
+
+    /** Makes the copy into the cache slot throw, once while filling and once while evicting. */
+    template <std::size_t CAPACITY> void expect_throwing_slot_copies_are_rolled_back() {
+      {
+        auto cache = make_fixed_lrucache<CAPACITY>(make_fragile);
+        // The first copy builds the entry, the second moves it into its slot.
+        fragile::s_copies_until_throw = 2;
+        EXPECT_THROW(cache(0), std::runtime_error) << "The failing copy was swallowed.";
+        EXPECT_EQ(cache.size(), 0u) << "A slot which failed to construct was counted.";
+        for (int i = 1; i <= static_cast<int>(CAPACITY); ++i) {
+          EXPECT_EQ(cache(i).d_value, i) << "The cache failed after a throwing copy.";
+        }
+        fragile::s_copies_until_throw = 2;
+        EXPECT_THROW(cache(-1), std::runtime_error) << "The failing copy was swallowed.";
+        EXPECT_EQ(cache.size(), CAPACITY - 1) << "The failed insertion kept a broken entry.";
+        for (int i = 2; i <= static_cast<int>(CAPACITY); ++i) {
+          EXPECT_EQ(cache(i).d_value, i) << "An entry was lost to the failed insertion.";
+        }
+        EXPECT_EQ(cache(-2).d_value, -2) << "The freed slot could not be reused.";
+        EXPECT_EQ(cache(-3).d_value, -3) << "Eviction failed after the freed slot was reused.";
+        EXPECT_EQ(cache.size(), CAPACITY) << "The cache did not fill up again.";
+      }
+      EXPECT_EQ(fragile::s_live, 0) << "Entries were destroyed twice or leaked.";
+    }
+
+    /** Calls a cache of the given capacity over a pattern of keys, checking LRU eviction. */
+    template <std::size_t CAPACITY> void expect_least_recently_used_eviction() {
+      int calls = 0;
+      std::function<int(int, int)> counted_add = [&calls](int a, int b) {
+        ++calls;
+        return a + b;
+      };
+      auto cached_add = make_fixed_lrucache<CAPACITY>(counted_add);
+      for (int i = 0; i < static_cast<int>(CAPACITY); ++i) {
+        cached_add(i, i);
+      }
+      cached_add(0, 0);
+      cached_add(-1, -1);
+      EXPECT_EQ(cached_add.size(), CAPACITY) << "Cache grew past its capacity.";
+      calls = 0;
+      cached_add(0, 0);
+      EXPECT_EQ(calls, 0) << "Recently used entry was evicted.";
+      cached_add(1, 1);
+      EXPECT_EQ(calls, 1) << "Least recently used entry was not evicted.";
+    }
+  }  // namespace
+
+  TEST(fixed_lru_cache, invocation_of_cached_method_is_equivialant_to_non_cached_variant) {
+    auto cached_add = make_fixed_lrucache<4>(add);
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation and non cached evaluation differ.";
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation differs on reuse.";
+  }
+
+  TEST(fixed_lru_cache, size_increases_as_unique_parameterised_calls_are_made) {
+    auto cached_add = make_fixed_lrucache<4>(add);
+    cached_add(1, 1);
+    cached_add(1, 2);
+    cached_add(1, 2);
+    EXPECT_EQ(cached_add.size(), 2) << "Repeated calls should not grow the cache.";
+  }
+
+  TEST(fixed_lru_cache, small_caches_scan_and_large_caches_hash) {
+    EXPECT_TRUE((fixed_lru_cache<8, int, int, int>::is_linear_scan))
+        << "A small cache does not scan its entries.";
+    EXPECT_FALSE((fixed_lru_cache<9, int, int, int>::is_linear_scan))
+        << "A large cache does not hash its keys.";
+  }
+
+  TEST(fixed_lru_cache, scanning_cache_evicts_the_least_recently_used_entry) {
+    expect_least_recently_used_eviction<2>();
+    expect_least_recently_used_eviction<8>();
+  }
+
+  TEST(fixed_lru_cache, hashing_cache_evicts_the_least_recently_used_entry) {
+    expect_least_recently_used_eviction<64>();
+    expect_least_recently_used_eviction<300>();
+  }
+
+  TEST(fixed_lru_cache, hashing_cache_keeps_every_entry_reachable_under_churn) {
+    int calls = 0;
+    std::function<int(int, int)> counted_add = [&calls](int a, int b) {
+      ++calls;
+      return a + b;
+    };
+    auto counted = make_fixed_lrucache<64>(counted_add);
+    for (int i = 0; i < 10000; ++i) {
+      counted(i, 0);
+    }
+    calls = 0;
+    for (int i = 10000 - 64; i < 10000; ++i) {
+      EXPECT_EQ(counted(i, 0), i) << "Cached value differs after churn.";
+    }
+    EXPECT_EQ(calls, 0) << "An entry became unreachable after evictions shifted the index.";
+  }
+
+  TEST(fixed_lru_cache, looks_up_strings_without_building_the_key) {
+    auto cached_length = make_fixed_lrucache<4>(length);
+    EXPECT_EQ(cached_length(std::string{"four"}), 4u) << "Cached evaluation differs.";
+    EXPECT_EQ(cached_length("four"), 4u) << "Character pointer did not find the string entry.";
+    EXPECT_EQ(cached_length.size(), 1u) << "Character pointer added a second entry.";
+  }
+
+  TEST(fixed_lru_cache, destroys_evicted_and_remaining_entries) {
+    auto value = std::make_shared<int>(1);
+    std::function<std::shared_ptr<int>(int)> share = [&value](int) { return value; };
+    {
+      auto cache = make_fixed_lrucache<2>(share);
+      cache(1);
+      cache(2);
+      cache(3);
+      EXPECT_EQ(value.use_count(), 3) << "Evicted entry was not destroyed.";
+    }
+    EXPECT_EQ(value.use_count(), 1) << "Cache did not destroy its entries.";
+  }
+
+  TEST(fixed_lru_cache, throwing_copies_into_a_slot_leave_the_cache_consistent) {
+    expect_throwing_slot_copies_are_rolled_back<4>();
+    expect_throwing_slot_copies_are_rolled_back<16>();
+  }
+}  // namespace hh::functools
@@ -0,0 +1,158 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <hh/flat_lru_cache.hpp>
+#include <hh/lru_cache.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+
+    std::size_t length(const std::string& value) { return value.size(); }
+
+    struct fragile {
+      static int s_live;
+      static int s_copies;
+      static int s_copies_until_throw;
+      int d_value;
+
+      explicit fragile(int value) : d_value{value} { ++s_live; }
+      fragile(const fragile& other) : d_value{other.d_value} {
+        ++s_copies;
+        if (s_copies_until_throw > 0 && --s_copies_until_throw == 0) {
+          throw std::runtime_error("copy failed");
+        }
+        ++s_live;
+      }
+      fragile& operator=(const fragile&) = delete;
+      ~fragile() { --s_live; }
+    };
+
+    int fragile::s_live = 0;
+    int fragile::s_copies = 0;
+    int fragile::s_copies_until_throw = 0;
+
+    fragile make_fragile(int value) { return fragile{value}; }
+  }  // namespace
+
+  TEST(flat_lru_cache, invocation_of_cached_method_is_equivialant_to_non_cached_variant) {
+    auto cached_add = hh::functools::make_flat_lrucache(add);
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation and non cached evaluation differ.";
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation differs on reuse.";
+  }
+
+  TEST(flat_lru_cache, size_increases_as_unique_parameterised_calls_are_made) {
+    auto cached_add = hh::functools::make_flat_lrucache(add);
+    cached_add(1, 1);
+    cached_add(1, 2);
+    cached_add(1, 2);
+    EXPECT_EQ(cached_add.size(), 2) << "Repeated calls should not grow the cache.";
+  }
+
+  TEST(flat_lru_cache, least_recently_used_entry_is_evicted) {
+    int calls = 0;
+    std::function<int(int, int)> counted_add = [&calls](int a, int b) {
+      ++calls;
+      return a + b;
+    };
+    auto cached_add = hh::functools::make_flat_lrucache(counted_add, 2);
+    cached_add(1, 1);
+    cached_add(2, 2);
+    cached_add(1, 1);
+    cached_add(3, 3);
+    cached_add(1, 1);
+    EXPECT_EQ(calls, 3) << "Recently used entry was evicted.";
+    cached_add(2, 2);
+    EXPECT_EQ(calls, 4) << "Least recently used entry was not evicted.";
+    EXPECT_EQ(cached_add.size(), 2) << "The cache grew beyond its maximum size.";
+  }
+
+  TEST(flat_lru_cache, unbounded_cache_grows_past_its_initial_slots) {
+    auto cached_add = hh::functools::make_flat_lrucache(add, 0);
+    for (int i = 0; i < 1000; ++i) {
+      cached_add(i, i);
+    }
+    EXPECT_EQ(cached_add.size(), 1000) << "Unbounded cache dropped entries while growing.";
+    EXPECT_EQ(cached_add(999, 999), 999 + 999) << "Entries were lost while growing.";
+  }
+
+  TEST(flat_lru_cache, throwing_slot_copies_leave_the_cache_consistent) {
+    {
+      auto cache = make_flat_lrucache(make_fragile, 3);
+      fragile::s_copies = 0;
+      EXPECT_EQ(cache(1).d_value, 1) << "Cached evaluation differs from the function.";
+      // The copy into the cache slot is the last one before the result is copied out.
+      const int copies_per_miss = fragile::s_copies;
+      fragile::s_copies_until_throw = copies_per_miss - 1;
+      EXPECT_THROW(cache(0), std::runtime_error) << "The failing copy was swallowed.";
+      EXPECT_EQ(cache.size(), 1u) << "A slot which failed to construct was counted.";
+      EXPECT_EQ(cache(2).d_value, 2) << "The cache failed after a throwing copy.";
+      EXPECT_EQ(cache(3).d_value, 3) << "The cache failed after a throwing copy.";
+      fragile::s_copies_until_throw = copies_per_miss - 1;
+      EXPECT_THROW(cache(-1), std::runtime_error) << "The failing copy was swallowed.";
+      EXPECT_EQ(cache.size(), 2u) << "The failed insertion kept a broken entry.";
+      fragile::s_copies = 0;
+      EXPECT_EQ(cache(2).d_value, 2) << "An entry was lost to the failed insertion.";
+      EXPECT_EQ(cache(3).d_value, 3) << "An entry was lost to the failed insertion.";
+      EXPECT_EQ(fragile::s_copies, 2) << "A retained entry was recomputed.";
+      EXPECT_EQ(cache(-2).d_value, -2) << "The freed slot could not be reused.";
+      EXPECT_EQ(cache(-3).d_value, -3) << "Eviction failed after the freed slot was reused.";
+      EXPECT_EQ(cache.size(), 3u) << "The cache did not fill up again.";
+    }
+    EXPECT_EQ(fragile::s_live, 0) << "Entries were destroyed twice or leaked.";
+  }
+
+  TEST(flat_lru_cache, unbounded_cache_survives_throwing_slot_copies) {
+    {
+      auto cache = make_flat_lrucache(make_fragile, 0);
+      fragile::s_copies = 0;
+      cache(0);
+      const int copies_per_miss = fragile::s_copies;
+      for (int i = 1; i < 16; ++i) {
+        cache(i);
+      }
+      // Growing copies the 16 retained entries, then the first insertion into the new slots fails.
+      fragile::s_copies_until_throw = 16 + copies_per_miss - 1;
+      EXPECT_THROW(cache(-1), std::runtime_error) << "The failing copy was swallowed.";
+      EXPECT_EQ(cache.size(), 16u) << "A slot which failed to construct was counted.";
+      for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(cache(i).d_value, i) << "The cache failed to grow after a throwing copy.";
+      }
+      EXPECT_EQ(cache.size(), 100u) << "Unbounded cache dropped entries while growing.";
+    }
+    EXPECT_EQ(fragile::s_live, 0) << "Entries were destroyed twice or leaked.";
+  }
+
+  TEST(flat_lru_cache, string_keys_are_cached) {
+    auto cached_length = hh::functools::make_flat_lrucache(length, 4);
+    EXPECT_EQ(cached_length(std::string{"a long string which will not fit inline"}), 39u);
+    EXPECT_EQ(cached_length(std::string{"short"}), 5u);
+    EXPECT_EQ(cached_length.size(), 2) << "String keys were not stored.";
+  }
+
+  TEST(flat_lru_cache, evictions_match_the_list_based_lru_cache) {
+    int flat_calls = 0;
+    int list_calls = 0;
+    std::function<int(int, int)> flat_add = [&flat_calls](int a, int b) {
+      ++flat_calls;
+      return a + b;
+    };
+    std::function<int(int, int)> list_add = [&list_calls](int a, int b) {
+      ++list_calls;
+      return a + b;
+    };
+    auto flat_cache = hh::functools::make_flat_lrucache(flat_add, 64);
+    auto list_cache = hh::functools::make_lrucache(list_add, 64);
+    unsigned int state = 12345u;
+    for (int i = 0; i < 20000; ++i) {
+      state = state * 1103515245u + 12345u;
+      const int key = static_cast<int>((state >> 16) % 128);
+      ASSERT_EQ(flat_cache(key, key), list_cache(key, key));
+      ASSERT_EQ(flat_calls, list_calls) << "Flat cache evicted a different entry at step " << i;
+    }
+  }
+}  // namespace hh::functools
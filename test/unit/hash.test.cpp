@@ -0,0 +1,94 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hh/call_counter.hpp>
+#include <hh/hash.hpp>
+#include <hh/lru_cache.hpp>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+    std::size_t length(const std::string& text, int extra) { return text.size() + extra; }
+
+    /** The chi-square statistic of the low bits of the hashes of a grid of integer pairs. */
+    template <typename KEY_HASH> double chi_square_over_buckets(std::size_t buckets) {
+      std::vector<double> observed(buckets);
+      constexpr int side = 256;
+      for (int first = 0; first < side; ++first) {
+        for (int second = 0; second < side; ++second) {
+          ++observed[KEY_HASH{}(std::make_tuple(first, second)) & (buckets - 1)];
+        }
+      }
+      const double expected = static_cast<double>(side * side) / static_cast<double>(buckets);
+      double statistic = 0.0;
+      for (auto count : observed) {
+        statistic += (count - expected) * (count - expected) / expected;
+      }
+      return statistic;
+    }
+  }  // namespace
+
+  TEST(hash, wyhash_depends_on_every_byte_and_the_seed) {
+    const std::string text(100, 'x');
+    const auto hash = wyhash(text.data(), text.size());
+    EXPECT_EQ(hash, wyhash(text.data(), text.size())) << "wyhash is not deterministic.";
+    EXPECT_NE(hash, wyhash(text.data(), text.size(), 1)) << "wyhash ignored its seed.";
+    for (std::size_t length = 0; length < text.size(); ++length) {
+      std::string changed = text.substr(0, length + 1);
+      changed[length] = 'y';
+      EXPECT_NE(wyhash(changed.data(), changed.size()), wyhash(text.data(), length + 1))
+          << "wyhash ignored byte " << length;
+    }
+  }
+
+  TEST(hash, contiguous_keys_hash_their_probes_alike) {
+    using key = std::tuple<int, std::uint64_t, char>;
+    EXPECT_TRUE(wy_key_hash<key>::is_contiguous) << "Integer key was not hashed contiguously.";
+    const key stored{1, 2, 'c'};
+    const long first = 1;
+    const int second = 2;
+    const char third = 'c';
+    EXPECT_EQ(wy_key_hash<key>{}(stored),
+              wy_key_hash<key>{}(std::forward_as_tuple(first, second, third)))
+        << "A probe of different argument types hashed differently to its key.";
+  }
+
+  TEST(hash, element_wise_keys_hash_their_probes_alike) {
+    using key = std::tuple<std::string, double>;
+    EXPECT_FALSE(wy_key_hash<key>::is_contiguous) << "String key was hashed contiguously.";
+    const key stored{"text", 0.5};
+    const char* text = "text";
+    const float half = 0.5f;
+    EXPECT_EQ(wy_key_hash<key>{}(stored), wy_key_hash<key>{}(std::forward_as_tuple(text, half)))
+        << "A probe of different argument types hashed differently to its key.";
+    EXPECT_NE(wy_key_hash<key>{}(stored), wy_key_hash<key>{}(key{"text", 1.5}))
+        << "Keys differing in one element hashed alike.";
+  }
+
+  TEST(hash, wy_hasher_spreads_integer_pairs_over_buckets) {
+    using pair_hash = wy_key_hash<std::tuple<int, int>>;
+    // With 1023 degrees of freedom a uniform hash stays below 1200 with 99.9% probability.
+    EXPECT_LT(chi_square_over_buckets<pair_hash>(1024), 1200.0)
+        << "wyhash clustered integer pairs into buckets.";
+  }
+
+  TEST(hash, caches_and_counters_accept_a_hasher) {
+    basic_lru_cache<int(int, int), lru_eviction, unit_weigher, no_metrics, combining_hasher> cache{
+        add, 4};
+    EXPECT_EQ(cache(1, 2), 3) << "Cache with a chosen hasher returned the wrong value.";
+    EXPECT_EQ(cache(1, 2), 3) << "Cache with a chosen hasher returned the wrong value.";
+    EXPECT_EQ(cache.size(), 1u) << "Cache with a chosen hasher did not find its entry.";
+
+    basic_call_counter<std::size_t(const std::string&, int), combining_hasher> counter{length};
+    counter(std::string{"abc"}, 1);
+    counter(std::string{"abc"}, 1);
+    EXPECT_EQ(counter.call_count(std::string{"abc"}, 1), 2)
+        << "Counter with a chosen hasher miscounted.";
+  }
+}  // namespace hh::functools
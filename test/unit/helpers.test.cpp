@@ -0,0 +1,191 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <hh/executor.hpp>
+#include <hh/helpers.hpp>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace hh::helpers {
+
+  namespace {
+    using call = std::tuple<int, std::string>;
+
+    /** A bulk function recording the batches it is called with. */
+    struct recording_bulk {
+      std::shared_ptr<std::mutex> d_mutex = std::make_shared<std::mutex>();
+      std::shared_ptr<std::vector<std::vector<call>>> d_batches
+          = std::make_shared<std::vector<std::vector<call>>>();
+
+      std::vector<std::string> operator()(const std::vector<call>& calls) const {
+        {
+          std::lock_guard<std::mutex> lock{*d_mutex};
+          d_batches->push_back(calls);
+        }
+        std::vector<std::string> results;
+        for (const auto& [count, text] : calls) {
+          std::string repeated;
+          for (int index = 0; index < count; ++index) {
+            repeated += text;
+          }
+          results.push_back(repeated);
+        }
+        return results;
+      }
+    };
+
+    constexpr auto LONG_WAIT = std::chrono::seconds(10);
+
+    struct refusing_executor {
+      template <typename TASK> void execute(TASK&&) const {
+        throw std::runtime_error("executor refused the task");
+      }
+    };
+
+    /** A result whose copy throws once the given number of copies have been made. */
+    struct fragile {
+      static int s_copies_until_throw;
+      int d_value;
+
+      explicit fragile(int value) : d_value{value} {}
+      fragile(const fragile& other) : d_value{other.d_value} {
+        if (s_copies_until_throw > 0 && --s_copies_until_throw == 0) {
+          throw std::runtime_error("copy failed");
+        }
+      }
+    };
+
+    int fragile::s_copies_until_throw = 0;
+  }  // namespace
+
+  TEST(make_batched, calls_receive_their_own_results) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 3, LONG_WAIT, hh::functools::inline_executor{});
+    auto first = batched(2, "ab");
+    auto second = batched(1, "c");
+    auto third = batched(3, "d");
+    EXPECT_EQ(first.get(), "abab") << "First call got the wrong result.";
+    EXPECT_EQ(second.get(), "c") << "Second call got the wrong result.";
+    EXPECT_EQ(third.get(), "ddd") << "Third call got the wrong result.";
+    ASSERT_EQ(bulk.d_batches->size(), 1u) << "Calls were not gathered into one batch.";
+    EXPECT_EQ(bulk.d_batches->front().size(), 3u) << "The batch did not hold every call.";
+  }
+
+  TEST(make_batched, identical_calls_are_sent_once) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 2, LONG_WAIT, hh::functools::inline_executor{});
+    auto first = batched(2, "x");
+    auto repeated = batched(2, std::string{"x"});
+    auto other = batched(1, "y");
+    EXPECT_EQ(first.get(), "xx") << "First caller got the wrong result.";
+    EXPECT_EQ(repeated.get(), "xx") << "Deduplicated caller got the wrong result.";
+    EXPECT_EQ(other.get(), "y") << "Other caller got the wrong result.";
+    ASSERT_EQ(bulk.d_batches->size(), 1u) << "A duplicate counted towards the batch size.";
+    EXPECT_EQ(bulk.d_batches->front(), (std::vector<call>{{2, "x"}, {1, "y"}}))
+        << "The bulk function saw a duplicate call.";
+  }
+
+  TEST(make_batched, full_batches_are_flushed_at_once) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 2, LONG_WAIT, hh::functools::inline_executor{});
+    auto first = batched(1, "a");
+    auto second = batched(1, "b");
+    EXPECT_EQ(first.wait_for(std::chrono::seconds(0)), std::future_status::ready)
+        << "A full batch waited for its deadline.";
+    EXPECT_EQ(second.get(), "b") << "Second call got the wrong result.";
+    auto third = batched(1, "c");
+    EXPECT_EQ(batched.batches(), 1u) << "A partial batch was flushed early.";
+    EXPECT_EQ(third.wait_for(std::chrono::seconds(0)), std::future_status::timeout)
+        << "A partial batch was flushed early.";
+  }
+
+  TEST(make_batched, partial_batches_are_flushed_after_max_wait) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 100, std::chrono::milliseconds(20));
+    const auto start = std::chrono::steady_clock::now();
+    auto lone = batched(2, "z");
+    ASSERT_EQ(lone.wait_for(std::chrono::seconds(5)), std::future_status::ready)
+        << "A partial batch was never flushed.";
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(20))
+        << "A partial batch was flushed before its deadline.";
+    EXPECT_EQ(lone.get(), "zz") << "Lone call got the wrong result.";
+  }
+
+  TEST(make_batched, pending_calls_are_flushed_on_destruction) {
+    recording_bulk bulk;
+    std::future<std::string> pending;
+    {
+      auto batched = make_batched(bulk, 100, LONG_WAIT, hh::functools::inline_executor{});
+      pending = batched(1, "q");
+    }
+    ASSERT_EQ(pending.wait_for(std::chrono::seconds(0)), std::future_status::ready)
+        << "A pending call was dropped on destruction.";
+    EXPECT_EQ(pending.get(), "q") << "Flushed call got the wrong result.";
+  }
+
+  TEST(make_batched, exceptions_fail_every_call_in_the_batch) {
+    auto batched = make_batched(
+        [](const std::vector<std::tuple<int>>&) -> std::vector<int> {
+          throw std::runtime_error("backend down");
+        },
+        2, LONG_WAIT, hh::functools::inline_executor{});
+    auto first = batched(1);
+    auto second = batched(2);
+    EXPECT_THROW(first.get(), std::runtime_error) << "First call did not see the exception.";
+    EXPECT_THROW(second.get(), std::runtime_error) << "Second call did not see the exception.";
+  }
+
+  TEST(make_batched, wrong_result_counts_fail_the_batch) {
+    auto batched = make_batched(
+        [](const std::vector<std::tuple<int>>& calls) {
+          return std::vector<int>(calls.size() - 1);
+        },
+        2, LONG_WAIT, hh::functools::inline_executor{});
+    auto first = batched(1);
+    auto second = batched(2);
+    EXPECT_THROW(first.get(), std::length_error) << "A short result was accepted.";
+    EXPECT_THROW(second.get(), std::length_error) << "A short result was accepted.";
+  }
+
+  TEST(make_batched, refused_full_batches_fail_their_calls) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 2, LONG_WAIT, refusing_executor{});
+    auto first = batched(1, "a");
+    std::future<std::string> second;
+    EXPECT_NO_THROW(second = batched(2, "b")) << "The executor's refusal reached the caller.";
+    EXPECT_THROW(first.get(), std::runtime_error) << "A refused call did not fail.";
+    EXPECT_THROW(second.get(), std::runtime_error) << "A refused call did not fail.";
+  }
+
+  TEST(make_batched, refused_partial_batches_fail_their_calls) {
+    recording_bulk bulk;
+    auto batched = make_batched(bulk, 100, std::chrono::milliseconds(1), refusing_executor{});
+    auto result = batched(1, "a");
+    EXPECT_THROW(result.get(), std::runtime_error) << "A call refused by the timer did not fail.";
+  }
+
+  TEST(make_batched, a_throwing_result_copy_fails_only_the_calls_left) {
+    auto batched = make_batched(
+        [](const std::vector<std::tuple<int>>& calls) {
+          std::vector<fragile> results;
+          results.reserve(calls.size());
+          for (const auto& [value] : calls) {
+            results.emplace_back(value);
+          }
+          return results;
+        },
+        2, LONG_WAIT, hh::functools::inline_executor{});
+    // The first result is copied into its future, the copy of the second throws.
+    fragile::s_copies_until_throw = 2;
+    auto first = batched(1);
+    auto second = batched(2);
+    EXPECT_EQ(first.get().d_value, 1) << "A delivered result was replaced by the failure.";
+    EXPECT_THROW(second.get(), std::runtime_error) << "The failed copy was not reported.";
+  }
+}  // namespace hh::helpers
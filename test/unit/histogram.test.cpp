@@ -0,0 +1,56 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hh/histogram.hpp>
+
+namespace hh::collection {
+
+  TEST(log_linear_histogram, small_values_are_exact) {
+    for (std::uint64_t value = 0; value < 32; ++value) {
+      EXPECT_EQ(log_linear_histogram<5>::highest_equivalent(log_linear_histogram<5>::index_of(value)),
+                value)
+          << "Value below the linear range was not recorded exactly.";
+    }
+  }
+
+  TEST(log_linear_histogram, buckets_bound_values_within_their_precision) {
+    for (std::uint64_t value = 1; value < (std::uint64_t{1} << 62); value = value * 3 + 1) {
+      const auto index = log_linear_histogram<5>::index_of(value);
+      ASSERT_LT(index, log_linear_histogram<5>::bucket_count) << "Value fell outside the buckets.";
+      const auto bound = log_linear_histogram<5>::highest_equivalent(index);
+      EXPECT_GE(bound, value) << "Bucket bound was below a value counted in it.";
+      EXPECT_LE(static_cast<double>(bound - value), static_cast<double>(value) / 32.0)
+          << "Bucket bound strayed beyond the histogram's precision for " << value;
+    }
+  }
+
+  TEST(log_linear_histogram, largest_values_fit_in_the_last_bucket) {
+    const auto index = log_linear_histogram<5>::index_of(~std::uint64_t{0});
+    EXPECT_EQ(index, log_linear_histogram<5>::bucket_count - 1) << "Largest value was misplaced.";
+    EXPECT_EQ(log_linear_histogram<5>::highest_equivalent(index), ~std::uint64_t{0})
+        << "Last bucket did not extend to the largest value.";
+  }
+
+  TEST(log_linear_histogram, percentiles_follow_the_recorded_distribution) {
+    log_linear_histogram<> histogram;
+    for (std::uint64_t value = 1; value <= 1000; ++value) {
+      histogram.record(value * 1000);
+    }
+    const auto snapshot = histogram.take_snapshot();
+    EXPECT_EQ(snapshot.count(), 1000u) << "Snapshot lost recorded values.";
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(50)), 500000.0, 500000.0 / 32)
+        << "Median was not within the histogram's precision.";
+    EXPECT_NEAR(static_cast<double>(snapshot.percentile(99)), 990000.0, 990000.0 / 32)
+        << "99th percentile was not within the histogram's precision.";
+    EXPECT_GE(snapshot.max(), 1000000u) << "Maximum was below the largest recorded value.";
+  }
+
+  TEST(log_linear_histogram, empty_snapshots_report_zero) {
+    log_linear_histogram<> histogram;
+    const auto snapshot = histogram.take_snapshot();
+    EXPECT_EQ(snapshot.count(), 0u) << "Empty histogram reported values.";
+    EXPECT_EQ(snapshot.percentile(99), 0u) << "Empty histogram reported a percentile.";
+    EXPECT_EQ(snapshot.max(), 0u) << "Empty histogram reported a maximum.";
+  }
+}  // namespace hh::collection
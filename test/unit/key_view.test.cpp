@@ -0,0 +1,70 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <hh/key_view.hpp>
+#include <hh/lru_cache.hpp>
+#include <string>
+#include <string_view>
+#include <tuple>
+
+namespace hh::functools {
+
+  namespace {
+    using string_key = std::tuple<std::string, int>;
+
+    std::size_t length(const std::string& value) { return value.size(); }
+  }  // namespace
+
+  TEST(key_view, probes_hash_like_the_keys_they_would_build) {
+    const string_key key{"a key long enough to be allocated on the heap", 7};
+    const std::string_view view{std::get<0>(key)};
+    const char* pointer = std::get<0>(key).c_str();
+    const int number = 7;
+    const auto view_probe = std::forward_as_tuple(view, number);
+    const auto pointer_probe = std::forward_as_tuple(pointer, number);
+    const auto stored = key_view<string_key>::stored(key);
+    EXPECT_EQ(key_view<string_key>::probe(view_probe).hash(), stored.hash())
+        << "A string_view probe hashed differently to the stored key.";
+    EXPECT_EQ(key_view<string_key>::probe(pointer_probe).hash(), stored.hash())
+        << "A character pointer probe hashed differently to the stored key.";
+  }
+
+  TEST(key_view, probes_compare_against_stored_keys_in_either_order) {
+    const string_key key{"key", 1};
+    const std::string_view view{"key"};
+    const int one = 1;
+    const int two = 2;
+    const auto matching = std::forward_as_tuple(view, one);
+    const auto different = std::forward_as_tuple(view, two);
+    const auto stored = key_view<string_key>::stored(key);
+    EXPECT_TRUE(key_view<string_key>::probe(matching) == stored) << "Equal probe did not match.";
+    EXPECT_TRUE(stored == key_view<string_key>::probe(matching)) << "Equal probe did not match.";
+    EXPECT_FALSE(key_view<string_key>::probe(different) == stored) << "Different probe matched.";
+  }
+
+  TEST(key_view, converting_arguments_match_their_converted_key) {
+    using double_key = std::tuple<double>;
+    const double_key key{3.0};
+    const int three = 3;
+    const auto probe = std::forward_as_tuple(three);
+    EXPECT_EQ(key_view<double_key>::probe(probe).hash(), key_view<double_key>::stored(key).hash())
+        << "A converting argument hashed differently to its converted key.";
+    EXPECT_TRUE(key_view<double_key>::probe(probe) == key_view<double_key>::stored(key))
+        << "A converting argument did not match its converted key.";
+  }
+
+  TEST(lru_cache, string_views_and_pointers_hit_string_keys) {
+    int calls = 0;
+    auto cache = make_lrucache(std::function<std::size_t(const std::string&)>{
+        [&calls](const std::string& value) {
+          ++calls;
+          return length(value);
+        }});
+    const std::string owned{"heterogeneous"};
+    EXPECT_EQ(cache(owned), owned.size()) << "Cached evaluation did not match the function.";
+    EXPECT_EQ(cache(std::string_view{owned}), owned.size()) << "string_view call did not match.";
+    EXPECT_EQ(cache("heterogeneous"), owned.size()) << "Character pointer call did not match.";
+    EXPECT_EQ(calls, 1) << "Equal keys of different types were not served from the cache.";
+    EXPECT_EQ(cache.size(), 1u) << "Equal keys of different types created separate entries.";
+  }
+}  // namespace hh::functools
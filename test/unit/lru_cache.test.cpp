@@ -2,9 +2,15 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <functional>
 #include <hh/helpers.hpp>
 #include <hh/lru_cache.hpp>
+#include <iterator>
+#include <string>
 #include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
 
 namespace hh::functools {
 
@@ -12,6 +18,13 @@ namespace hh::functools {
     int add(int a, int b) { return a + b; }
 
     int add_ptrs(int* a, int* b) { return *a + *b; }
+
+    class accumulator {
+    public:
+      int add(int value) const { return d_base + value; }
+
+      int d_base = 0;
+    };
   }  // namespace
 
   TEST(lru_cache, initiliased_with_add_with_a_size_of_128) {
@@ -133,4 +146,146 @@ namespace hh::functools {
     EXPECT_LT(cached_time, normal_time - (normal_time / 2))
         << "Retrieving data from cache seems to be extremely slow!";
   }
+
+  TEST(lru_cache, get_many_returns_results_in_call_order) {
+    auto cached_add = hh::functools::make_lrucache(add);
+    cached_add(2, 2);
+    const std::vector<std::tuple<int, int>> calls{{1, 1}, {2, 2}, {3, 4}, {1, 1}};
+    std::vector<int> results;
+    cached_add.get_many(calls, std::back_inserter(results));
+    EXPECT_THAT(results, ::testing::ElementsAre(2, 4, 7, 2))
+        << "Batched results did not match the underlying function in call order.";
+    EXPECT_EQ(cached_add.size(), 3) << "Batched misses were not inserted into the cache.";
+  }
+
+  TEST(lru_cache, get_many_loads_each_distinct_miss_once) {
+    auto cached_add = hh::functools::make_lrucache(add);
+    cached_add(5, 5);
+    const std::vector<std::tuple<int, int>> calls{{1, 2}, {5, 5}, {1, 2}, {3, 3}};
+    std::vector<std::vector<std::tuple<int, int>>> batches;
+    std::vector<int> results;
+    cached_add.get_many(calls, std::back_inserter(results),
+                        [&batches](const std::vector<std::tuple<int, int>>& missing) {
+                          batches.push_back(missing);
+                          std::vector<int> values;
+                          for (const auto& key : missing) {
+                            values.push_back(std::apply(add, key));
+                          }
+                          return values;
+                        });
+    ASSERT_EQ(batches.size(), 1u) << "Misses were not handed to the bulk loader together.";
+    EXPECT_THAT(batches.front(), ::testing::ElementsAre(std::make_tuple(1, 2), std::make_tuple(3, 3)))
+        << "The bulk loader was not given each distinct missing key once.";
+    EXPECT_THAT(results, ::testing::ElementsAre(3, 10, 3, 6)) << "Batched results were wrong.";
+  }
+
+  TEST(lru_cache, get_many_batches_larger_than_the_cache_keep_their_hits) {
+    auto cached_add = hh::functools::make_lrucache(add, 4);
+    std::vector<std::tuple<int, int>> calls;
+    for (int i = 0; i < 16; ++i) {
+      calls.emplace_back(i % 4, i);
+    }
+    std::vector<int> warmup;
+    cached_add.get_many(calls, std::back_inserter(warmup));
+    std::vector<int> results;
+    cached_add.get_many(calls, std::back_inserter(results));
+    for (int i = 0; i < 16; ++i) {
+      EXPECT_EQ(results[static_cast<std::size_t>(i)], i % 4 + i) << "Batched result was wrong.";
+    }
+    EXPECT_EQ(cached_add.size(), 4) << "Batch grew the cache beyond its maximum size.";
+  }
+
+  TEST(lru_cache, function_pointers_are_stored_without_type_erasure) {
+    auto cached_add = hh::functools::make_lrucache(add);
+    static_assert(std::is_same_v<decltype(cached_add)::function_type, int (*)(int, int)>,
+                  "The function pointer was not stored as its own type.");
+    EXPECT_EQ(cached_add(2, 3), 5) << "Cache of a function pointer returned the wrong value.";
+  }
+
+  TEST(lru_cache, lambdas_are_stored_as_their_own_type) {
+    int calls = 0;
+    auto counted_add = [&calls](int a, int b) {
+      ++calls;
+      return a + b;
+    };
+    auto cached_add = hh::functools::make_lrucache(counted_add);
+    static_assert(std::is_same_v<decltype(cached_add)::function_type, decltype(counted_add)>,
+                  "The lambda was not stored as its own type.");
+    cached_add(1, 2);
+    EXPECT_EQ(cached_add(1, 2), 3) << "Cache of a lambda returned the wrong value.";
+    EXPECT_EQ(calls, 1) << "Cache of a lambda did not reuse its historic value.";
+  }
+
+  TEST(lru_cache, mutable_lambdas_can_be_cached) {
+    auto cached_next = hh::functools::make_lrucache([next = 0](int) mutable { return next++; });
+    EXPECT_EQ(cached_next(7), 0) << "Mutable lambda was not called on a miss.";
+    EXPECT_EQ(cached_next(8), 1) << "Mutable lambda did not keep its state between misses.";
+    EXPECT_EQ(cached_next(7), 0) << "Mutable lambda was called on a hit.";
+  }
+
+  TEST(lru_cache, member_functions_are_keyed_on_the_object) {
+    accumulator one{1};
+    accumulator ten{10};
+    auto cached_add = hh::functools::make_lrucache(&accumulator::add);
+    using key_type = std::tuple<const accumulator*, int>;
+    static_assert(std::is_same_v<decltype(cached_add)::cache_key, key_type>,
+                  "The object pointer was not the first key element.");
+    EXPECT_EQ(cached_add(&one, 2), 3) << "Member function was not called on the object.";
+    EXPECT_EQ(cached_add(&ten, 2), 12) << "Calls on different objects shared a key.";
+    EXPECT_EQ(cached_add.size(), 2u) << "Calls on different objects shared a key.";
+  }
+
+  TEST(lru_cache, std_function_opts_in_to_type_erasure) {
+    auto cached_add = hh::functools::make_lrucache(std::function<int(int, int)>{add});
+    static_assert(std::is_same_v<decltype(cached_add), lru_cache<int, int, int>>,
+                  "A std::function did not make the type-erased cache.");
+    EXPECT_EQ(cached_add(2, 3), 5) << "Type-erased cache returned the wrong value.";
+  }
+
+  TEST(lru_cache, class_template_argument_deduction_deduces_the_function_type) {
+    basic_lru_cache cached_add{[](int a, int b) { return a + b; }, 4};
+    static_assert(std::is_same_v<decltype(cached_add)::return_type, int>,
+                  "The return type was not deduced from the lambda.");
+    EXPECT_EQ(cached_add(2, 3), 5) << "Deduced cache returned the wrong value.";
+    EXPECT_EQ(cached_add.max_size(), 4u) << "Deduced cache was not given its size.";
+  }
+
+  TEST(shared_lru_cache, hits_share_the_cached_value) {
+    int calls = 0;
+    auto cached = make_shared_lrucache([&calls](int size) {
+      ++calls;
+      return std::vector<int>(size, 7);
+    });
+    static_assert(std::is_same_v<decltype(cached(1)), value_handle<std::vector<int>>>,
+                  "The shared cache did not return a value handle.");
+    const auto first = cached(1000);
+    const auto second = cached(1000);
+    EXPECT_EQ(first.get(), second.get()) << "A hit copied the value instead of sharing it.";
+    EXPECT_EQ(first->size(), 1000u) << "The handle held the wrong value.";
+    EXPECT_EQ(calls, 1) << "A hit called the underlying function.";
+  }
+
+  TEST(shared_lru_cache, handles_outlive_the_eviction_of_their_entry) {
+    auto cached = make_shared_lrucache([](int value) { return std::string(value, 'x'); }, 1);
+    const auto held = cached(100);
+    cached(200);
+    EXPECT_EQ(cached.size(), 1u) << "The held entry was not evicted.";
+    EXPECT_EQ(held.use_count(), 1) << "The evicted entry still shared the value.";
+    EXPECT_EQ(*held, std::string(100, 'x')) << "The handle did not keep the evicted value alive.";
+  }
+
+  TEST(shared_lru_cache, signature_alias_type_erases_the_function) {
+    shared_lru_cache<std::string, int> cached{[](int value) { return std::to_string(value); }, 4};
+    EXPECT_EQ(*cached(42), "42") << "The type-erased shared cache returned the wrong value.";
+  }
+
+  TEST(shared_lru_cache, eviction_policies_can_be_chosen) {
+    auto cached = make_shared_lrucache<segmented_lru_eviction<>>(
+        [](int value) { return std::vector<int>(value); }, 2);
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(cached(i)->size(), static_cast<std::size_t>(i))
+          << "The segmented shared cache returned the wrong value.";
+    }
+    EXPECT_EQ(cached.size(), 2u) << "The segmented shared cache exceeded its size.";
+  }
 }  // namespace hh::functools
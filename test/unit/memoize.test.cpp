@@ -0,0 +1,88 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <hh/memoize.hpp>
+#include <string>
+
+namespace hh::functools {
+
+  namespace {
+    /** Fibonacci through the memo, counting how often a value is computed. */
+    struct fibonacci {
+      int* d_calls;
+
+      template <typename SELF> std::uint64_t operator()(SELF& self, int n) const {
+        ++*d_calls;
+        return n < 2 ? n : self(n - 1) + self(n - 2);
+      }
+    };
+
+    std::size_t edit_distance(const std::string& from, const std::string& to) {
+      auto distance = memoize_recursive_unbounded<std::size_t(std::size_t, std::size_t)>(
+          [&from, &to](auto& self, std::size_t i, std::size_t j) -> std::size_t {
+            if (i == 0 || j == 0) {
+              return i + j;
+            }
+            const std::size_t substitute = self(i - 1, j - 1) + (from[i - 1] != to[j - 1]);
+            return std::min({substitute, self(i - 1, j) + 1, self(i, j - 1) + 1});
+          },
+          (from.size() + 1) * (to.size() + 1));
+      return distance(from.size(), to.size());
+    }
+  }  // namespace
+
+  TEST(memoize_recursive, self_calls_go_through_the_cache) {
+    int calls = 0;
+    auto memoized = memoize_recursive<std::uint64_t(int)>(fibonacci{&calls});
+    EXPECT_EQ(memoized(90), 2880067194370816120ull) << "Memoized recursion gave the wrong value.";
+    EXPECT_EQ(calls, 91) << "A subproblem was computed more than once.";
+    EXPECT_EQ(memoized(90), 2880067194370816120ull) << "Memoized value was not reused.";
+    EXPECT_EQ(calls, 91) << "A memoized value was recomputed.";
+  }
+
+  TEST(memoize_recursive, small_caches_still_share_recent_subproblems) {
+    int calls = 0;
+    auto memoized = memoize_recursive<std::uint64_t(int)>(fibonacci{&calls}, 3);
+    EXPECT_EQ(memoized(60), 1548008755920ull) << "Bounded recursion gave the wrong value.";
+    EXPECT_EQ(calls, 61) << "The most recent subproblems were evicted.";
+    EXPECT_LE(memoized.size(), 3u) << "Cache grew beyond its maximum size.";
+  }
+
+  TEST(memoize_recursive, returned_values_survive_nested_evictions) {
+    // Every level evicts the entries of the levels below it from a one-entry cache.
+    auto memoized = memoize_recursive<std::string(int)>(
+        [](auto& self, int depth) -> std::string {
+          if (depth == 0) {
+            return "x";
+          }
+          const std::string left = self(depth - 1);
+          const std::string right = self(depth - 1);
+          return left + std::to_string(depth) + right;
+        },
+        1);
+    EXPECT_EQ(memoized(3), "x1x2x1x3x1x2x1x") << "A value was invalidated by a nested eviction.";
+  }
+
+  TEST(memoize_recursive_unbounded, every_subproblem_is_computed_once) {
+    int calls = 0;
+    auto memoized = memoize_recursive_unbounded<std::uint64_t(int)>(fibonacci{&calls}, 91);
+    EXPECT_EQ(memoized(90), 2880067194370816120ull) << "Memoized recursion gave the wrong value.";
+    EXPECT_EQ(calls, 91) << "A subproblem was computed more than once.";
+    EXPECT_EQ(memoized.size(), 91u) << "Not every subproblem was memoized.";
+  }
+
+  TEST(memoize_recursive_unbounded, multi_argument_kernels_are_memoized) {
+    EXPECT_EQ(edit_distance("kitten", "sitting"), 3u) << "Edit distance was wrong.";
+    EXPECT_EQ(edit_distance("", "abc"), 3u) << "Edit distance from empty was wrong.";
+    EXPECT_EQ(edit_distance("intention", "execution"), 5u) << "Edit distance was wrong.";
+  }
+
+  TEST(memoize_recursive_unbounded, growing_past_the_expected_keys_is_correct) {
+    int calls = 0;
+    auto memoized = memoize_recursive_unbounded<std::uint64_t(int)>(fibonacci{&calls}, 4);
+    EXPECT_EQ(memoized(90), 2880067194370816120ull) << "Table gave wrong values after growing.";
+    EXPECT_EQ(calls, 91) << "A subproblem was computed more than once.";
+  }
+}  // namespace hh::functools
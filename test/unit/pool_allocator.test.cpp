@@ -0,0 +1,193 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <hh/call_counter.hpp>
+#include <hh/lru_cache.hpp>
+#include <hh/pool_allocator.hpp>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <tuple>
+
+namespace hh::functools {
+
+  namespace {
+    int square(int value) { return value * value; }
+
+    std::string repeat(const std::string& text, int times) {
+      std::string repeated;
+      for (int i = 0; i < times; ++i) {
+        repeated += text;
+      }
+      return repeated;
+    }
+
+    struct length_weigher {
+      std::size_t operator()(const std::tuple<std::string, int>&, const std::string& value) const {
+        return value.size();
+      }
+    };
+
+    /** Counts the allocations a memory resource serves, forwarding them upstream. */
+    class counting_resource : public std::pmr::memory_resource {
+      std::pmr::memory_resource* d_upstream = std::pmr::new_delete_resource();
+
+    public:
+      std::size_t d_allocations = 0;
+
+    private:
+      void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++d_allocations;
+        return d_upstream->allocate(bytes, alignment);
+      }
+      void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+        d_upstream->deallocate(pointer, bytes, alignment);
+      }
+      bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+      }
+    };
+  }  // namespace
+
+  TEST(pool_allocator, reuses_freed_nodes) {
+    pool_allocator<std::pair<int, int>> allocator;
+    auto* first = allocator.allocate(1);
+    allocator.deallocate(first, 1);
+    auto* second = allocator.allocate(1);
+    EXPECT_EQ(first, second) << "A freed node was not handed out again.";
+    allocator.deallocate(second, 1);
+  }
+
+  TEST(pool_allocator, rebound_copies_compare_equal) {
+    pool_allocator<int> ints;
+    pool_allocator<std::string> strings{ints};
+    EXPECT_TRUE(ints == strings) << "Pool allocators of different types should be equal.";
+    EXPECT_FALSE(ints != strings) << "Pool allocators of different types should be equal.";
+  }
+
+  TEST(pool_allocator, serves_arrays_from_the_heap) {
+    pool_allocator<int> allocator;
+    int* values = allocator.allocate(1000);
+    for (int i = 0; i < 1000; ++i) {
+      values[i] = i;
+    }
+    EXPECT_EQ(values[999], 999) << "An array allocation was not usable.";
+    allocator.deallocate(values, 1000);
+  }
+
+  TEST(pool_allocator, nodes_freed_on_an_exiting_thread_pass_to_the_next) {
+    pool_allocator<long> allocator;
+    long* node = allocator.allocate(1);
+    std::thread([&allocator, node] { allocator.deallocate(node, 1); }).join();
+    long* adopted = nullptr;
+    std::thread([&allocator, &adopted] {
+      adopted = allocator.allocate(1);
+      *adopted = 42;
+      allocator.deallocate(adopted, 1);
+    }).join();
+    EXPECT_EQ(adopted, node) << "A thread did not adopt the nodes an exited thread freed.";
+  }
+
+  TEST(pool_allocator, nodes_freed_after_the_thread_pool_is_destroyed_go_to_the_depot) {
+    // A size class no other test uses, so the depot holds nothing else of it.
+    using large_node = std::array<char, 480>;
+    static pool_allocator<large_node> allocator;
+    static large_node* freed = nullptr;
+    /** Frees its node on thread exit, after the pool constructed later than it is destroyed. */
+    struct late_free {
+      large_node* d_node = nullptr;
+      ~late_free() {
+        allocator.deallocate(d_node, 1);
+        freed = d_node;
+      }
+    };
+    std::thread([] {
+      thread_local late_free holder;
+      holder.d_node = allocator.allocate(1);
+    }).join();
+    ASSERT_NE(freed, nullptr) << "The node was not freed on thread exit.";
+    large_node* adopted = nullptr;
+    std::thread([&adopted] {
+      adopted = allocator.allocate(1);
+      allocator.deallocate(adopted, 1);
+    }).join();
+    EXPECT_EQ(adopted, freed) << "A node freed after its thread's pool was destroyed was lost.";
+  }
+
+  TEST(pool_allocator, lru_cache_evicts_correctly) {
+    auto cache = make_lrucache(square, 3, pool_allocator<std::byte>{});
+    for (int round = 0; round < 3; ++round) {
+      for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(cache(i), i * i) << "The pooled cache returned the wrong value.";
+      }
+    }
+    EXPECT_EQ(cache.size(), 3) << "The pooled cache kept the wrong number of entries.";
+  }
+
+  TEST(pool_allocator, every_policy_accepts_an_allocator) {
+    basic_lru_cache<int(int), segmented_lru_eviction<>, unit_weigher, no_metrics, wy_hasher,
+                    int (*)(int), pool_allocator<std::byte>>
+        segmented{square, 4};
+    basic_lru_cache<int(int), arc_eviction, unit_weigher, no_metrics, wy_hasher, int (*)(int),
+                    pool_allocator<std::byte>>
+        arc{square, 4};
+    basic_lru_cache<int(int), wtinylfu_eviction<>, unit_weigher, no_metrics, wy_hasher,
+                    int (*)(int), pool_allocator<std::byte>>
+        wtinylfu{square, 4};
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(segmented(i % 7), (i % 7) * (i % 7)) << "Segmented LRU returned a wrong value.";
+      EXPECT_EQ(arc(i % 7), (i % 7) * (i % 7)) << "ARC returned a wrong value.";
+      EXPECT_EQ(wtinylfu(i % 7), (i % 7) * (i % 7)) << "W-TinyLFU returned a wrong value.";
+    }
+    EXPECT_LE(segmented.size(), 4) << "Segmented LRU exceeded its capacity.";
+    EXPECT_LE(arc.size(), 4) << "ARC exceeded its capacity.";
+    EXPECT_LE(wtinylfu.size(), 4) << "W-TinyLFU exceeded its capacity.";
+  }
+
+  TEST(pool_allocator, lru_cache_allocates_from_a_memory_resource) {
+    counting_resource upstream;
+    std::pmr::unsynchronized_pool_resource pool{&upstream};
+    auto cache = make_lrucache(repeat, 2, std::pmr::polymorphic_allocator<std::byte>{&pool});
+    EXPECT_EQ(cache("ab", 2), "abab") << "The cache returned the wrong value.";
+    EXPECT_EQ(cache("c", 3), "ccc") << "The cache returned the wrong value.";
+    EXPECT_EQ(cache("ab", 2), "abab") << "The cache returned the wrong value.";
+    EXPECT_GT(upstream.d_allocations, 0) << "The cache did not allocate from the resource.";
+  }
+
+  TEST(pool_allocator, weighted_cache_accepts_an_allocator) {
+    basic_lru_cache<std::string(const std::string&, int), lru_eviction, length_weigher,
+                    no_metrics, wy_hasher, std::string (*)(const std::string&, int),
+                    pool_allocator<std::byte>>
+        cache{repeat, 0, 64, length_weigher{}, pool_allocator<std::byte>{}};
+    for (int i = 0; i < 50; ++i) {
+      EXPECT_EQ(cache("x", i), std::string(i, 'x')) << "The weighted cache returned a wrong value.";
+    }
+    EXPECT_LE(cache.weight(), 64) << "The weighted cache exceeded its budget.";
+  }
+
+  TEST(pool_allocator, call_counter_counts_with_an_allocator) {
+    counting_resource upstream;
+    std::pmr::unsynchronized_pool_resource pool{&upstream};
+    using allocator = std::pmr::polymorphic_allocator<std::byte>;
+    basic_call_counter<int(int), wy_hasher, int (*)(int), allocator> counter{square, 1,
+                                                                             allocator{&pool}};
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(counter(i % 10), (i % 10) * (i % 10)) << "The counter changed the result.";
+    }
+    EXPECT_EQ(counter.call_count(3), 10) << "The counter miscounted.";
+    EXPECT_EQ(counter.unique_entries(), 10) << "The counter saw the wrong number of keys.";
+    EXPECT_GT(upstream.d_allocations, 0) << "The counter did not allocate from the resource.";
+  }
+
+  TEST(pool_allocator, call_counter_counts_with_a_pool) {
+    basic_call_counter<int(int), wy_hasher, int (*)(int), pool_allocator<std::byte>> counter{
+        square, 4};
+    for (int i = 0; i < 1000; ++i) {
+      counter(i % 100);
+    }
+    EXPECT_EQ(counter.call_count(42), 10) << "The pooled counter miscounted.";
+    EXPECT_EQ(counter.total_calls(), 1000) << "The pooled counter lost calls.";
+  }
+}  // namespace hh::functools
@@ -0,0 +1,238 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <hh/rand.hpp>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace hh::rand {
+
+  namespace {
+    /** The share of draws landing on each key. */
+    template <typename DISTRIBUTION>
+    std::vector<double> frequencies(const DISTRIBUTION& distribution, std::size_t draws) {
+      xoshiro256ss generator{7};
+      std::vector<double> counts(distribution.max() + 1);
+      for (std::size_t i = 0; i < draws; ++i) {
+        counts.at(distribution(generator)) += 1.0;
+      }
+      for (auto& count : counts) {
+        count /= static_cast<double>(draws);
+      }
+      return counts;
+    }
+
+    double zipf_probability(std::size_t rank, std::size_t keys, double exponent) {
+      double total = 0.0;
+      for (std::size_t key = 1; key <= keys; ++key) {
+        total += std::pow(static_cast<double>(key), -exponent);
+      }
+      return std::pow(static_cast<double>(rank + 1), -exponent) / total;
+    }
+  }  // namespace
+
+  TEST(splitmix64, matches_the_reference_sequence) {
+    splitmix64 generator{0};
+    EXPECT_EQ(generator(), 0xe220a8397b1dcdafull) << "SplitMix64 diverged from the reference.";
+    EXPECT_EQ(generator(), 0x6e789e6aa1b965f4ull) << "SplitMix64 diverged from the reference.";
+    EXPECT_EQ(generator(), 0x06c45d188009454full) << "SplitMix64 diverged from the reference.";
+  }
+
+  TEST(xoshiro256ss, matches_the_reference_sequence) {
+    xoshiro256ss generator{xoshiro256ss::state_type{1, 2, 3, 4}};
+    EXPECT_EQ(generator(), 11520u) << "xoshiro256** diverged from the reference.";
+    EXPECT_EQ(generator(), 0u) << "xoshiro256** diverged from the reference.";
+    EXPECT_EQ(generator(), 0x5a007080u) << "xoshiro256** diverged from the reference.";
+  }
+
+  TEST(xoshiro256ss, jump_matches_the_reference_state) {
+    xoshiro256ss generator{xoshiro256ss::state_type{1, 2, 3, 4}};
+    generator.jump();
+    EXPECT_THAT(generator.state(),
+                ::testing::ElementsAre(0x8c7a153956b5f3d1ull, 0x701f1a713401d85eull,
+                                       0x6527f66a65469085ull, 0x8386b786c4408050ull))
+        << "jump() did not advance by the reference polynomial.";
+  }
+
+  TEST(xoshiro256ss, split_streams_do_not_overlap) {
+    xoshiro256ss parent{42};
+    const xoshiro256ss before{parent};
+    xoshiro256ss child = parent.split();
+    EXPECT_EQ(child, before) << "The child did not continue the parent's stream.";
+    std::set<std::uint64_t> drawn;
+    for (int i = 0; i < 1000; ++i) {
+      drawn.insert(child());
+    }
+    for (int i = 0; i < 1000; ++i) {
+      EXPECT_EQ(drawn.count(parent()), 0u) << "The parent drew a value of the child's stream.";
+    }
+  }
+
+  TEST(xoshiro256ss, discard_skips_values) {
+    xoshiro256ss skipped{3};
+    xoshiro256ss stepped{3};
+    skipped.discard(100);
+    for (int i = 0; i < 100; ++i) {
+      stepped();
+    }
+    EXPECT_EQ(skipped, stepped) << "discard() did not skip the given number of values.";
+  }
+
+  TEST(xoshiro256ss, drives_standard_distributions) {
+    xoshiro256ss generator{5};
+    std::uniform_int_distribution<int> die{1, 6};
+    for (int i = 0; i < 100; ++i) {
+      const int roll = die(generator);
+      EXPECT_TRUE(roll >= 1 && roll <= 6) << "A standard distribution left its range.";
+    }
+  }
+
+  TEST(xoshiro256ss_lanes, lanes_continue_jumped_streams) {
+    xoshiro256ss first{11};
+    xoshiro256ss second{first};
+    second.jump();
+    xoshiro256ss_lanes<2> lanes{11};
+    for (int i = 0; i < 10; ++i) {
+      EXPECT_EQ(lanes(), first()) << "The first lane did not follow the seed's stream.";
+      EXPECT_EQ(lanes(), second()) << "The second lane did not follow the jumped stream.";
+    }
+  }
+
+  TEST(xoshiro256ss_lanes, fill_matches_calling_the_generator) {
+    xoshiro256ss_lanes<4> filled{9};
+    xoshiro256ss_lanes<4> called{9};
+    filled();
+    called();
+    std::vector<std::uint64_t> values(37);
+    filled.fill(values.data(), values.data() + values.size());
+    for (const auto value : values) {
+      EXPECT_EQ(value, called()) << "fill() wrote a different sequence from the generator's.";
+    }
+    EXPECT_EQ(filled(), called()) << "fill() left the generator in a different state.";
+  }
+
+  TEST(pcg32, matches_the_reference_sequence) {
+    pcg32 generator{42, 54};
+    EXPECT_THAT((std::vector<std::uint32_t>{generator(), generator(), generator(), generator(),
+                                            generator(), generator()}),
+                ::testing::ElementsAre(0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u,
+                                       0xbfa4784bu, 0xcbed606eu))
+        << "PCG32 diverged from the reference.";
+  }
+
+  TEST(pcg32, advance_skips_values) {
+    pcg32 skipped{1, 2};
+    pcg32 stepped{1, 2};
+    skipped.advance(1000);
+    for (int i = 0; i < 1000; ++i) {
+      stepped();
+    }
+    EXPECT_EQ(skipped, stepped) << "advance() did not skip the given number of values.";
+  }
+
+  TEST(pcg32, split_streams_differ) {
+    pcg32 parent{42, 54};
+    pcg32 child = parent.split();
+    EXPECT_NE(child, parent) << "The child shares the parent's stream.";
+    int equal = 0;
+    for (int i = 0; i < 100; ++i) {
+      equal += child() == parent();
+    }
+    EXPECT_LT(equal, 3) << "The split streams draw the same values.";
+  }
+
+  TEST(uniform_below, stays_below_the_bound_and_is_uniform) {
+    pcg32 generator{};
+    std::vector<int> counts(10);
+    for (int i = 0; i < 100000; ++i) {
+      const auto value = uniform_below(generator, 10);
+      ASSERT_LT(value, 10u) << "uniform_below() reached its bound.";
+      ++counts[value];
+    }
+    for (const int count : counts) {
+      EXPECT_NEAR(count, 10000, 500) << "uniform_below() favoured some values.";
+    }
+  }
+
+  TEST(uniform_unit, stays_in_the_unit_interval) {
+    xoshiro256ss generator{};
+    double total = 0.0;
+    for (int i = 0; i < 10000; ++i) {
+      const double value = uniform_unit(generator);
+      ASSERT_TRUE(value >= 0.0 && value < 1.0) << "uniform_unit() left [0, 1).";
+      total += value;
+    }
+    EXPECT_NEAR(total / 10000, 0.5, 0.02) << "uniform_unit() is not centred.";
+  }
+
+  TEST(zipf_distribution, matches_the_zipf_probabilities) {
+    for (const double exponent : {0.5, 0.99, 1.0, 1.2}) {
+      const zipf_distribution zipf{100, exponent};
+      const auto observed = frequencies(zipf, 400000);
+      for (const std::size_t rank : {0, 1, 9, 99}) {
+        const double expected = zipf_probability(rank, 100, exponent);
+        EXPECT_NEAR(observed[rank], expected, 0.1 * expected + 0.001)
+            << "Rank " << rank << " was drawn at the wrong rate for exponent " << exponent << ".";
+      }
+    }
+  }
+
+  TEST(zipf_distribution, handles_huge_key_spaces) {
+    const zipf_distribution zipf{std::uint64_t{1} << 40, 0.9};
+    xoshiro256ss generator{};
+    for (int i = 0; i < 1000; ++i) {
+      ASSERT_LE(zipf(generator), zipf.max()) << "A key outside the key space was drawn.";
+    }
+    EXPECT_EQ(zipf_distribution(1, 1.0)(generator), 0u) << "A single key was not always drawn.";
+  }
+
+  TEST(permutation, is_a_bijection) {
+    for (const std::uint64_t size : {1, 2, 3, 100, 1000, 1024, 1025}) {
+      const permutation permute{size, 17};
+      std::vector<bool> seen(size);
+      for (std::uint64_t value = 0; value < size; ++value) {
+        const auto image = permute(value);
+        ASSERT_LT(image, size) << "A value was mapped outside the range.";
+        EXPECT_FALSE(seen[image]) << "Two values were mapped to " << image << ".";
+        seen[image] = true;
+      }
+    }
+  }
+
+  TEST(scrambled_zipf_distribution, scatters_the_popular_keys) {
+    const scrambled_zipf_distribution scrambled{1000, 0.99, 3};
+    const auto observed = frequencies(scrambled, 200000);
+    const auto hottest = std::max_element(observed.begin(), observed.end()) - observed.begin();
+    EXPECT_EQ(static_cast<std::uint64_t>(hottest), scrambled.key_of_rank(0))
+        << "The most popular rank did not land on its scrambled key.";
+    EXPECT_NEAR(observed[hottest], zipf_probability(0, 1000, 0.99), 0.01)
+        << "Scrambling changed the popularity of the hottest key.";
+    EXPECT_NE(scrambled.key_of_rank(0) + 1, scrambled.key_of_rank(1))
+        << "Neighbouring ranks stayed neighbouring keys.";
+  }
+
+  TEST(hotset_distribution, hot_keys_receive_their_share) {
+    const hotset_distribution hotset{1000, 0.2, 0.8};
+    EXPECT_EQ(hotset.hot_keys(), 200u) << "The hot set has the wrong size.";
+    const auto observed = frequencies(hotset, 200000);
+    double hot = 0.0;
+    for (std::size_t key = 0; key < hotset.hot_keys(); ++key) {
+      hot += observed[key];
+    }
+    EXPECT_NEAR(hot, 0.8, 0.01) << "The hot set received the wrong share of draws.";
+    EXPECT_NEAR(observed[0], 0.8 / 200, 0.002) << "Hot keys were not drawn uniformly.";
+    EXPECT_NEAR(observed[999], 0.2 / 800, 0.001) << "Cold keys were not drawn uniformly.";
+  }
+
+  TEST(distributions, fill_writes_a_sample_per_element) {
+    xoshiro256ss generator{};
+    std::vector<std::uint64_t> keys(1000, ~std::uint64_t{0});
+    zipf_distribution{50, 1.0}.fill(generator, keys.begin(), keys.end());
+    EXPECT_TRUE(std::all_of(keys.begin(), keys.end(), [](auto key) { return key < 50; }))
+        << "fill() left elements unwritten or outside the key space.";
+  }
+}  // namespace hh::rand
@@ -0,0 +1,175 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <hh/helpers.hpp>
+#include <hh/refreshing_cache.hpp>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    using namespace std::chrono_literals;
+    using manual_refreshing_cache = basic_refreshing_cache<int(int), hh::helpers::manual_clock>;
+
+    /** Returns the key plus the number of calls made so far, so every refresh changes the value. */
+    std::function<int(int)> versioned(std::atomic<int>& calls) {
+      return [&calls](int value) { return value + 100 * ++calls; };
+    }
+
+    /** Queues tasks until the test runs them. */
+    struct deferred_executor {
+      std::shared_ptr<std::vector<std::function<void()>>> d_tasks
+          = std::make_shared<std::vector<std::function<void()>>>();
+
+      template <typename TASK> void execute(TASK&& task) const {
+        d_tasks->emplace_back(std::forward<TASK>(task));
+      }
+
+      void run_all() const {
+        auto tasks = std::move(*d_tasks);
+        d_tasks->clear();
+        for (auto& task : tasks) {
+          task();
+        }
+      }
+    };
+
+    /** Refuses every task, as a shut down or exhausted executor would. */
+    struct refusing_executor {
+      template <typename TASK> void execute(TASK&&) const {
+        throw std::runtime_error("executor refused the task");
+      }
+    };
+  }  // namespace
+
+  TEST(refreshing_cache, fresh_hits_do_not_refresh) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    manual_refreshing_cache cache{versioned(calls), 16, 10ms, 100ms, 1, clock};
+    EXPECT_EQ(cache(1), 101) << "Miss did not call the underlying function.";
+    clock.advance(9ms);
+    EXPECT_EQ(cache(1), 101) << "Fresh hit did not return the cached value.";
+    EXPECT_EQ(cache.refreshing(), 0u) << "Fresh hit scheduled a refresh.";
+    EXPECT_EQ(calls.load(), 1) << "Fresh hit called the underlying function.";
+  }
+
+  TEST(refreshing_cache, stale_hits_return_the_cached_value_and_refresh_it) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    manual_refreshing_cache cache{hh::helpers::make_delayed<20>(versioned(calls)), 16, 10ms,
+                                  100ms, 1, clock};
+    EXPECT_EQ(cache(1), 101) << "Miss did not call the underlying function.";
+    clock.advance(10ms);
+    const auto started = std::chrono::steady_clock::now();
+    EXPECT_EQ(cache(1), 101) << "Stale hit did not return the cached value.";
+    EXPECT_LT(std::chrono::steady_clock::now() - started, 20ms)
+        << "Stale hit waited for the underlying function.";
+    cache.wait_for_refreshes();
+    EXPECT_EQ(cache(1), 201) << "Refresh did not replace the stale value.";
+    EXPECT_EQ(calls.load(), 2) << "Refreshed value was refreshed again while fresh.";
+  }
+
+  TEST(refreshing_cache, refreshes_of_one_key_are_deduplicated) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    manual_refreshing_cache cache{hh::helpers::make_delayed<20>(versioned(calls)), 16, 10ms, 0ms,
+                                  4, clock};
+    cache(1);
+    clock.advance(10ms);
+    for (int i = 0; i < 8; ++i) {
+      EXPECT_EQ(cache(1), 101) << "Stale hit did not return the cached value.";
+    }
+    EXPECT_EQ(cache.refreshing(), 1u) << "Stale hits on one key scheduled several refreshes.";
+    cache.wait_for_refreshes();
+    EXPECT_EQ(calls.load(), 2) << "Stale hits on one key refreshed it more than once.";
+  }
+
+  TEST(refreshing_cache, concurrent_refreshes_are_limited) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    manual_refreshing_cache cache{hh::helpers::make_delayed<20>(versioned(calls)), 16, 10ms, 0ms,
+                                  2, clock};
+    for (int key = 0; key < 4; ++key) {
+      cache(key);
+    }
+    clock.advance(10ms);
+    for (int key = 0; key < 4; ++key) {
+      cache(key);
+    }
+    EXPECT_EQ(cache.refreshing(), 2u) << "More refreshes ran than the limit allows.";
+    cache.wait_for_refreshes();
+    EXPECT_EQ(calls.load(), 6) << "Stale hits beyond the limit scheduled refreshes.";
+    EXPECT_EQ(cache(2), 302) << "Stale hit did not return the cached value.";
+    EXPECT_EQ(cache.refreshing(), 1u) << "Skipped key was not refreshed on its next stale hit.";
+  }
+
+  TEST(refreshing_cache, hard_expired_values_are_recomputed_by_the_caller) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    manual_refreshing_cache cache{versioned(calls), 16, 10ms, 100ms, 1, clock};
+    cache(1);
+    clock.advance(100ms);
+    EXPECT_EQ(cache(1), 201) << "Hard-expired value was returned.";
+    EXPECT_EQ(cache.refreshing(), 0u) << "Hard-expired value was refreshed in the background.";
+  }
+
+  TEST(refreshing_cache, failed_refreshes_keep_the_stale_value) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    basic_refreshing_cache<int(int), hh::helpers::manual_clock, inline_executor> cache{
+        [&calls](int value) {
+          if (++calls == 2) {
+            throw std::runtime_error("refresh fails");
+          }
+          return value + 100 * calls;
+        },
+        16, 10ms, 0ms, 1, clock, inline_executor{}};
+    cache(1);
+    clock.advance(10ms);
+    EXPECT_EQ(cache(1), 101) << "Stale hit did not return the cached value.";
+    EXPECT_EQ(cache(1), 101) << "Failed refresh dropped the stale value.";
+    EXPECT_EQ(cache(1), 301) << "Stale hit after a failed refresh did not retry it.";
+  }
+
+  TEST(refreshing_cache, refreshes_finishing_after_a_recompute_are_discarded) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    deferred_executor executor;
+    basic_refreshing_cache<int(int), hh::helpers::manual_clock, deferred_executor> cache{
+        versioned(calls), 16, 10ms, 20ms, 4, clock, executor};
+    cache(1);
+    clock.advance(10ms);
+    EXPECT_EQ(cache(1), 101) << "Stale hit did not return the cached value.";
+    ASSERT_EQ(executor.d_tasks->size(), 1u) << "Stale hit did not schedule a refresh.";
+    clock.advance(10ms);
+    EXPECT_EQ(cache(1), 201) << "Hard-expired value was not recomputed by the caller.";
+    executor.run_all();
+    EXPECT_EQ(cache(1), 201) << "A refresh of the expired entry replaced the recomputed value.";
+    EXPECT_EQ(cache.refreshing(), 0u) << "The discarded refresh was still counted.";
+    clock.advance(10ms);
+    cache(1);
+    cache(1);
+    EXPECT_EQ(executor.d_tasks->size(), 1u)
+        << "The recomputed entry was not refreshed exactly once when it went stale.";
+    executor.run_all();
+    EXPECT_EQ(cache(1), 401) << "The refresh of the recomputed entry was not stored.";
+  }
+
+  TEST(refreshing_cache, refreshes_the_executor_refuses_are_rolled_back) {
+    hh::helpers::manual_clock clock;
+    std::atomic<int> calls{0};
+    basic_refreshing_cache<int(int), hh::helpers::manual_clock, refusing_executor> cache{
+        versioned(calls), 16, 10ms, 0ms, 1, clock, refusing_executor{}};
+    cache(1);
+    clock.advance(10ms);
+    EXPECT_THROW(cache(1), std::runtime_error) << "The executor's refusal was swallowed.";
+    EXPECT_EQ(cache.refreshing(), 0u) << "A refused refresh was still counted.";
+    cache.wait_for_refreshes();
+    EXPECT_THROW(cache(1), std::runtime_error) << "A refused refresh was not retried.";
+  }
+}  // namespace hh::functools
@@ -0,0 +1,186 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <hh/sharded_lru_cache.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+
+    /** Holds every caller of the gated function until released. */
+    struct gate {
+      std::mutex d_mutex;
+      std::condition_variable d_condition;
+      bool d_open = false;
+      std::atomic<int> d_entered{0};
+
+      void pass() {
+        ++d_entered;
+        std::unique_lock<std::mutex> lock{d_mutex};
+        d_condition.wait(lock, [this] { return d_open; });
+      }
+
+      void open() {
+        {
+          std::lock_guard<std::mutex> lock{d_mutex};
+          d_open = true;
+        }
+        d_condition.notify_all();
+      }
+    };
+
+    template <typename CACHE> std::vector<std::thread> start_callers(CACHE& cache, int count,
+                                                                     std::atomic<int>& failures) {
+      std::vector<std::thread> callers;
+      for (int i = 0; i < count; ++i) {
+        callers.emplace_back([&cache, &failures]() {
+          try {
+            cache(1, 2);
+          } catch (const std::runtime_error&) {
+            ++failures;
+          }
+        });
+      }
+      return callers;
+    }
+  }  // namespace
+
+  TEST(sharded_lru_cache, shard_count_is_rounded_up_to_a_power_of_two) {
+    auto cached_add = hh::functools::make_sharded_lrucache(add, 128, 5);
+    EXPECT_EQ(cached_add.shard_count(), 8u) << "Shard count was not rounded to a power of two.";
+  }
+
+  TEST(sharded_lru_cache, invocation_of_cached_method_is_equivialant_to_non_cached_variant) {
+    auto cached_add = hh::functools::make_sharded_lrucache(add);
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation and non cached evaluation differ.";
+    EXPECT_EQ(cached_add(1, 1), 1 + 1) << "Cached evaluation differs on reuse.";
+  }
+
+  TEST(sharded_lru_cache, size_increases_as_unique_parameterised_calls_are_made) {
+    auto cached_add = hh::functools::make_sharded_lrucache(add);
+    cached_add(1, 1);
+    cached_add(1, 2);
+    cached_add(1, 2);
+    EXPECT_EQ(cached_add.size(), 2) << "Repeated calls should not grow the cache.";
+  }
+
+  TEST(sharded_lru_cache, size_is_bounded_by_the_maximum_size) {
+    auto cached_add = hh::functools::make_sharded_lrucache(add, 16, 1);
+    for (int i = 0; i < 64; ++i) {
+      cached_add(i, i);
+    }
+    EXPECT_EQ(cached_add.size(), 16) << "The cache grew beyond its maximum size.";
+  }
+
+  TEST(sharded_lru_cache, sizes_not_divisible_by_the_shard_count_are_never_exceeded) {
+    for (const unsigned int max_size : {3u, 10u, 17u}) {
+      auto cached_add = hh::functools::make_sharded_lrucache(add, max_size, 8);
+      for (int i = 0; i < 1024; ++i) {
+        cached_add(i, i);
+      }
+      EXPECT_LE(cached_add.size(), max_size) << "The shards held more than the maximum size.";
+      EXPECT_GE(cached_add.size(), max_size * 3 / 4)
+          << "The shards held far fewer entries than the maximum size.";
+    }
+  }
+
+  TEST(sharded_lru_cache, least_recently_used_entry_is_evicted_within_a_shard) {
+    std::atomic<int> calls{0};
+    std::function<int(int, int)> counted_add = [&calls](int a, int b) {
+      ++calls;
+      return a + b;
+    };
+    auto cached_add = hh::functools::make_sharded_lrucache(counted_add, 2, 1);
+    cached_add(1, 1);
+    cached_add(2, 2);
+    cached_add(1, 1);
+    cached_add(3, 3);
+    cached_add(1, 1);
+    EXPECT_EQ(calls, 3) << "Recently used entry was evicted.";
+    cached_add(2, 2);
+    EXPECT_EQ(calls, 4) << "Least recently used entry was not evicted.";
+  }
+
+  TEST(sharded_lru_cache, concurrent_callers_observe_correct_results) {
+    constexpr static auto THREADS = 8;
+    constexpr static auto ITERATIONS = 2048;
+    auto cached_add = hh::functools::make_sharded_lrucache(add, 256, 4);
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+      workers.emplace_back([&cached_add, &mismatches, t]() {
+        for (int i = 0; i < ITERATIONS; ++i) {
+          const int a = (i * 7 + t) % 512;
+          if (cached_add(a, i % 3) != a + i % 3) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    EXPECT_EQ(mismatches, 0) << "Concurrent callers observed incorrect cached values.";
+    EXPECT_LE(cached_add.size(), 256) << "The cache grew beyond its maximum size.";
+  }
+
+  TEST(sharded_lru_cache, coalesced_misses_call_the_underlying_function_once) {
+    constexpr static auto CALLERS = 8;
+    gate blocker;
+    std::atomic<int> calls{0};
+    std::function<int(int, int)> gated_add = [&](int a, int b) {
+      ++calls;
+      blocker.pass();
+      return a + b;
+    };
+    auto cached_add = hh::functools::make_sharded_lrucache(gated_add, 16, 4,
+                                                           hh::functools::miss_strategy::coalesce);
+    std::atomic<int> failures{0};
+    auto callers = start_callers(cached_add, CALLERS, failures);
+    while (blocker.d_entered == 0) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    blocker.open();
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    EXPECT_EQ(calls, 1) << "Concurrent misses on one key were not coalesced.";
+    EXPECT_EQ(cached_add(1, 2), 3) << "The coalesced result was not cached.";
+  }
+
+  TEST(sharded_lru_cache, coalesced_errors_propagate_to_every_waiter_and_are_not_cached) {
+    constexpr static auto CALLERS = 8;
+    gate blocker;
+    std::atomic<int> calls{0};
+    std::function<int(int, int)> failing_add = [&](int a, int b) -> int {
+      if (++calls == 1) {
+        blocker.pass();
+        throw std::runtime_error("backend unavailable");
+      }
+      return a + b;
+    };
+    auto cached_add = hh::functools::make_sharded_lrucache(failing_add, 16, 4,
+                                                           hh::functools::miss_strategy::coalesce);
+    std::atomic<int> failures{0};
+    auto callers = start_callers(cached_add, CALLERS, failures);
+    while (blocker.d_entered == 0) {
+      std::this_thread::yield();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    blocker.open();
+    for (auto& caller : callers) {
+      caller.join();
+    }
+    EXPECT_GE(failures, 1) << "The error was not propagated to the computing caller.";
+    EXPECT_EQ(cached_add(1, 2), 3) << "A failed result was cached.";
+  }
+}  // namespace hh::functools
@@ -0,0 +1,205 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <hh/lru_cache.hpp>
+#include <hh/snapshot.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    struct point {
+      std::string d_label;
+      int d_x;
+
+      bool operator==(const point& other) const {
+        return d_label == other.d_label && d_x == other.d_x;
+      }
+    };
+
+    int square(int value) { return value * value; }
+
+    float halve(int value) { return static_cast<float>(value) / 2; }
+
+    unsigned int twice(unsigned int value) { return 2 * value; }
+
+    std::vector<std::string> split(const std::string& value, char separator) {
+      std::vector<std::string> parts{""};
+      for (char character : value) {
+        if (character == separator) {
+          parts.emplace_back();
+        } else {
+          parts.back() += character;
+        }
+      }
+      return parts;
+    }
+
+    point labelled(const std::string& label, int x) { return point{label, x}; }
+
+    std::string snapshot_path(const std::string& name) {
+      return ::testing::TempDir() + "hh_snapshot_" + name + ".bin";
+    }
+
+    template <typename CACHE> std::vector<typename CACHE::cache_key> keys_in_order(
+        const CACHE& cache) {
+      std::vector<typename CACHE::cache_key> keys;
+      cache.d_cache.for_each([&keys](const auto& entry) { keys.push_back(entry.first); });
+      return keys;
+    }
+  }  // namespace
+
+  template <> struct serializer<point> {
+    static void save(std::ostream& out, const point& value) {
+      serializer<std::string>::save(out, value.d_label);
+      serializer<int>::save(out, value.d_x);
+    }
+
+    static point load(std::istream& in) {
+      std::string label = serializer<std::string>::load(in);
+      return point{std::move(label), serializer<int>::load(in)};
+    }
+  };
+
+  TEST(snapshot, bitwise_entries_round_trip_in_lru_order) {
+    const auto path = snapshot_path("bitwise");
+    auto saved = make_lrucache(square, 4);
+    for (int value : {1, 2, 3, 4, 2}) {
+      saved(value);
+    }
+    saved.save(path);
+    int calls = 0;
+    auto loaded = make_lrucache(std::function<int(int)>{[&calls](int value) {
+                                  ++calls;
+                                  return square(value);
+                                }},
+                                4);
+    loaded.load(path);
+    EXPECT_EQ(keys_in_order(loaded), keys_in_order(saved)) << "Snapshot did not keep LRU order.";
+    EXPECT_EQ(loaded(3), 9) << "Loaded value did not match the saved one.";
+    EXPECT_EQ(calls, 0) << "Loading a snapshot called the underlying function.";
+    loaded(5);
+    loaded(1);
+    EXPECT_EQ(calls, 2) << "The least recently used entry was not evicted first after loading.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, streamed_entries_round_trip) {
+    const auto path = snapshot_path("streamed");
+    auto saved = make_lrucache(split);
+    saved("a,b,c", ',');
+    saved("hello world", ' ');
+    saved.save(path);
+    auto loaded = make_lrucache(split);
+    loaded.load(path);
+    EXPECT_EQ(loaded.size(), 2u) << "Snapshot lost entries.";
+    EXPECT_EQ(keys_in_order(loaded), keys_in_order(saved)) << "Snapshot did not keep LRU order.";
+    EXPECT_THAT(loaded("a,b,c", ','), ::testing::ElementsAre("a", "b", "c"))
+        << "Loaded value did not match the saved one.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, shared_values_round_trip) {
+    const auto path = snapshot_path("shared");
+    auto saved = make_shared_lrucache(split);
+    saved("a,b", ',');
+    saved.save(path);
+    auto loaded = make_shared_lrucache(split);
+    loaded.load(path);
+    EXPECT_THAT(*loaded("a,b", ','), ::testing::ElementsAre("a", "b"))
+        << "Loaded shared value did not match the saved one.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, user_types_use_their_serializer) {
+    const auto path = snapshot_path("custom");
+    auto saved = make_lrucache(labelled);
+    saved("origin", 0);
+    saved("far", 1000);
+    saved.save(path);
+    auto loaded = make_lrucache(labelled);
+    loaded.load(path);
+    EXPECT_EQ(loaded("far", 1000), (point{"far", 1000})) << "Custom serializer was not used.";
+    EXPECT_EQ(loaded.size(), 2u) << "Snapshot lost entries.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, snapshots_larger_than_the_cache_keep_the_most_recent_entries) {
+    const auto path = snapshot_path("larger");
+    auto saved = make_lrucache(square, 8);
+    for (int value = 0; value < 8; ++value) {
+      saved(value);
+    }
+    saved.save(path);
+    auto loaded = make_lrucache(square, 3);
+    loaded.load(path);
+    EXPECT_THAT(keys_in_order(loaded), ::testing::ElementsAre(std::make_tuple(5),
+                                                              std::make_tuple(6),
+                                                              std::make_tuple(7)))
+        << "A snapshot larger than the cache did not keep its most recent entries.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, mismatched_and_missing_files_are_rejected) {
+    const auto path = snapshot_path("mismatched");
+    auto saved = make_lrucache(split);
+    saved("a b", ' ');
+    saved.save(path);
+    auto other = make_lrucache(square);
+    EXPECT_THROW(other.load(path), std::runtime_error)
+        << "A snapshot of different entry types was accepted.";
+    {
+      std::ofstream garbage{path, std::ios::binary | std::ios::trunc};
+      garbage << "not a snapshot at all, just some text";
+    }
+    EXPECT_THROW(other.load(path), std::runtime_error) << "A file without a header was accepted.";
+    std::remove(path.c_str());
+    EXPECT_THROW(other.load(path), std::system_error) << "A missing file was accepted.";
+  }
+
+  TEST(snapshot, corrupt_string_lengths_are_reported_as_truncation) {
+    const auto path = snapshot_path("corrupt_length");
+    auto saved = make_lrucache(split);
+    saved("a,b,c", ',');
+    saved.save(path);
+    {
+      // The length of the first key's string follows the header.
+      std::fstream corrupt{path, std::ios::binary | std::ios::in | std::ios::out};
+      corrupt.seekp(sizeof(detail::snapshot_header));
+      const std::uint64_t length = std::uint64_t{1} << 62;
+      corrupt.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    }
+    auto loaded = make_lrucache(split);
+    try {
+      loaded.load(path);
+      ADD_FAILURE() << "A snapshot with a corrupt string length was accepted.";
+    } catch (const std::runtime_error& error) {
+      EXPECT_THAT(error.what(), ::testing::HasSubstr("is truncated"))
+          << "The corrupt length was not reported as truncation.";
+    }
+    EXPECT_EQ(loaded.size(), 0u) << "Entries of a corrupt snapshot were loaded.";
+    std::remove(path.c_str());
+  }
+
+  TEST(snapshot, entry_types_of_the_same_size_are_told_apart) {
+    const auto path = snapshot_path("same_size");
+    auto saved = make_lrucache(square);
+    saved(3);
+    saved.save(path);
+    auto floats = make_lrucache(halve);
+    EXPECT_THROW(floats.load(path), std::runtime_error)
+        << "A snapshot of int values was loaded as floats.";
+    auto unsigned_keys = make_lrucache(twice);
+    EXPECT_THROW(unsigned_keys.load(path), std::runtime_error)
+        << "A snapshot of int keys was loaded as unsigned keys.";
+    auto same = make_lrucache(square);
+    EXPECT_NO_THROW(same.load(path)) << "A snapshot of the same entry types was rejected.";
+    EXPECT_EQ(same.size(), 1u) << "Snapshot lost entries.";
+    std::remove(path.c_str());
+  }
+}  // namespace hh::functools
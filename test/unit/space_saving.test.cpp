@@ -0,0 +1,58 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <hh/space_saving.hpp>
+#include <string>
+
+namespace hh::collection {
+
+  TEST(space_saving, counts_monitored_keys_exactly_while_under_capacity) {
+    space_saving<std::string> summary{4};
+    summary.increment("a");
+    summary.increment("a");
+    summary.increment("b", 5);
+    ASSERT_NE(summary.find("a"), nullptr) << "A counted key was not monitored.";
+    EXPECT_EQ(summary.find("a")->d_count, 2u) << "Monitored key was miscounted.";
+    EXPECT_EQ(summary.find("a")->d_error, 0u) << "Key counted from the start has an error.";
+    EXPECT_EQ(summary.find("b")->d_count, 5u) << "Weighted increment was miscounted.";
+    EXPECT_EQ(summary.find("c"), nullptr) << "An uncounted key is monitored.";
+  }
+
+  TEST(space_saving, new_keys_replace_the_smallest_count) {
+    space_saving<int> summary{2};
+    summary.increment(1, 10);
+    summary.increment(2, 3);
+    summary.increment(3);
+    EXPECT_EQ(summary.size(), 2u) << "Summary grew past its capacity.";
+    EXPECT_EQ(summary.find(2), nullptr) << "The smallest count was not replaced.";
+    ASSERT_NE(summary.find(3), nullptr) << "The new key was not monitored.";
+    EXPECT_EQ(summary.find(3)->d_count, 4u) << "The new key did not inherit the smallest count.";
+    EXPECT_EQ(summary.find(3)->d_error, 3u) << "The inherited count was not recorded as error.";
+  }
+
+  TEST(space_saving, top_returns_the_highest_counts_first) {
+    space_saving<int> summary{8};
+    for (int key = 1; key <= 6; ++key) {
+      summary.increment(key, static_cast<std::uint64_t>(key * 10));
+    }
+    const auto top = summary.top(3);
+    ASSERT_EQ(top.size(), 3u) << "Top did not return the requested number of entries.";
+    EXPECT_EQ(top[0].d_key, 6) << "Top entries were not ordered by count.";
+    EXPECT_EQ(top[1].d_key, 5) << "Top entries were not ordered by count.";
+    EXPECT_EQ(top[2].d_key, 4) << "Top entries were not ordered by count.";
+    EXPECT_EQ(summary.top(100).size(), 6u) << "Top returned more entries than are monitored.";
+  }
+
+  TEST(space_saving, frequent_keys_survive_a_stream_of_rare_ones) {
+    space_saving<int> summary{16};
+    for (int round = 0; round < 1000; ++round) {
+      summary.increment(-1);
+      summary.increment(round);
+      summary.increment(round + 100000);
+    }
+    ASSERT_NE(summary.find(-1), nullptr) << "A key in a third of the stream was dropped.";
+    const auto* frequent = summary.find(-1);
+    EXPECT_GE(frequent->d_count, 1000u) << "Monitored count undercounted.";
+    EXPECT_LE(frequent->d_count - frequent->d_error, 1000u) << "Guaranteed count overcounted.";
+  }
+}  // namespace hh::collection
@@ -0,0 +1,95 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <hh/timer_wheel.hpp>
+#include <vector>
+
+namespace hh::collection {
+
+  namespace {
+    struct timer : timer_hook {
+      int d_id = 0;
+    };
+
+    std::vector<int> advance_to(timer_wheel& wheel, std::uint64_t target) {
+      std::vector<int> fired;
+      wheel.advance(target, [&fired](timer_hook& hook) {
+        fired.push_back(static_cast<timer&>(hook).d_id);
+      });
+      return fired;
+    }
+  }  // namespace
+
+  TEST(timer_wheel, timers_fire_at_their_deadline) {
+    timer_wheel wheel;
+    timer first, second;
+    first.d_id = 1;
+    second.d_id = 2;
+    wheel.schedule(first, 5);
+    wheel.schedule(second, 10);
+    EXPECT_TRUE(advance_to(wheel, 4).empty()) << "A timer fired before its deadline.";
+    EXPECT_THAT(advance_to(wheel, 5), ::testing::ElementsAre(1)) << "Timer did not fire on time.";
+    EXPECT_FALSE(first.scheduled()) << "Fired timer was still marked as scheduled.";
+    EXPECT_THAT(advance_to(wheel, 20), ::testing::ElementsAre(2)) << "Later timer did not fire.";
+    EXPECT_EQ(wheel.size(), 0u) << "Wheel still counted fired timers.";
+  }
+
+  TEST(timer_wheel, cancelled_timers_never_fire) {
+    timer_wheel wheel;
+    timer cancelled;
+    wheel.schedule(cancelled, 3);
+    wheel.cancel(cancelled);
+    EXPECT_FALSE(cancelled.scheduled()) << "Cancelled timer was still marked as scheduled.";
+    EXPECT_TRUE(advance_to(wheel, 10).empty()) << "A cancelled timer fired.";
+  }
+
+  TEST(timer_wheel, overdue_timers_fire_on_the_next_advance) {
+    timer_wheel wheel{100};
+    timer overdue;
+    wheel.schedule(overdue, 50);
+    EXPECT_EQ(advance_to(wheel, 101).size(), 1u) << "Overdue timer did not fire.";
+  }
+
+  TEST(timer_wheel, distant_timers_cascade_down_to_fire_exactly) {
+    timer_wheel wheel;
+    std::vector<timer> timers(64);
+    std::vector<std::uint64_t> deadlines;
+    for (std::size_t i = 0; i < timers.size(); ++i) {
+      timers[i].d_id = static_cast<int>(i);
+      // Spread deadlines across several levels of the wheel.
+      deadlines.push_back((std::uint64_t{1} << (i % 40)) + i);
+      wheel.schedule(timers[i], deadlines.back());
+    }
+    std::uint64_t now = 0;
+    std::size_t fired = 0;
+    while (fired < timers.size()) {
+      std::uint64_t next = ~std::uint64_t{0};
+      for (std::size_t i = 0; i < timers.size(); ++i) {
+        if (timers[i].scheduled() && deadlines[i] < next) {
+          next = deadlines[i];
+        }
+      }
+      EXPECT_TRUE(advance_to(wheel, next - 1).empty()) << "A timer fired before " << next;
+      for (int id : advance_to(wheel, next)) {
+        EXPECT_EQ(deadlines[static_cast<std::size_t>(id)], next) << "Timer " << id << " fired late.";
+        ++fired;
+      }
+      now = next;
+    }
+    EXPECT_EQ(wheel.current(), now) << "Wheel did not track the current tick.";
+  }
+
+  TEST(timer_wheel, callbacks_may_reschedule_their_timer) {
+    timer_wheel wheel;
+    timer repeating;
+    int fired = 0;
+    wheel.schedule(repeating, 1);
+    wheel.advance(10, [&](timer_hook& hook) {
+      ++fired;
+      wheel.schedule(hook, wheel.current() + 3);
+    });
+    EXPECT_EQ(fired, 4) << "Rescheduled timer did not fire at every interval.";
+    EXPECT_TRUE(repeating.scheduled()) << "Timer was not left waiting for its next interval.";
+  }
+}  // namespace hh::collection
@@ -0,0 +1,108 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <hh/helpers.hpp>
+#include <hh/ttl_cache.hpp>
+
+namespace hh::functools {
+
+  namespace {
+    using namespace std::chrono_literals;
+    using manual_ttl_cache = basic_ttl_cache<int(int), hh::helpers::manual_clock>;
+
+    struct counted_square {
+      int* d_calls;
+      int operator()(int value) const {
+        ++*d_calls;
+        return value * value;
+      }
+    };
+
+    int square(int value) { return value * value; }
+  }  // namespace
+
+  TEST(ttl_cache, values_are_reused_until_they_expire) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 16, 100ms, clock};
+    EXPECT_EQ(cache(3), 9) << "Cached evaluation did not match the underlying function.";
+    clock.advance(99ms);
+    EXPECT_EQ(cache(3), 9) << "Cached evaluation did not match the underlying function.";
+    EXPECT_EQ(calls, 1) << "A value was recomputed before its time-to-live elapsed.";
+    clock.advance(1ms);
+    EXPECT_EQ(cache(3), 9) << "Recomputed value did not match the underlying function.";
+    EXPECT_EQ(calls, 2) << "An expired value was returned instead of being recomputed.";
+  }
+
+  TEST(ttl_cache, hits_do_not_extend_the_time_to_live) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 16, 10ms, clock};
+    for (int step = 0; step < 5; ++step) {
+      cache(2);
+      clock.advance(3ms);
+    }
+    EXPECT_EQ(calls, 2) << "Hits refreshed the expiry of an entry.";
+  }
+
+  TEST(ttl_cache, per_call_ttl_overrides_the_default) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 16, 10ms, clock};
+    cache.call_with_ttl(1s, 1);
+    cache(2);
+    clock.advance(500ms);
+    cache(1);
+    cache(2);
+    EXPECT_EQ(calls, 3) << "Only the entry with the default time-to-live should have expired.";
+  }
+
+  TEST(ttl_cache, zero_ttl_never_expires) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 16, 0ms, clock};
+    cache(4);
+    clock.advance(std::chrono::hours{24 * 365});
+    cache(4);
+    EXPECT_EQ(calls, 1) << "An entry without a time-to-live expired.";
+  }
+
+  TEST(ttl_cache, expired_entries_are_reclaimed_without_being_looked_up) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 0, 50ms, clock};
+    for (int value = 0; value < 100; ++value) {
+      cache(value);
+    }
+    EXPECT_EQ(cache.size(), 100u) << "Cache did not retain every value.";
+    clock.advance(60ms);
+    cache.evict_expired();
+    EXPECT_EQ(cache.size(), 0u) << "Expired entries lingered in the cache.";
+  }
+
+  TEST(ttl_cache, least_recently_used_entry_is_evicted_at_capacity) {
+    hh::helpers::manual_clock clock;
+    int calls = 0;
+    manual_ttl_cache cache{counted_square{&calls}, 2, 1s, clock};
+    cache(1);
+    cache(2);
+    cache(1);
+    cache(3);
+    EXPECT_EQ(cache.size(), 2u) << "Cache grew beyond its maximum size.";
+    cache(1);
+    EXPECT_EQ(calls, 3) << "The most recently used entry was evicted.";
+    cache(2);
+    EXPECT_EQ(calls, 4) << "The least recently used entry was not evicted.";
+    clock.advance(2s);
+    cache.evict_expired();
+    EXPECT_EQ(cache.size(), 0u) << "Evicted entries left timers behind.";
+  }
+
+  TEST(ttl_cache, make_ttl_cache_uses_the_steady_clock) {
+    auto cache = make_ttl_cache(square, 1min, 8);
+    EXPECT_EQ(cache(5), 25) << "Cached evaluation did not match the underlying function.";
+    EXPECT_EQ(cache.ttl(), 1min) << "Default time-to-live was not retained.";
+    EXPECT_EQ(cache.max_size(), 8u) << "Maximum size was not retained.";
+  }
+}  // namespace hh::functools
@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <hh/typetraits.hpp>
+#include <string>
+#include <type_traits>
+
+namespace hh {
+
+  namespace {
+    int add(int a, int b) { return a + b; }
+
+    struct widget {
+      std::string name(int) const { return {}; }
+      void rename(const std::string&) {}
+    };
+
+    struct functor {
+      double operator()(float) { return 0; }
+    };
+  }  // namespace
+
+  TEST(callable_signature, signatures_are_deduced_from_every_kind_of_callable) {
+    auto lambda = [](int value) noexcept { return value; };
+    static_assert(std::is_same_v<callable_signature_t<decltype(add)>, int(int, int)>,
+                  "Function signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<decltype(&add)>, int(int, int)>,
+                  "Function pointer signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<decltype(lambda)>, int(int)>,
+                  "Lambda signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<functor>, double(float)>,
+                  "Functor signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<std::function<long(char)>>, long(char)>,
+                  "std::function signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<decltype(&widget::name)>,
+                                 std::string(const widget*, int)>,
+                  "Const member function signature was not deduced.");
+    static_assert(std::is_same_v<callable_signature_t<decltype(&widget::rename)>,
+                                 void(widget*, const std::string&)>,
+                  "Member function signature was not deduced.");
+    SUCCEED() << "Signatures are checked at compile time.";
+  }
+}  // namespace hh
@@ -0,0 +1,101 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <hh/lru_cache.hpp>
+#include <hh/weigher.hpp>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace hh::functools {
+
+  namespace {
+    std::string repeat(char character, std::size_t count) { return std::string(count, character); }
+
+    std::vector<double> zeros(std::size_t count) { return std::vector<double>(count); }
+  }  // namespace
+
+  TEST(weigher, unit_weigher_counts_entries) {
+    EXPECT_EQ(unit_weigher{}(std::tuple<int>{1}, std::string(1000, 'x')), 1u)
+        << "Unit weigher did not give every entry a weight of one.";
+  }
+
+  TEST(weigher, default_weigher_counts_container_capacity) {
+    std::vector<double> value;
+    value.reserve(1000);
+    const auto weight = default_weigher{}(std::tuple<int>{1}, value);
+    EXPECT_GE(weight, sizeof(std::tuple<int>) + sizeof(value) + 1000 * sizeof(double))
+        << "Default weigher ignored the reserved capacity of a vector.";
+  }
+
+  TEST(weigher, default_weigher_follows_nested_containers_and_keys) {
+    const std::vector<std::string> value(4, std::string(256, 'x'));
+    const std::tuple<std::string> key{std::string(512, 'k')};
+    EXPECT_GE(default_weigher{}(key, value), 512u + 4 * 256u)
+        << "Default weigher ignored the heap storage of nested strings.";
+  }
+
+  TEST(weigher, default_weigher_follows_shared_values) {
+    const auto value = std::make_shared<const std::string>(1000, 'x');
+    EXPECT_GE(default_weigher{}(std::tuple<int>{1}, value), 1000u)
+        << "Default weigher ignored the value behind a shared pointer.";
+    EXPECT_EQ(default_weigher{}(std::tuple<int>{1}, std::shared_ptr<const std::string>{}),
+              sizeof(std::tuple<int>) + sizeof(value))
+        << "Default weigher counted the value of a null shared pointer.";
+  }
+
+  TEST(weighted_lru_cache, weight_tracks_the_retained_values) {
+    auto cache = make_weighted_lrucache(repeat, 1 << 20);
+    cache('a', 1000);
+    cache('b', 3000);
+    const default_weigher weigher;
+    EXPECT_EQ(cache.weight(), weigher(std::make_tuple('a', std::size_t{1000}), repeat('a', 1000))
+                                  + weigher(std::make_tuple('b', std::size_t{3000}),
+                                            repeat('b', 3000)))
+        << "Weight did not match the sum of the entries' weights.";
+  }
+
+  TEST(weighted_lru_cache, evicts_until_within_the_budget) {
+    auto cache = make_weighted_lrucache(zeros, 64 * 1024);
+    for (std::size_t i = 1; i <= 64; ++i) {
+      cache(i * 64);
+      EXPECT_LE(cache.weight(), cache.max_weight()) << "Cache exceeded its weight budget.";
+    }
+    // The last 4096 doubles alone weigh half the budget, so few entries can remain.
+    EXPECT_LT(cache.size(), 4u) << "Cache kept more entries than its budget allows.";
+    cache(1);
+    EXPECT_EQ(cache.size(), 3u) << "A light entry displaced more than it needed to.";
+  }
+
+  TEST(weighted_lru_cache, oversized_entries_are_kept_until_displaced) {
+    auto cache = make_weighted_lrucache(zeros, 1024);
+    EXPECT_EQ(cache(1000).size(), 1000u) << "Oversized entry was not returned.";
+    EXPECT_EQ(cache.size(), 1u) << "Oversized entry was not cached.";
+    cache(1);
+    EXPECT_EQ(cache.size(), 1u) << "Oversized entry was not displaced by the next insertion.";
+    EXPECT_LE(cache.weight(), cache.max_weight()) << "Cache exceeded its weight budget.";
+  }
+
+  TEST(weighted_lru_cache, custom_weighers_are_used) {
+    auto cache = make_weighted_lrucache(
+        repeat, 10, [](const auto& key, const std::string&) { return std::get<1>(key); });
+    cache('a', 4);
+    cache('b', 4);
+    cache('c', 4);
+    EXPECT_EQ(cache.weight(), 8u) << "Custom weigher was not used to measure entries.";
+    EXPECT_EQ(cache.size(), 2u) << "Custom weigher did not bound the cache.";
+  }
+
+  TEST(weighted_lru_cache, entry_and_weight_bounds_combine) {
+    basic_lru_cache<std::string(char, std::size_t), lru_eviction, default_weigher> cache{
+        repeat, 2, 1 << 20};
+    cache('a', 1);
+    cache('b', 1);
+    cache('c', 1);
+    EXPECT_EQ(cache.size(), 2u) << "Entry bound was ignored by a weighted cache.";
+    EXPECT_EQ(cache.weight(),
+              2 * default_weigher{}(std::make_tuple('a', std::size_t{1}), repeat('a', 1)))
+        << "Weight of entries evicted by the entry bound was not released.";
+  }
+}  // namespace hh::functools